@@ -3,6 +3,8 @@
 #include <Arduino.h>
 
 uint32_t apiServerGetSelectedGameId();
+// Selects the game to follow (0 clears it) and persists the choice
+void apiServerSelectGame(uint32_t gameId);
 void apiServerInit();
 void apiServerLoop();
 
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ArduinoJson.h>
+
+// Bump allocator for ArduinoJson documents that are rebuilt on every poll.
+// The backing block is allocated once; reset() rewinds it between polls so
+// steady-state parsing never touches the heap. Requests that do not fit
+// fall back to malloc and are counted so they can be spotted in the logs.
+class ArenaAllocator : public ArduinoJson::Allocator {
+public:
+    ArenaAllocator()
+        : base_(nullptr), capacity_(0), top_(0), last_(nullptr), peak_(0), fallbacks_(0) {}
+
+    void attach(uint8_t* buffer, size_t capacity) {
+        base_ = buffer;
+        capacity_ = buffer ? capacity : 0;
+        reset();
+    }
+
+    // Only call once every document using the arena has been cleared.
+    void reset() {
+        top_ = 0;
+        last_ = nullptr;
+    }
+
+    void* allocate(size_t size) override {
+        void* p = bump(size);
+        if (p) return p;
+        fallbacks_++;
+        return malloc(size);
+    }
+
+    void deallocate(void* ptr) override {
+        if (!ptr) return;
+        if (!owns(ptr)) {
+            free(ptr);
+            return;
+        }
+        if (ptr == last_) {
+            top_ = (size_t)((uint8_t*)ptr - base_) - kHeader;
+            last_ = nullptr;
+        }
+    }
+
+    void* reallocate(void* ptr, size_t newSize) override {
+        if (!ptr) return allocate(newSize);
+        if (!owns(ptr)) return realloc(ptr, newSize);
+
+        const size_t oldSize = blockSize(ptr);
+        if (ptr == last_) {
+            const size_t start = (size_t)((uint8_t*)ptr - base_);
+            const size_t end = start + align(newSize);
+            if (end <= capacity_) {
+                setBlockSize(ptr, newSize);
+                top_ = end;
+                if (top_ > peak_) peak_ = top_;
+                return ptr;
+            }
+        } else if (newSize <= oldSize) {
+            setBlockSize(ptr, newSize);
+            return ptr;
+        }
+
+        void* moved = allocate(newSize);
+        if (!moved) return nullptr;
+        memcpy(moved, ptr, oldSize < newSize ? oldSize : newSize);
+        deallocate(ptr);
+        return moved;
+    }
+
+    size_t used() const { return top_; }
+    size_t peak() const { return peak_; }
+    size_t capacity() const { return capacity_; }
+    uint32_t fallbacks() const { return fallbacks_; }
+
+private:
+    static constexpr size_t kAlign = 8;
+    static constexpr size_t kHeader = kAlign;
+
+    static size_t align(size_t n) {
+        return (n + kAlign - 1) & ~(kAlign - 1);
+    }
+
+    bool owns(void* ptr) const {
+        const uint8_t* p = (const uint8_t*)ptr;
+        return base_ && p >= base_ && p < base_ + capacity_;
+    }
+
+    size_t blockSize(void* ptr) const {
+        size_t size;
+        memcpy(&size, (uint8_t*)ptr - kHeader, sizeof(size));
+        return size;
+    }
+
+    void setBlockSize(void* ptr, size_t size) {
+        memcpy((uint8_t*)ptr - kHeader, &size, sizeof(size));
+    }
+
+    void* bump(size_t size) {
+        if (!base_) return nullptr;
+        const size_t need = kHeader + align(size);
+        if (need > capacity_ - top_) return nullptr;
+        uint8_t* p = base_ + top_ + kHeader;
+        setBlockSize(p, size);
+        top_ += need;
+        if (top_ > peak_) peak_ = top_;
+        last_ = p;
+        return p;
+    }
+
+    uint8_t* base_;
+    size_t capacity_;
+    size_t top_;
+    void* last_;
+    size_t peak_;
+    uint32_t fallbacks_;
+};
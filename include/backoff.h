@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdint.h>
+
+// Jittered exponential backoff shared by the upstream pollers, the
+// circuit breaker and the WiFi supervisor. Randomness comes in as an
+// argument so the native tests can replay it.
+
+// Equal jitter: half of the window is fixed, the other half taken from
+// `random`.
+uint32_t backoffJitterMs(uint32_t windowMs, uint32_t random);
+// Exponential backoff with jitter for the given attempt index.
+uint32_t backoffDelayMs(uint32_t baseMs, int attempt, uint32_t random);
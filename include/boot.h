@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Boot orchestration. setup() brings the panel up first; networking and
+// the services start in background tasks with explicit dependencies:
+//
+//   FsMounted -> DisplayReady -> SnapshotRestored -> FirstFrame
+//   WifiConnected -> TimeSynced
+//   WifiConnected -> MdnsReady -> ServicesStarted -> FirstLiveData
+//
+// Each phase is timestamped (ms since reset) the first time it is marked.
+enum class BootPhase : uint8_t {
+    FsMounted,
+    DisplayReady,
+    SnapshotRestored,   // only marked when a warm-start record was loaded
+    FirstFrame,
+    WifiConnected,
+    TimeSynced,
+    MdnsReady,
+    ServicesStarted,
+    FirstLiveData,
+    Count
+};
+
+void bootStart();
+void bootMark(BootPhase phase);
+bool bootIsDone(BootPhase phase);
+// Blocks until the phase is reached or the timeout expires.
+bool bootWaitFor(BootPhase phase, uint32_t timeoutMs);
+// 0 until the phase has been reached
+uint32_t bootPhaseMs(BootPhase phase);
+const char* bootPhaseName(BootPhase phase);
+// Short label for the splash screen while booting, e.g. "WIFI"
+const char* bootStatusText();
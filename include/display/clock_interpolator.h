@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Counts a game clock down locally between polls. Each poll provides an
+// authoritative sample; small disagreements are absorbed by running the
+// local clock up to 25% faster or slower, large ones snap.
+class ClockInterpolator {
+public:
+    void reset();
+    void sync(uint16_t tenths, bool running, uint32_t observedMs, uint32_t nowMs);
+    uint16_t displayTenths(uint32_t nowMs);
+    bool isSynced() const { return synced; }
+    int32_t lastCorrectionMs() const { return lastErrorMs; }
+
+private:
+    int32_t targetMs(uint32_t nowMs) const;
+
+    bool synced = false;
+    bool running = false;
+    uint16_t sampleTenths = 0;
+    uint32_t sampleMs = 0;
+    int32_t displayMs = 0;
+    uint32_t lastTickMs = 0;
+    int32_t lastErrorMs = 0;
+};
+
+// Parses the API's "MM:SS" into tenths of a second; 0 when malformed.
+uint16_t parseClockTenths(const char* mmss);
+
+// Formats tenths of a second as "MM:SS", matching the API's timeRemaining.
+// Partial seconds round up.
+void formatClockTenths(uint16_t tenths, char* out, size_t outSize);
+
+// Time left on a countdown that read tenthsAtSample when the game clock
+// read clockAtSample, now that the clock reads clockNow. Penalties and the
+// power play run off with the game clock, so they stop on its whistles.
+uint16_t countdownTenths(uint16_t tenthsAtSample, uint16_t clockAtSample, uint16_t clockNow);
@@ -3,53 +3,7 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 
-struct TeamInfo {
-    uint32_t id;
-    char abbrev[4];
-    char name[32];
-    uint16_t score;
-    uint16_t sog;
-};
-
-constexpr size_t kMaxRecapGoals = 24;
-
-struct RecapGoal {
-    uint32_t eventId;
-    char teamAbbrev[4];
-    char scorer[24];
-    char assist1[24];
-    char assist2[24];
-    char timeRemaining[8];
-    uint8_t period;
-};
-
-constexpr size_t kRecapTextMax = 768;
-
-struct GameSnapshot {
-    uint32_t gameId;
-    char gameState[8];
-    char startTimeUtc[24];
-    char utcOffset[8];
-    TeamInfo away;
-    TeamInfo home;
-    uint8_t period;
-    char timeRemaining[8];
-    bool inIntermission;
-    bool goalIsNew;
-    uint32_t goalEventId;
-    uint32_t goalOwnerTeamId;
-    char goalScorer[32];
-    char goalTime[8];
-    uint8_t goalPeriod;
-    char goalAssist1[32];
-    char goalAssist2[32];
-    bool awayPP;
-    bool homePP;
-    bool recapReady;
-    char recapText[kRecapTextMax];
-    uint8_t recapGoalCount;
-    RecapGoal recapGoals[kMaxRecapGoals];
-};
+#include "display/game_types.h"
 
 void dataModelInit();
 void dataModelSetSelectedGame(uint32_t gameId);
@@ -61,6 +15,8 @@ void dataModelUpdateFromPbp(uint32_t gameId,
     uint8_t period,
     const char* timeRemaining,
     bool inIntermission,
+    bool clockRunning,
+    uint32_t clockSampleMs,
     uint32_t awayId,
     const char* awayAbbrev,
     const char* awayName,
@@ -85,6 +41,24 @@ void dataModelUpdateFromPbp(uint32_t gameId,
     const char* recapText,
     uint8_t recapGoalCount,
     const RecapGoal* recapGoals);
+void dataModelUpdatePenalties(uint32_t gameId,
+    uint16_t ppTenths,
+    const PenaltyEntry* penalties,
+    uint8_t penaltyCount);
+// Late scorer/assist changes for an already announced goal
+void dataModelUpdateGoalDetails(uint32_t gameId,
+    uint32_t goalEventId,
+    const char* goalScorer,
+    const char* goalAssist1,
+    const char* goalAssist2);
+void dataModelUpdateStats(uint32_t gameId, const GameStats& stats);
+// Seeds the model from a persisted snapshot (see snapshot_store). Only the
+// identity, teams, score and clock fields of `saved` are used.
+void dataModelRestore(const GameSnapshot& saved);
+// Incremented when an update changes the model; a poll that repeats the
+// previous data (clock sample time aside) leaves it alone. Cheap to poll
+// for "has anything changed".
+uint32_t dataModelGetVersion();
 bool dataModelGetSnapshot(GameSnapshot& out);
 void dataModelClearGoalFlag();
 
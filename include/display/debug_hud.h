@@ -0,0 +1,45 @@
+#pragma once
+
+#include "display/scene.h"
+
+// Board health page in the mini font: fps and last frame build time, free
+// heap, age of the last good fetch and the failure count, WiFi RSSI and
+// the measured poll interval. Inputs are sampled twice a second and the
+// text is only re-formatted when a value changes; other frames just draw
+// the cached lines.
+class DebugHud : public Scene {
+public:
+    void render(MatrixPanel_I2S_DMA& display, const GameSnapshot& data, uint32_t nowMs) override;
+
+    // Called for every frame while the HUD is enabled, shown or not
+    void noteFrame(uint32_t frameUs, uint32_t nowMs);
+    void reset();
+
+    static constexpr int kLines = 5;
+    static constexpr int kLineChars = 16;
+
+private:
+    struct Values {
+        uint16_t fps;
+        uint16_t frameTenthsMs;
+        uint16_t heapKb;
+        uint32_t okAgeS;  // UINT32_MAX before the first good fetch
+        uint32_t failures;
+        int16_t rssi;     // 0 while the link is down
+        uint32_t pollS;
+
+        bool operator==(const Values& other) const;
+    };
+
+    void sample(uint32_t nowMs);
+    void format();
+
+    Values values = {};
+    Values shown = {};
+    bool formatted = false;
+    char lines[kLines][kLineChars + 1] = {};
+    uint32_t lastSampleMs = 0;
+    uint32_t windowStartMs = 0;
+    uint16_t windowFrames = 0;
+    uint32_t lastFrameUs = 0;
+};
@@ -4,7 +4,14 @@
 
 void displayInit();
 void displayTick();
-void displaySetEnabled(bool enabled);
+// Turning the display off blanks the panel; with releasePanel the HUB75
+// driver is deleted too, which stops the DMA refresh and frees its buffers.
+void displaySetEnabled(bool enabled, bool releasePanel = false);
 bool displayIsEnabled();
+// Rotating board-health page (see debug_hud.h), off by default
+void displaySetDebugHud(bool enabled);
+bool displayDebugHudEnabled();
+// DMA-capable heap taken by the panel driver (0 while it is released)
+size_t displayDmaBytes();
 bool displayTriggerGoalPreview();
 
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The game snapshot and the per-game aggregates shared by the
+// play-by-play reducer, the data model, the scenes and the snapshot store.
+// Plain data only, so host tests can include it.
+
+constexpr size_t kMaxRecapGoals = 24;
+
+struct RecapGoal {
+    uint32_t eventId;
+    char teamAbbrev[4];
+    char scorer[24];
+    char assist1[24];
+    char assist2[24];
+    char timeRemaining[8];
+    uint8_t period;
+};
+
+constexpr size_t kRecapTextMax = 768;
+constexpr size_t kStatPeriods = 4;  // 1st-3rd, then all overtime
+constexpr size_t kMaxLeaders = 3;
+
+struct TeamGameStats {
+    uint8_t shots[kStatPeriods];
+    uint8_t goals[kStatPeriods];
+    uint16_t pim;
+    uint16_t hits;
+    uint16_t faceoffWins;
+};
+
+struct StatLeader {
+    uint32_t teamId;
+    char name[16];
+    uint8_t goals;
+    uint8_t assists;
+};
+
+// Aggregates maintained incrementally by the play-by-play reducer
+struct GameStats {
+    TeamGameStats away;
+    TeamGameStats home;
+    uint8_t leaderCount;
+    StatLeader leaders[kMaxLeaders];
+};
+constexpr size_t kMaxPenalties = 6;
+
+// A penalty still being served. remainingTenths is measured against the
+// clock sample stored with it, so scenes can count it down locally.
+struct PenaltyEntry {
+    uint32_t eventId;
+    uint32_t teamId;
+    char player[16];
+    char infraction[20];
+    uint8_t durationMin;
+    uint16_t remainingTenths;
+};
+
+struct TeamInfo {
+    uint32_t id;
+    char abbrev[4];
+    char name[32];
+    uint16_t score;
+    uint16_t sog;
+};
+
+struct GameSnapshot {
+    uint32_t gameId;
+    char gameState[8];
+    char startTimeUtc[24];
+    char utcOffset[8];
+    int64_t startEpoch;         // UTC seconds, 0 when unknown
+    int64_t startDayEndEpoch;   // end of the local start day
+    char startLabel[8];         // local start time, "19H" / "19H30"
+    char startDateLabel[6];     // local start date, "DD-MM"
+    TeamInfo away;
+    TeamInfo home;
+    uint8_t period;
+    char timeRemaining[8];
+    bool inIntermission;
+    uint16_t clockTenths;   // timeRemaining parsed at ingest
+    bool clockRunning;
+    uint32_t clockFetchMs;  // millis() when the response that last changed the clock arrived
+    bool goalIsNew;
+    uint32_t goalEventId;
+    uint32_t goalOwnerTeamId;
+    char goalScorer[32];
+    char goalTime[8];
+    uint8_t goalPeriod;
+    char goalAssist1[32];
+    char goalAssist2[32];
+    bool awayPP;
+    bool homePP;
+    uint16_t ppTenths;      // situation timeRemaining, same sample as the clock
+    uint8_t penaltyCount;
+    PenaltyEntry penalties[kMaxPenalties];
+    bool recapReady;
+    char recapText[kRecapTextMax];
+    uint8_t recapGoalCount;
+    RecapGoal recapGoals[kMaxRecapGoals];
+    GameStats stats;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "display/scene.h"
+#include "display/shot_heatmap.h"
+
+// Shot-location heatmap over a rink outline, away shots on the left and
+// home shots on the right, tinted with each team's logo color. The frame
+// is composed into a cached bitmap that is only rebuilt when the grid or
+// the teams change; other frames are a single bitmap blit.
+class HeatmapScene : public Scene {
+public:
+    void render(MatrixPanel_I2S_DMA& display, const GameSnapshot& data, uint32_t nowMs) override;
+
+    static bool hasContent(const GameSnapshot& data);
+
+    static constexpr int kWidth = 64;
+    static constexpr int kHeight = 32;
+
+private:
+    void rebuild(MatrixPanel_I2S_DMA& display, const GameSnapshot& data, uint32_t nowMs);
+
+    uint16_t bitmap[kWidth * kHeight] = {};
+    ShotHeatmapGrid grid = {};
+    uint32_t builtVersion = 0;
+    uint32_t builtGameId = 0;
+    bool built = false;
+    bool logoColors = false;
+    uint32_t lastColorAttemptMs = 0;
+    uint16_t awayColor = 0;
+    uint16_t homeColor = 0;
+};
+
+// Static memory: the 4 KB bitmap plus the 1 KB grid copy
+static_assert(sizeof(uint16_t) * HeatmapScene::kWidth * HeatmapScene::kHeight == 4096,
+    "heatmap bitmap is budgeted at 4 KB");
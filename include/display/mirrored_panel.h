@@ -0,0 +1,66 @@
+#pragma once
+
+#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include <string.h>
+
+#include "display/panel_mirror.h"
+
+// HUB75 panel that also keeps an RGB565 copy of the frame being drawn,
+// for the panel mirror. Every scene redraws the whole frame into the back
+// buffer, so the copy is cleared at the start of each frame rather than
+// by intercepting clearScreen(), which the library does not make virtual.
+class MirroredPanel : public MatrixPanel_I2S_DMA {
+public:
+    static constexpr int kWidth = 64;
+    static constexpr int kHeight = 32;
+
+    explicit MirroredPanel(const HUB75_I2S_CFG& config) : MatrixPanel_I2S_DMA(config) {}
+
+#if PANEL_MIRROR
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        MatrixPanel_I2S_DMA::drawPixel(x, y, color);
+        if (x >= 0 && x < kWidth && y >= 0 && y < kHeight) shadow[y * kWidth + x] = color;
+    }
+
+    void fillScreen(uint16_t color) override {
+        MatrixPanel_I2S_DMA::fillScreen(color);
+        shadowFill(0, 0, kWidth, kHeight, color);
+    }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+        MatrixPanel_I2S_DMA::fillRect(x, y, w, h, color);
+        shadowFill(x, y, w, h, color);
+    }
+
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+        MatrixPanel_I2S_DMA::drawFastHLine(x, y, w, color);
+        shadowFill(x, y, w, 1, color);
+    }
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+        MatrixPanel_I2S_DMA::drawFastVLine(x, y, h, color);
+        shadowFill(x, y, 1, h, color);
+    }
+
+    void beginFrame() { memset(shadow, 0, sizeof(shadow)); }
+    void endFrame() { panelMirrorPublish(shadow); }
+
+private:
+    void shadowFill(int x, int y, int w, int h, uint16_t color) {
+        int x1 = x + w;
+        int y1 = y + h;
+        if (x < 0) x = 0;
+        if (y < 0) y = 0;
+        if (x1 > kWidth) x1 = kWidth;
+        if (y1 > kHeight) y1 = kHeight;
+        for (int row = y; row < y1; ++row) {
+            for (int col = x; col < x1; ++col) shadow[row * kWidth + col] = color;
+        }
+    }
+
+    uint16_t shadow[kWidth * kHeight] = {};
+#else
+    void beginFrame() {}
+    void endFrame() {}
+#endif
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "display/panel_mirror_codec.h"
+
+// Live copy of the panel for browsers, over a WebSocket on port 81.
+// Build with -DPANEL_MIRROR=0 to drop the shadow framebuffer and server.
+#ifndef PANEL_MIRROR
+#define PANEL_MIRROR 1
+#endif
+
+#ifndef PANEL_MIRROR_FPS
+#define PANEL_MIRROR_FPS 10
+#endif
+
+constexpr uint16_t kPanelMirrorPort = 81;
+constexpr uint8_t kPanelMirrorMaxFps = 30;
+
+struct PanelMirrorStats {
+    uint8_t clients;
+    uint8_t maxFps;
+    uint32_t framesSent;
+    uint32_t keyframes;
+    uint32_t bytesSent;
+    uint32_t dropped;       // frames skipped because the sender was busy
+    uint32_t sendFailures;  // the client gets a keyframe next
+};
+
+void panelMirrorStart();
+// Offers the finished frame. Returns at once unless the sender is waiting
+// for a frame; never blocks the render loop.
+void panelMirrorPublish(const uint16_t* pixels);
+void panelMirrorSetMaxFps(uint8_t fps);
+void panelMirrorGetStats(PanelMirrorStats& out);
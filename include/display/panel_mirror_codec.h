@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Wire format of the panel mirror. No Arduino dependencies, so the
+// native test env builds it.
+
+// Frame message: [kind 0=delta 1=key][width][height][row count], then per
+// row [row index] followed by RLE runs [count][RGB565 lo][hi] covering the
+// row. A delta carries only rows that differ from prev; with prev null
+// every row is sent. Returns the message size, 0 if out is too small.
+size_t panelMirrorEncode(const uint16_t* prev, const uint16_t* cur, int width, int height,
+    uint8_t* out, size_t outSize);
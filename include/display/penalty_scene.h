@@ -0,0 +1,23 @@
+#pragma once
+
+#include "display/clock_interpolator.h"
+#include "display/scene.h"
+
+// Power-play view: PP time left and the players in the box. All
+// countdowns follow the locally interpolated game clock, so they stop on
+// whistles and stay smooth between polls.
+class PenaltyScene : public Scene {
+public:
+    void render(MatrixPanel_I2S_DMA& display, const GameSnapshot& data, uint32_t nowMs) override;
+
+    static bool hasContent(const GameSnapshot& data);
+
+private:
+    void syncClock(const GameSnapshot& data, uint32_t nowMs);
+
+    ClockInterpolator clock;
+    uint32_t clockGameId = 0;
+    uint8_t clockPeriod = 0;
+    uint32_t clockSampleMs = 0;
+    uint16_t sampleTenths = 0;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "display/clock_interpolator.h"
 #include "display/scene.h"
 
 class ScoreboardScene : public Scene {
@@ -7,7 +8,13 @@ public:
     void render(MatrixPanel_I2S_DMA& display, const GameSnapshot& data, uint32_t nowMs) override;
 
 private:
+    void syncClock(const GameSnapshot& data, uint32_t nowMs);
+
     unsigned long lastToggleMs = 0;
     bool showSOG = false;
+    ClockInterpolator clock;
+    uint32_t clockGameId = 0;
+    uint8_t clockPeriod = 0;
+    uint32_t clockSampleMs = 0;
 };
 
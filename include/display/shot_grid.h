@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Shot locations for the selected game, binned on a 32x16 grid of
+// saturating byte weights over the 200x85 ft rink. Coordinates are
+// normalised so the away team always attacks the left goal and the home
+// team the right one. No Arduino dependencies, so the native test env
+// builds it; shot_heatmap wraps one instance with a mutex.
+constexpr uint8_t kHeatCols = 32;
+constexpr uint8_t kHeatRows = 16;
+
+struct ShotHeatmapGrid {
+    // Saturating weights: a shot on goal adds 1, a goal adds 3
+    uint8_t away[kHeatRows][kHeatCols];
+    uint8_t home[kHeatRows][kHeatCols];
+    uint8_t peak;
+    uint16_t shots;
+};
+
+// 1 KB of cells per copy: one here, one in HeatmapScene
+static_assert(sizeof(ShotHeatmapGrid) <= 1024 + 4, "heatmap grid outgrew its 1 KB budget");
+
+class ShotGrid {
+public:
+    // xCoord/yCoord as reported by the API (feet from center ice).
+    // homeDefendsRight comes from the play's homeTeamDefendingSide.
+    // Returns true when a cell changed; a saturated cell does not.
+    bool add(bool homeTeam, int x, int y, bool homeDefendsRight, bool goal);
+    // Returns false when the grid was already empty
+    bool reset();
+
+    // Moves only when a cell changes, so renderers can skip rebuilding
+    uint32_t version() const { return version_; }
+    const ShotHeatmapGrid& grid() const { return grid_; }
+
+    static int column(int x, bool homeDefendsRight);
+    static int row(int y, bool homeDefendsRight);
+
+private:
+    ShotHeatmapGrid grid_ = {};
+    uint32_t version_ = 0;
+};
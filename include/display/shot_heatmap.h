@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "display/shot_grid.h"
+
+// The selected game's shot grid (see shot_grid), shared between the PBP
+// reducer and HeatmapScene under a mutex.
+
+void shotHeatmapInit();
+void shotHeatmapReset();
+
+// xCoord/yCoord as reported by the API (feet from center ice).
+// homeDefendsRight comes from the play's homeTeamDefendingSide.
+void shotHeatmapAdd(bool homeTeam, int x, int y, bool homeDefendsRight, bool goal);
+
+// Moves only when a cell changes; lets renderers skip rebuilding their bitmap.
+uint32_t shotHeatmapVersion();
+uint32_t shotHeatmapCopy(ShotHeatmapGrid& out);
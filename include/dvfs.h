@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "dvfs_policy.h"
+
+// CPU clock and WiFi modem-sleep governor. Callers describe what they are
+// doing (network burst, animation, standby) and the policy picks the clock
+// and power-save mode: 240 MHz with modem sleep off while fetching or
+// animating, 80 MHz with light modem sleep on static screens. Upshifts
+// apply at once, downshifts after a short hold so back-to-back polls do
+// not flap the clock.
+
+struct DvfsStats {
+    uint16_t cpuMhz;
+    DvfsPs ps;
+    uint32_t transitions;
+    uint32_t residencyMs[kDvfsLevels];   // per kDvfsLevelMhz entry
+    uint32_t estMwhPerHour;              // at the observed residency
+    uint32_t baselineMwhPerHour;         // fixed 240 MHz, modem sleep off
+};
+
+void dvfsInit();
+void dvfsBeginNetwork();
+void dvfsEndNetwork();
+void dvfsSetAnimating(bool animating);
+void dvfsSetStandby(bool standby);
+// Applies pending downshifts; called from the loop task.
+void dvfsTick();
+void dvfsGetStats(DvfsStats& out);
+
+// Holds the network level for the lifetime of a fetch.
+class DvfsNetworkBoost {
+public:
+    DvfsNetworkBoost() { dvfsBeginNetwork(); }
+    ~DvfsNetworkBoost() { dvfsEndNetwork(); }
+    DvfsNetworkBoost(const DvfsNetworkBoost&) = delete;
+    DvfsNetworkBoost& operator=(const DvfsNetworkBoost&) = delete;
+};
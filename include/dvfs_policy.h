@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The dvfs governor's pure half: inputs, targets and the policy that maps
+// one to the other. No Arduino dependencies, so the native test env
+// builds it.
+
+enum class DvfsPs : uint8_t {
+    None,       // modem always on: fetch bursts
+    MinModem,   // wakes every DTIM: idle between polls
+    MaxModem    // longest listen interval: standby
+};
+
+struct DvfsInputs {
+    uint8_t networkHolds;
+    bool animating;
+    bool standby;
+};
+
+struct DvfsTarget {
+    uint16_t cpuMhz;
+    DvfsPs ps;
+};
+
+constexpr size_t kDvfsLevels = 3;
+constexpr uint16_t kDvfsBusyMhz = 240;
+constexpr uint16_t kDvfsIdleMhz = 80;
+
+extern const uint16_t kDvfsLevelMhz[kDvfsLevels];
+
+// Pure policy; no side effects.
+DvfsTarget dvfsPolicy(const DvfsInputs& in);
+// True when `to` needs more clock or a more awake modem than `from` in
+// either respect; such changes apply at once, the rest wait for the hold.
+bool dvfsIsRaise(const DvfsTarget& from, const DvfsTarget& to);
+const char* dvfsPsName(DvfsPs ps);
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Goals the play-by-play poller announced recently. Assists are often
+// filled in after the first poll that shows a goal, so each goal is
+// watched by eventId for late scorer/assist changes, and a short burst of
+// faster polls follows it. No Arduino dependencies, so the native test
+// env builds it.
+
+constexpr size_t kGoalWatchMax = 4;
+constexpr uint8_t kGoalFollowUpPolls = 6;           // covers the 17 s animation
+constexpr uint32_t kGoalFollowUpIntervalMs = 2000;
+constexpr uint32_t kGoalWatchMs = 300000;
+
+struct WatchedGoal {
+    uint32_t eventId;       // 0: free slot
+    uint32_t announcedMs;
+    char scorer[32];
+    char assist1[32];
+    char assist2[32];
+};
+
+struct GoalWatch {
+    WatchedGoal goals[kGoalWatchMax];
+    uint8_t followUpPolls;  // left in the current burst
+};
+
+void goalWatchClear(GoalWatch& watch);
+// Starts (or restarts) watching a goal and arms the follow-up burst. With
+// the table full, the oldest goal makes room.
+void goalWatchAdd(GoalWatch& watch, uint32_t eventId, const char* scorer,
+    const char* assist1, const char* assist2, uint32_t nowMs);
+// Drops goals watched for longer than kGoalWatchMs; returns how many are left
+size_t goalWatchExpire(GoalWatch& watch, uint32_t nowMs);
+// The watched goal with this eventId, or null
+WatchedGoal* goalWatchFind(GoalWatch& watch, uint32_t eventId);
+// Stores the names; true when any of them changed
+bool goalWatchSetNames(WatchedGoal& goal, const char* scorer, const char* assist1, const char* assist2);
+// Delay before the next poll: kGoalFollowUpIntervalMs while a burst runs
+// (consuming one of its polls), baseMs otherwise
+uint32_t goalWatchNextPollDelayMs(GoalWatch& watch, uint32_t baseMs);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "heap_tag_table.h"
+
+// Opt-in heap attribution. Built with -DHEAP_TRACE=1 and the linker
+// wrapping malloc/calloc/realloc/free (see the heaptrace env in
+// platformio.ini), every allocation made inside a HeapTagScope is charged
+// to that scope's subsystem until it is freed, wherever the free happens.
+// Without HEAP_TRACE the scopes compile to nothing. The table and
+// counters are in heap_tag_table.
+
+#ifndef HEAP_TRACE
+#define HEAP_TRACE 0
+#endif
+
+#if HEAP_TRACE
+HeapTag heapTagPush(HeapTag tag);
+void heapTagPop(HeapTag previous);
+#else
+inline HeapTag heapTagPush(HeapTag) { return HeapTag::None; }
+inline void heapTagPop(HeapTag) {}
+#endif
+
+// Charges allocations made by the current task to a subsystem. Nests;
+// the innermost scope wins.
+class HeapTagScope {
+public:
+    explicit HeapTagScope(HeapTag tag) : previous_(heapTagPush(tag)) {}
+    ~HeapTagScope() { heapTagPop(previous_); }
+    HeapTagScope(const HeapTagScope&) = delete;
+    HeapTagScope& operator=(const HeapTagScope&) = delete;
+
+private:
+    HeapTag previous_;
+};
+
+void heapTagGetStats(HeapTagStats& out);
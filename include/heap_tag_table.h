@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bookkeeping behind heap_tag: the pointer table that remembers which
+// subsystem each live block was charged to, the per-tag counters and the
+// size histogram. Not locked and never allocates; heap_tag calls it from
+// the malloc wrappers inside a critical section. No Arduino dependencies,
+// so the native test env builds it.
+
+enum class HeapTag : uint8_t {
+    None,
+    Pbp,
+    Schedule,
+    Api,
+    Display,
+    Logos
+};
+
+constexpr size_t kHeapTagCount = 6;
+// Power-of-two size classes from 16 bytes; the last one is open-ended
+constexpr size_t kHeapSizeBuckets = 11;
+// Tagged blocks beyond this many live at once are counted as untracked
+constexpr size_t kHeapTableBits = 11;
+constexpr size_t kHeapTableLimit = (1u << kHeapTableBits) * 3 / 4;
+
+struct HeapTagCounters {
+    uint32_t liveBytes;
+    uint32_t peakBytes;
+    uint32_t liveCount;
+    uint32_t allocs;
+};
+
+struct HeapTagStats {
+    bool enabled;
+    HeapTagCounters tags[kHeapTagCount];
+    uint32_t sizeHist[kHeapSizeBuckets];
+    uint32_t tracked;    // live tagged blocks in the pointer table
+    uint32_t untracked;  // tagged allocations dropped because the table was full
+};
+
+// No constructor: a static instance is zeroed before the first malloc can
+// reach it. Other instances need clear() first.
+class HeapTagTable {
+public:
+    void clear();
+    // Every allocation lands in the size histogram; only tagged ones are
+    // charged and remembered.
+    void recordAlloc(void* ptr, size_t size, HeapTag tag);
+    // Credits the tag the block was charged to. Unknown pointers are ignored.
+    void recordFree(void* ptr);
+    // realloc's outcome: newPtr is null on failure, when the old block
+    // stays live and keeps its charge.
+    void recordRealloc(void* oldPtr, void* newPtr, size_t size, HeapTag tag);
+    // Fills everything but enabled
+    void getStats(HeapTagStats& out) const;
+
+private:
+    static constexpr size_t kSize = 1u << kHeapTableBits;
+    static constexpr size_t kMask = kSize - 1;
+
+    struct Block {
+        void* ptr;
+        uint32_t sizeTag;  // size in the low 24 bits, tag in the top 8
+    };
+
+    void removeAt(size_t hole);
+
+    Block table_[kSize];
+    size_t count_;
+    HeapTagCounters counters_[kHeapTagCount];
+    uint32_t sizeHist_[kHeapSizeBuckets];
+    uint32_t untracked_;
+};
+
+// Upper bound of a size class in bytes; 0 for the open-ended last one.
+uint32_t heapSizeBucketLimit(size_t index);
+const char* heapTagName(HeapTag tag);
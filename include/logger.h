@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Non-blocking logger. LOGx() formats into a fixed-slot in-RAM ring and
+// returns; a low-priority task drains the ring to Serial, so a poll task
+// never waits on the UART. The ring also keeps the recent history for
+// GET /api/log.
+//
+// Levels above LOG_LEVEL compile to nothing: the arguments are still
+// type-checked but never evaluated.
+// Override per build with -DLOG_LEVEL=LOG_LEVEL_DEBUG.
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+constexpr size_t kLogSlots = 64;
+constexpr size_t kLogTextMax = 116;
+
+struct LogEntry {
+    uint32_t seq;
+    uint32_t ms;
+    uint8_t level;
+    char text[kLogTextMax];
+};
+
+struct LogStats {
+    uint32_t written;
+    uint32_t dropped;        // overwritten before the drain task got to them
+    uint32_t truncated;
+    uint32_t writeUsTotal;   // time spent in logWrite() by callers
+    uint32_t serialUsTotal;  // time the drain task spent in Serial writes
+};
+
+void logWrite(uint8_t level, const char* tag, const char* fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+// Starts the drain task. Entries logged before this are kept and flushed.
+void logStart();
+// Copies up to maxEntries of the most recent entries, oldest first.
+size_t logSnapshot(LogEntry* out, size_t maxEntries);
+void logGetStats(LogStats& out);
+const char* logLevelName(uint8_t level);
+
+#define LOG_DISCARD(tag, fmt, ...) \
+    do { if (0) logWrite(LOG_LEVEL_NONE, tag, fmt, ##__VA_ARGS__); } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOGE(tag, fmt, ...) logWrite(LOG_LEVEL_ERROR, tag, fmt, ##__VA_ARGS__)
+#else
+#define LOGE(tag, fmt, ...) LOG_DISCARD(tag, fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOGW(tag, fmt, ...) logWrite(LOG_LEVEL_WARN, tag, fmt, ##__VA_ARGS__)
+#else
+#define LOGW(tag, fmt, ...) LOG_DISCARD(tag, fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOGI(tag, fmt, ...) logWrite(LOG_LEVEL_INFO, tag, fmt, ##__VA_ARGS__)
+#else
+#define LOGI(tag, fmt, ...) LOG_DISCARD(tag, fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOGD(tag, fmt, ...) logWrite(LOG_LEVEL_DEBUG, tag, fmt, ##__VA_ARGS__)
+#else
+#define LOGD(tag, fmt, ...) LOG_DISCARD(tag, fmt, ##__VA_ARGS__)
+#endif
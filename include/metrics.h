@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+// Process-wide metrics. Each metric is a file-scope object in the module
+// that updates it; its constructor links it into a registry that
+// metricsRender() walks to produce the Prometheus text format. Updates
+// are single atomic operations, safe from any task.
+
+class Metric {
+public:
+    Metric(const char* name, const char* help);
+    virtual ~Metric() = default;
+    virtual void render(String& out) const = 0;
+
+    const char* name() const { return name_; }
+    const char* help() const { return help_; }
+    Metric* next() const { return next_; }
+
+protected:
+    void renderHeader(String& out, const char* type) const;
+
+private:
+    const char* name_;
+    const char* help_;
+    Metric* next_;
+};
+
+class MetricCounter : public Metric {
+public:
+    MetricCounter(const char* name, const char* help) : Metric(name, help), value_(0) {}
+    void inc(uint32_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+    void render(String& out) const override;
+
+private:
+    std::atomic<uint64_t> value_;
+};
+
+// Counter split by one integer label, e.g. HTTP status code. The first
+// kSlots distinct values get their own series; later ones go to "other".
+class MetricLabeledCounter : public Metric {
+public:
+    static constexpr size_t kSlots = 8;
+
+    MetricLabeledCounter(const char* name, const char* help, const char* label);
+    void inc(int32_t labelValue);
+    void render(String& out) const override;
+
+private:
+    static constexpr int32_t kEmpty = INT32_MIN;
+    const char* label_;
+    std::atomic<int32_t> keys_[kSlots];
+    std::atomic<uint32_t> counts_[kSlots];
+    std::atomic<uint32_t> other_;
+};
+
+// Either set directly or, with a reader, sampled at render time.
+class MetricGauge : public Metric {
+public:
+    using Reader = int32_t (*)();
+
+    MetricGauge(const char* name, const char* help, Reader reader = nullptr)
+        : Metric(name, help), value_(0), reader_(reader) {}
+    void set(int32_t v) { value_.store(v, std::memory_order_relaxed); }
+    void add(int32_t d) { value_.fetch_add(d, std::memory_order_relaxed); }
+    int32_t value() const { return reader_ ? reader_() : value_.load(std::memory_order_relaxed); }
+    void render(String& out) const override;
+
+private:
+    std::atomic<int32_t> value_;
+    Reader reader_;
+};
+
+// Fixed upper bounds, ascending; an implicit +Inf bucket follows them.
+class MetricHistogram : public Metric {
+public:
+    static constexpr size_t kMaxBuckets = 12;
+
+    MetricHistogram(const char* name, const char* help, const uint32_t* bounds, size_t count);
+    void observe(uint32_t v);
+    void render(String& out) const override;
+
+    size_t boundCount() const { return count_; }
+    uint32_t bound(size_t i) const { return bounds_[i]; }
+    // Non-cumulative; index boundCount() is the +Inf bucket
+    uint32_t bucket(size_t i) const { return buckets_[i].load(std::memory_order_relaxed); }
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+
+private:
+    const uint32_t* bounds_;
+    size_t count_;
+    std::atomic<uint32_t> buckets_[kMaxBuckets + 1];
+    std::atomic<uint64_t> sum_;
+};
+
+Metric* metricsFirst();
+// Appends every registered metric in Prometheus text exposition format.
+void metricsRender(String& out);
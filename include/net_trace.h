@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+
+#include "metrics.h"
+#include "net_trace_record.h"
+
+// Per-request phase timing for the upstream pollers. Each HTTP attempt
+// fills a NetTrace as it goes; netTraceEnd() files it in a ring of recent
+// traces and in one histogram per phase. The accounting itself is in
+// net_trace_record.
+
+void netTraceInit();
+
+void netTraceBegin(NetTrace& trace, const char* source, int attempt);
+// Charges the time since the previous mark to the given phase.
+void netTraceMark(NetTrace& trace, NetPhase phase);
+// Charges the time since the previous mark to Body and Parse, given how
+// much of it the parser spent working (see TimedStream).
+void netTraceMarkBody(NetTrace& trace, uint32_t parseUs);
+// Resolves and connects ahead of HTTPClient, which then reuses the open
+// connection, so DNS and connect get their own marks. A failure is left
+// for http.GET() to retry and report.
+bool netTracePreconnect(NetTrace& trace, WiFiClientSecure& client, const char* host,
+    uint16_t port, uint32_t timeoutMs);
+void netTraceEnd(NetTrace& trace, int httpCode, bool ok, uint32_t bytes);
+
+// Newest first. Returns the number of traces copied.
+size_t netTraceRecent(NetTrace* out, size_t maxCount);
+const MetricHistogram& netTraceHistogram(NetPhase phase);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Phase accounting behind net_trace: the per-attempt record, marks that
+// take the time as an argument, and the ring of recent traces. No Arduino
+// dependencies, so the native test env builds it.
+
+enum class NetPhase : uint8_t {
+    Dns,
+    Connect,  // TCP connect + TLS handshake (a single call in the core)
+    Ttfb,     // request sent until status line and headers are read
+    Body,     // waiting on body bytes
+    Parse     // deserializeJson itself, excluding waits
+};
+
+constexpr size_t kNetPhaseCount = 5;
+constexpr size_t kNetTraceSlots = 16;
+
+struct NetTrace {
+    const char* source;
+    uint32_t startMs;
+    uint8_t attempt;
+    int16_t httpCode;
+    bool ok;
+    uint32_t bytes;
+    uint32_t phaseMs[kNetPhaseCount];
+    uint8_t reached;  // bit per phase that was marked
+    uint32_t markMs;
+};
+
+void netTraceStartAt(NetTrace& trace, const char* source, int attempt, uint32_t nowMs);
+// Charges the time since the previous mark to the given phase.
+void netTraceMarkAt(NetTrace& trace, NetPhase phase, uint32_t nowMs);
+// Charges the time since the previous mark to Body and Parse, given how
+// much of it the parser spent working. Parse never exceeds the elapsed time.
+void netTraceMarkBodyAt(NetTrace& trace, uint32_t parseUs, uint32_t nowMs);
+void netTraceFinish(NetTrace& trace, int httpCode, bool ok, uint32_t bytes);
+bool netTraceReached(const NetTrace& trace, NetPhase phase);
+
+// Fixed ring of the last kNetTraceSlots traces. Not locked; net_trace
+// guards it with a mutex.
+class NetTraceRing {
+public:
+    NetTraceRing() : next_(0), count_(0) {}
+
+    void push(const NetTrace& trace);
+    // Newest first. Returns the number of traces copied.
+    size_t recent(NetTrace* out, size_t maxCount) const;
+
+private:
+    NetTrace slots_[kNetTraceSlots];
+    size_t next_;
+    size_t count_;
+};
+
+const char* netPhaseName(NetPhase phase);
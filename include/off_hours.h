@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "off_hours_plan.h"
+
+// Off-hours mode: when no game is selected and the cached schedule has
+// nothing coming up soon, the board deep-sleeps until shortly before the
+// next game. The system clock, the WiFi lease cache (NVS) and the last
+// snapshot (LittleFS) all survive, so the wake-up is a warm start.
+
+struct OffHoursStats {
+    bool enabled;
+    bool scheduleKnown;
+    OffHoursPlan plan;
+    uint32_t sleeps;              // deep sleeps since power-on
+    uint32_t sleptS;              // total time asleep since power-on
+    uint16_t sleepFractionPct;    // share of the known schedule window asleep
+    uint32_t savedWhPerWeek;      // estimate from sleepFractionPct
+};
+
+void offHoursInit();
+void offHoursSetEnabled(bool enabled);
+bool offHoursIsEnabled();
+// Called by the schedule poller after each successful fetch.
+void offHoursUpdateSchedule(const int64_t* upcomingStarts, size_t count, bool anyLive);
+// Runs on the loop task; enters deep sleep once a sleep has been planned.
+void offHoursLoop();
+void offHoursGetStats(OffHoursStats& out);
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Sleep planning behind off_hours, kept free of Arduino headers so the
+// native test env builds it.
+
+// Schedule entries the planner looks at; off_hours keeps this many
+constexpr size_t kOffHoursMaxStarts = 64;
+
+struct OffHoursPolicy {
+    uint32_t preGameLeadS;    // wake this long before the first game
+    uint32_t gameLengthS;     // assumed length of a game, for the estimate
+    uint32_t minSleepS;       // shorter gaps are not worth a reboot
+    uint32_t maxSleepS;       // re-check the schedule at least this often
+};
+
+// What the device runs with
+extern const OffHoursPolicy kOffHoursPolicy;
+
+struct OffHoursPlan {
+    bool sleep;
+    int64_t wakeEpoch;
+    uint32_t sleepS;
+};
+
+// Pure planning; no side effects, usable with synthetic schedules.
+// `upcomingStarts` are the start epochs of games that are not final yet.
+OffHoursPlan offHoursPlan(const int64_t* upcomingStarts, size_t count,
+    bool anyLive, int64_t now, const OffHoursPolicy& policy);
+// Share (0..1000 permille) of the window from `now` to the end of the last
+// listed game that the plan would spend asleep. Only the first
+// kOffHoursMaxStarts entries count.
+uint16_t offHoursSleepPermille(const int64_t* upcomingStarts, size_t count,
+    int64_t now, const OffHoursPolicy& policy);
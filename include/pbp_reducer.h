@@ -0,0 +1,128 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ArduinoJson.h>
+
+#include "display/game_types.h"
+
+// Play-by-play JSON filter, event reducer and the roster/name helpers
+// they share with the poller. No Arduino or FreeRTOS dependencies, so
+// the native test env builds it.
+
+// ============================================================================
+// JSON FILTER
+// ============================================================================
+
+// Fields a poll keeps from the play-by-play feed; rosterSpots is only
+// requested until the roster is cached.
+void buildPlayByPlayFilter(JsonDocument& f, bool includeRoster);
+
+// ============================================================================
+// ROSTER & NAMES
+// ============================================================================
+
+struct PlayerEntry {
+    int id;
+    char name[32];
+};
+
+struct RosterCache {
+    PlayerEntry players[80];
+    size_t count;
+    uint32_t gameId;
+
+    void clear() {
+        count = 0;
+        gameId = 0;
+    }
+
+    const char* lookupName(int playerId) const {
+        if (playerId == 0) return "";
+        for (size_t i = 0; i < count; ++i) {
+            if (players[i].id == playerId) return players[i].name;
+        }
+        return "";
+    }
+};
+
+void buildRosterCache(RosterCache& cache, JsonArray roster, uint32_t gameId);
+void buildFullName(char* dest, size_t destSize, const char* part1, const char* part2);
+void copyField(char* dest, size_t destSize, const char* src);
+// The API name when present, otherwise the roster name for playerId
+void resolvePlayerName(const RosterCache& roster, char* out, size_t outSize, const char* apiName, int playerId);
+// Upper-cased last name restricted to the panel font ("J. Doe" -> "DOE")
+void copyRecapName(const char* fullName, char* out, size_t outSize);
+void sanitizeToken(const char* in, char* out, size_t outSize);
+
+// ============================================================================
+// EVENT REDUCER
+// ============================================================================
+// Folds plays into per-game aggregates. Each poll only applies plays whose
+// sortOrder is above the watermark, so the cost of a poll no longer grows
+// with the length of the game.
+
+// Capacities: timed penalties kept for the box, distinct scorers
+constexpr size_t kPbpPenaltyScanMax = 24;
+constexpr size_t kPbpScorerMax = 40;
+
+struct PenaltyWork {
+    PenaltyEntry entry;
+    int32_t startTenths;
+    int32_t endTenths;
+    bool minor;
+};
+
+struct ScorerTally {
+    uint32_t playerId;
+    uint32_t teamId;
+    char name[16];
+    uint8_t goals;
+    uint8_t assists;
+};
+
+// Where shot locations go (the heatmap on the device); either may be null.
+// reset runs whenever the reducer starts over inside consume/reconcile.
+struct ShotSink {
+    void (*add)(bool homeTeam, int x, int y, bool homeDefendsRight, bool goal);
+    void (*reset)();
+};
+
+struct TeamContext {
+    uint32_t gameId;
+    uint32_t awayId;
+    uint32_t homeId;
+    const char* awayAbbrev;
+    const char* homeAbbrev;
+    const RosterCache* roster;  // null: API names only
+    ShotSink shots;
+};
+
+struct GameReducer {
+    uint32_t gameId;
+    int watermark;
+    uint32_t playsReduced;
+    uint32_t rebuilds;  // times the feed went backwards and was replayed
+    bool reconciled;
+    GameStats stats;
+    RecapGoal goals[kMaxRecapGoals];
+    uint8_t goalCount;
+    ScorerTally scorers[kPbpScorerMax];
+    uint8_t scorerCount;
+    PenaltyWork penalties[kPbpPenaltyScanMax];
+    size_t penaltyCount;
+};
+
+// Clears the aggregates only; the caller resets its shot sink.
+void reducerReset(GameReducer& r, uint32_t gameId);
+// Applies plays above the watermark; returns how many were applied. If
+// the feed was rewritten (the last sortOrder went backwards) the
+// aggregates are rebuilt from scratch and rebuilds is incremented.
+uint32_t reducerConsume(GameReducer& r, JsonArray plays, const TeamContext& ctx);
+// Scoring details are sometimes amended after the fact. Once the game is
+// final the aggregates are replayed one time so the recap sees them.
+void reducerReconcileFinal(GameReducer& r, JsonArray plays, const TeamContext& ctx);
+uint8_t reducerLeaders(const GameReducer& r, StatLeader* out, uint8_t maxOut);
+// Penalties still being served at the given clock sample
+uint8_t reducerActivePenalties(const GameReducer& r, int period, uint16_t clockTenths,
+    PenaltyEntry* out, uint8_t maxOut);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "power_state.h"
+
+// Standby for when nobody is looking at the panel. Entering standby turns
+// the display off (optionally deleting the HUB75 driver so DMA stops and
+// its buffers are freed), tells the dvfs governor to drop the CPU clock
+// and use max modem sleep, and throttles the pollers. Waking undoes it in
+// reverse order.
+
+struct PowerPolicy {
+    bool releasePanel;        // delete the panel driver (frees DMA buffers)
+    uint32_t pbpHeartbeatMs;  // 0 = no play-by-play polling in standby
+};
+
+struct PowerStats {
+    PowerState state;
+    uint32_t standbyEntries;
+    uint32_t standbyForMs;        // 0 while active
+    uint32_t totalStandbyMs;      // completed standby periods
+    uint32_t lastEnterMs;         // time to apply standby
+    uint32_t lastWakeMs;          // time from wake request to panel back up
+    uint16_t cpuMhz;
+    bool panelReleased;
+};
+
+void powerManagerInit();
+// Both run on the loop task (the API handler), which also drives the panel.
+void powerRequestStandby();
+void powerRequestWake();
+bool powerIsStandby();
+// Blocks while in standby. Returns true once active, false on timeout.
+bool powerWaitActive(uint32_t timeoutMs);
+const PowerPolicy& powerGetPolicy();
+void powerSetReleasePanel(bool release);
+void powerGetStats(PowerStats& out);
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+
+// Power states and the pure transition function behind power_manager.
+// No Arduino dependencies, so the native test env builds it.
+
+enum class PowerState : uint8_t {
+    Active,
+    Standby
+};
+
+enum class PowerEvent : uint8_t {
+    StandbyRequested,
+    WakeRequested
+};
+
+// Pure transition function; no side effects. A request for the state
+// already in effect returns it unchanged, which the manager treats as a
+// no-op.
+PowerState powerNextState(PowerState current, PowerEvent event);
+const char* powerStateName(PowerState state);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "spsc_byte_ring.h"
+
+// Read-only Stream over the consumer side of an SpscByteRing.
+// Reads yield until bytes arrive, the producer closes the ring,
+// or nothing new has arrived for the stream timeout.
+class RingStream : public Stream {
+public:
+    RingStream(SpscByteRing& ring, unsigned long timeoutMs)
+        : ring_(ring) {
+        setTimeout(timeoutMs);
+    }
+
+    int available() override {
+        return (int)ring_.available();
+    }
+
+    int read() override {
+        char c;
+        return readBytes(&c, 1) == 1 ? (int)(uint8_t)c : -1;
+    }
+
+    int peek() override {
+        if (!waitForData()) return -1;
+        return ring_.peek();
+    }
+
+    void flush() override {}
+
+    size_t write(uint8_t) override {
+        return 0;
+    }
+
+    size_t readBytes(char* buffer, size_t length) override {
+        size_t n = 0;
+        while (n < length) {
+            if (!waitForData()) break;
+            n += ring_.read((uint8_t*)buffer + n, length - n);
+        }
+        return n;
+    }
+
+private:
+    bool waitForData() {
+        unsigned long start = millis();
+        while (ring_.available() == 0) {
+            if (ring_.isWriteClosed()) return ring_.available() > 0;
+            if (millis() - start >= _timeout) return false;
+            vTaskDelay(1);
+        }
+        return true;
+    }
+
+    SpscByteRing& ring_;
+};
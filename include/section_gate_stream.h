@@ -0,0 +1,171 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Stream filter that follows the top-level members of a JSON object and
+// ends the document early. Once every required top-level key has been
+// read in full, the next top-level ',' is replaced by '}' and the stream
+// reports EOF, so the parser finishes without draining the rest of the
+// body. If a required key never shows up, everything passes through
+// unchanged.
+//
+// Keys are listed in the order the body sends them. Keys flagged in
+// optionalMask are read in full when present but never waited for, so
+// they only survive if they come before the last required key. A listed
+// key arriving after one listed later sets outOfOrder(), which means the
+// order can no longer be trusted.
+class SectionGateStream : public Stream {
+public:
+    static constexpr size_t kMaxKeys = 16;
+
+    SectionGateStream(Stream& base, const char* const* keys, size_t keyCount, uint32_t optionalMask = 0)
+        : base_(base), keys_(keys), keyCount_(keyCount > kMaxKeys ? kMaxKeys : keyCount) {
+        const uint32_t listed = (1u << keyCount_) - 1u;
+        requiredMask_ = listed & ~optionalMask;
+    }
+
+    size_t bytesRead() const { return bytesRead_; }
+    bool closedEarly() const { return closed_; }
+    bool outOfOrder() const { return outOfOrder_; }
+
+    int available() override {
+        if (done_) return 0;
+        if (closed_) return 1;
+        return base_.available();
+    }
+
+    int read() override {
+        if (done_) return -1;
+        if (closed_) {
+            done_ = true;
+            return '}';
+        }
+        int c = base_.read();
+        if (c < 0) return c;
+        bytesRead_++;
+        if (track((char)c)) {
+            closed_ = true;
+            done_ = true;
+            return '}';
+        }
+        return c;
+    }
+
+    int peek() override {
+        if (done_) return -1;
+        if (closed_) return '}';
+        int c = base_.peek();
+        if (c == ',' && depth_ == 1 && !inString_ && wouldClose()) return '}';
+        return c;
+    }
+
+    void flush() override {}
+
+    size_t write(uint8_t) override {
+        return 0;
+    }
+
+    size_t readBytes(char* buffer, size_t length) override {
+        size_t n = 0;
+        while (n < length) {
+            int c = read();
+            if (c < 0) break;
+            buffer[n++] = (char)c;
+        }
+        return n;
+    }
+
+private:
+    // Returns true when this ',' should become the closing '}'.
+    bool track(char c) {
+        if (inString_) {
+            if (escape_) {
+                escape_ = false;
+            } else if (c == '\\') {
+                escape_ = true;
+            } else if (c == '"') {
+                inString_ = false;
+                if (capturingKey_) {
+                    capturingKey_ = false;
+                    key_[keyLen_] = '\0';
+                    currentKey_ = keyIndex(key_);
+                    if (currentKey_ >= 0) {
+                        if (currentKey_ < lastKey_) outOfOrder_ = true;
+                        else lastKey_ = currentKey_;
+                    }
+                }
+            } else if (capturingKey_ && keyLen_ + 1 < sizeof(key_)) {
+                key_[keyLen_++] = c;
+            }
+            return false;
+        }
+
+        switch (c) {
+            case '"':
+                inString_ = true;
+                if (depth_ == 1 && expectKey_) {
+                    capturingKey_ = true;
+                    expectKey_ = false;
+                    keyLen_ = 0;
+                }
+                break;
+            case '{':
+            case '[':
+                depth_++;
+                if (depth_ == 1) expectKey_ = true;
+                break;
+            case '}':
+            case ']':
+                depth_--;
+                break;
+            case ',':
+                if (depth_ == 1) {
+                    const bool close = wouldClose();
+                    markSeen();
+                    expectKey_ = true;
+                    return close;
+                }
+                break;
+            default:
+                break;
+        }
+        return false;
+    }
+
+    int keyIndex(const char* key) const {
+        for (size_t i = 0; i < keyCount_; ++i) {
+            if (strcmp(keys_[i], key) == 0) return (int)i;
+        }
+        return -1;
+    }
+
+    void markSeen() {
+        if (currentKey_ >= 0) seenMask_ |= (1u << currentKey_);
+        currentKey_ = -1;
+    }
+
+    bool wouldClose() const {
+        uint32_t mask = seenMask_;
+        if (currentKey_ >= 0) mask |= (1u << currentKey_);
+        return requiredMask_ != 0 && (mask & requiredMask_) == requiredMask_;
+    }
+
+    Stream& base_;
+    const char* const* keys_;
+    size_t keyCount_;
+    uint32_t requiredMask_ = 0;
+    uint32_t seenMask_ = 0;
+    int currentKey_ = -1;
+    int lastKey_ = -1;
+    bool outOfOrder_ = false;
+    int depth_ = 0;
+    bool inString_ = false;
+    bool escape_ = false;
+    bool expectKey_ = false;
+    bool capturingKey_ = false;
+    char key_[24] = {0};
+    size_t keyLen_ = 0;
+    size_t bytesRead_ = 0;
+    bool closed_ = false;
+    bool done_ = false;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "display/game_types.h"
+
+// On-flash format of the warm-start snapshot (see snapshot_store): a
+// header with magic, version, size and CRC32, then the payload. No
+// Arduino dependencies, so the native test env builds it.
+
+constexpr uint32_t kSnapshotMagic = 0x50534253;  // "SBSP"
+constexpr uint16_t kSnapshotVersion = 1;
+// Older than this and the game is long over; fall back to a cold start
+constexpr int64_t kSnapshotMaxAgeS = 12 * 3600;
+
+struct SnapshotTeam {
+    uint32_t id;
+    char abbrev[4];
+    char name[32];
+    uint16_t score;
+    uint16_t sog;
+};
+
+// Bump kSnapshotVersion whenever this changes.
+struct SnapshotRecord {
+    uint32_t gameId;
+    int64_t savedAtEpoch;   // 0 when the clock was not synced yet
+    char gameState[8];
+    char startTimeUtc[24];
+    char utcOffset[8];
+    SnapshotTeam away;
+    SnapshotTeam home;
+    uint8_t period;
+    uint8_t inIntermission;
+    char timeRemaining[8];
+};
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint32_t crc;
+};
+
+constexpr size_t kSnapshotFileSize = sizeof(SnapshotHeader) + sizeof(SnapshotRecord);
+
+uint32_t snapshotCrc32(const uint8_t* data, size_t len);
+
+// nowEpoch is the wall time, 0 when unknown. Padding is zeroed, so equal
+// snapshots pack to equal bytes.
+void snapshotPack(SnapshotRecord& out, const GameSnapshot& snap, int64_t nowEpoch);
+// Fills the identity, teams, score and clock fields; clears the rest
+void snapshotUnpack(GameSnapshot& out, const SnapshotRecord& rec);
+
+// Header + record as stored; out must hold kSnapshotFileSize bytes
+void snapshotEncode(const SnapshotRecord& rec, uint8_t* out);
+// Rejects a wrong magic, version, size or CRC. Strings are terminated.
+bool snapshotDecode(const uint8_t* data, size_t len, SnapshotRecord& out);
+
+// Equal apart from the save time
+bool snapshotSameContent(const SnapshotRecord& a, const SnapshotRecord& b);
+// Too old to show. Unknown times (either side 0) never count as stale.
+bool snapshotIsStale(const SnapshotRecord& rec, int64_t nowEpoch);
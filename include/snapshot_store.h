@@ -0,0 +1,16 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Warm-start persistence. The last good compact snapshot of the selected
+// game (teams, score, period, clock) is kept in LittleFS so the scoreboard
+// can be drawn right after a reboot, before WiFi is up. Writes are
+// debounced and each record carries a CRC32; a bad or stale record is
+// ignored.
+
+// Loads /snapshot.bin into the data model. Call after dataModelInit() and
+// before the first frame. Returns true when a record was restored.
+bool snapshotStoreRestore();
+
+// Starts the task that writes the snapshot back when the model changes.
+void snapshotStoreStart();
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+// Lock-free single-producer / single-consumer byte ring.
+// Only the producer advances head_ and only the consumer advances tail_,
+// so the two sides never contend. Capacity must be a power of two.
+class SpscByteRing {
+public:
+    SpscByteRing(uint8_t* buffer, size_t capacity)
+        : buffer_(buffer), mask_(capacity - 1), head_(0), tail_(0),
+          writeClosed_(false), readAborted_(false) {}
+
+    // Not thread safe: call only while neither side is running.
+    void reset() {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        writeClosed_.store(false, std::memory_order_relaxed);
+        readAborted_.store(false, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // Consumer side
+    size_t available() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+    }
+
+    size_t read(uint8_t* out, size_t len) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t used = head - tail;
+        if (len > used) len = used;
+        if (len == 0) return 0;
+        const size_t idx = tail & mask_;
+        size_t first = capacity() - idx;
+        if (first > len) first = len;
+        memcpy(out, buffer_ + idx, first);
+        memcpy(out + first, buffer_, len - first);
+        tail_.store(tail + len, std::memory_order_release);
+        return len;
+    }
+
+    int peek() const {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) return -1;
+        return buffer_[tail & mask_];
+    }
+
+    void abortRead() { readAborted_.store(true, std::memory_order_release); }
+    bool isWriteClosed() const { return writeClosed_.load(std::memory_order_acquire); }
+
+    // Producer side. writeSpan() exposes the largest contiguous free
+    // region so the producer can receive straight into the ring.
+    size_t writeSpan(uint8_t*& dst) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        const size_t space = capacity() - (head - tail);
+        const size_t idx = head & mask_;
+        size_t contiguous = capacity() - idx;
+        if (contiguous > space) contiguous = space;
+        dst = buffer_ + idx;
+        return contiguous;
+    }
+
+    void commitWrite(size_t len) {
+        head_.store(head_.load(std::memory_order_relaxed) + len, std::memory_order_release);
+    }
+
+    void closeWrite() { writeClosed_.store(true, std::memory_order_release); }
+    bool isReadAborted() const { return readAborted_.load(std::memory_order_acquire); }
+
+private:
+    uint8_t* buffer_;
+    size_t mask_;
+    std::atomic<size_t> head_;
+    std::atomic<size_t> tail_;
+    std::atomic<bool> writeClosed_;
+    std::atomic<bool> readAborted_;
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <WebServer.h>
+
+// Web UI files from LittleFS. The build (tools/gzip_assets.py) stores text
+// assets as <name>.gz; they go out as-is with Content-Encoding: gzip, a
+// strong ETag hashed from the stored bytes and the row's Cache-Control,
+// and a matching If-None-Match gets a 304 without touching the file.
+// Needs If-None-Match in the server's collectHeaders list.
+void staticAssetsInit(WebServer& server);
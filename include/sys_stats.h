@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Runtime instrumentation: per-task CPU share and stack headroom, heap
+// and PSRAM figures, and the panel's DMA footprint. CPU shares are
+// measured between two consecutive samples. Per-task data needs the
+// FreeRTOS trace facility; CPU time also needs run-time stats.
+
+constexpr size_t kSysStatsMaxTasks = 24;
+
+struct TaskStat {
+    char name[16];
+    uint8_t state;          // eTaskState
+    uint8_t priority;
+    uint32_t stackFreeBytes;  // high-water mark: least free stack ever
+    int16_t cpuPermille;      // -1 without run-time stats
+};
+
+struct HeapStats {
+    uint32_t internalFree;
+    uint32_t internalLargest;
+    uint32_t internalMinFree;
+    uint32_t dmaFree;
+    uint32_t dmaLargest;
+    uint32_t psramTotal;
+    uint32_t psramFree;
+    uint32_t psramLargest;
+    uint32_t psramMinFree;
+};
+
+struct SysStats {
+    uint32_t uptimeMs;
+    uint32_t windowMs;        // time covered by the CPU shares
+    bool taskStats;
+    bool runtimeStats;
+    uint8_t taskCount;
+    TaskStat tasks[kSysStatsMaxTasks];
+    HeapStats heap;
+    uint32_t panelDmaBytes;
+};
+
+void sysStatsInit();
+// Takes a new sample; CPU shares cover the time since the previous one.
+void sysStatsSample(SysStats& out);
+// Periodic snapshot to the log; 0 disables it.
+void sysStatsSetLogInterval(uint32_t intervalMs);
+uint32_t sysStatsLogInterval();
+const char* sysStatsTaskStateName(uint8_t state);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Calendar helpers for API timestamps. Pure integer arithmetic on the
+// proleptic Gregorian calendar, so results do not depend on the TZ
+// setting and no mktime()/localtime() call is needed.
+
+constexpr int64_t kSecondsPerDay = 86400;
+
+// Days since 1970-01-01 for a civil date.
+int64_t daysFromCivil(int year, unsigned month, unsigned day);
+void civilFromDays(int64_t days, int& year, unsigned& month, unsigned& day);
+
+// Parses "YYYY-MM-DDTHH:MM[:SS]Z" into seconds since the Unix epoch.
+bool parseIsoUtc(const char* iso, int64_t& epochOut);
+
+// Parses "+HH:MM" / "-HH:MM" into minutes east of UTC; 0 when malformed.
+int parseUtcOffsetMinutes(const char* offset);
+
+// A start time as shown at a fixed UTC offset: "19H" / "19H30", "DD-MM",
+// and the UTC second at which that local day ends.
+struct LocalStartTime {
+    int64_t dayEndEpoch;
+    char label[8];
+    char dateLabel[6];
+};
+void localStartTime(int64_t startEpoch, int offsetMinutes, LocalStartTime& out);
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Read-only Stream that pulls from its source in small chunks and adds up
+// the time spent inside those pulls. Wrapped around an HTTP body, that is
+// the time a streaming parser sat waiting for the network; the rest of
+// the parse call is the parser itself. Reads at most what the source
+// reports available (or one byte), so it never blocks longer than the
+// source would.
+class TimedStream : public Stream {
+public:
+    explicit TimedStream(Stream& base)
+        : base_(base), pos_(0), len_(0), waitUs_(0), bytesRead_(0) {}
+
+    uint32_t waitUs() const { return waitUs_; }
+    size_t bytesRead() const { return bytesRead_; }
+
+    int available() override {
+        return (int)(len_ - pos_) + base_.available();
+    }
+
+    int read() override {
+        if (pos_ == len_ && !refill()) return -1;
+        return (uint8_t)buf_[pos_++];
+    }
+
+    int peek() override {
+        if (pos_ == len_ && !refill()) return -1;
+        return (uint8_t)buf_[pos_];
+    }
+
+    void flush() override {}
+
+    size_t write(uint8_t) override {
+        return 0;
+    }
+
+    size_t readBytes(char* buffer, size_t length) override {
+        size_t n = 0;
+        while (n < length) {
+            if (pos_ == len_ && !refill()) break;
+            size_t take = len_ - pos_;
+            if (take > length - n) take = length - n;
+            memcpy(buffer + n, buf_ + pos_, take);
+            pos_ += take;
+            n += take;
+        }
+        return n;
+    }
+
+private:
+    static constexpr size_t kChunk = 128;
+
+    bool refill() {
+        const uint32_t startUs = micros();
+        int want = base_.available();
+        if (want <= 0) want = 1;
+        if (want > (int)kChunk) want = (int)kChunk;
+        len_ = base_.readBytes(buf_, (size_t)want);
+        pos_ = 0;
+        waitUs_ += micros() - startUs;
+        bytesRead_ += len_;
+        return len_ > 0;
+    }
+
+    Stream& base_;
+    char buf_[kChunk];
+    size_t pos_;
+    size_t len_;
+    uint32_t waitUs_;
+    size_t bytesRead_;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "upstream_policy.h"
+
+// Shared view of api-web.nhle.com health, used by the schedule and
+// play-by-play pollers. One mutex-guarded UpstreamPolicy fed with millis()
+// and esp_random().
+
+void upstreamHealthInit();
+
+// Circuit breaker gate. Returns false while the circuit is open; in the
+// half-open state a single probe request is let through.
+bool upstreamAllowRequest();
+
+// Deadline for one attempt: a multiple of the recent p95 time-to-first-
+// byte. An attempt that misses it is abandoned and re-issued at once.
+uint32_t upstreamRequestTimeoutMs();
+
+// Exponential backoff with jitter for the given attempt index.
+uint32_t upstreamRetryDelayMs(uint32_t baseMs, int attempt);
+
+void upstreamRecordSuccess(uint32_t ttfbMs);
+// A failed attempt of `loop` (deadlineMissed: it ran past
+// upstreamRequestTimeoutMs). Charges it to the circuit, or records the
+// re-issue, and returns what the loop does next.
+RetryStep upstreamRecordAttemptFailure(UpstreamRetryLoop& loop, bool deadlineMissed);
+
+void upstreamGetStats(UpstreamHealthStats& out);
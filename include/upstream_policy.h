@@ -0,0 +1,124 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "backoff.h"
+
+// The decisions behind upstream_health: the p95-based attempt deadline
+// and the circuit breaker with its jittered open window. Time and
+// randomness come in as arguments, so the native test env can drive it
+// against a simulated upstream.
+
+enum class CircuitState : uint8_t {
+    Closed,
+    Open,
+    HalfOpen
+};
+
+struct UpstreamHealthStats {
+    CircuitState circuit;
+    uint32_t p95TtfbMs;
+    uint32_t requestTimeoutMs;
+    uint32_t retryInMs;
+    uint16_t consecutiveFailures;
+    uint32_t totalRequests;
+    uint32_t totalFailures;
+    uint32_t reissues;
+    uint32_t circuitOpens;
+    uint32_t lastSuccessMs;      // millis() of the last good response, 0 if none
+    uint32_t successIntervalMs;  // gap between the last two good responses
+};
+
+// What a poller's fetch loop does after a failed attempt
+enum class RetryStep : uint8_t {
+    Reissue,  // missed the deadline: send it again now, no attempt slot used
+    Backoff,  // wait upstreamRetryDelayMs, then the next attempt
+    GiveUp    // no attempts left
+};
+
+// Attempt bookkeeping for one fetch: up to maxAttempts attempts, plus one
+// re-issue of an attempt that missed its deadline. The pollers' fetch
+// loops and the native test drive the same instance type.
+class UpstreamRetryLoop {
+public:
+    explicit UpstreamRetryLoop(int maxAttempts) : maxAttempts_(maxAttempts) {}
+
+    // Moves to the next attempt (or the pending re-issue); false once all
+    // attempts are used.
+    bool next();
+    int attempt() const { return attempt_; }
+    // The current attempt re-issues a deadline miss: it continues a
+    // request the circuit gate already let through, and its failure also
+    // charges the miss behind it.
+    bool reissuing() const { return reissuing_; }
+    RetryStep fail(bool deadlineMissed);
+
+private:
+    int maxAttempts_;
+    int attempt_ = -1;
+    bool reissuing_ = false;
+    bool reissuePending_ = false;
+    bool reissueUsed_ = false;
+};
+
+class UpstreamPolicy {
+public:
+    static constexpr size_t kTtfbSamples = 32;
+    static constexpr size_t kTtfbMinSamples = 8;
+    static constexpr uint32_t kDefaultTimeoutMs = 30000;
+    static constexpr uint32_t kMinTimeoutMs = 2500;
+    static constexpr uint32_t kMaxTimeoutMs = 30000;
+    static constexpr uint16_t kFailuresToOpen = 5;
+    static constexpr uint32_t kOpenBaseMs = 10000;
+    static constexpr uint32_t kOpenMaxMs = 300000;
+
+    // Circuit breaker gate. False while the circuit is open; in the
+    // half-open state a single probe request is let through.
+    bool allowRequest(uint32_t nowMs);
+    // Deadline for one attempt: twice the recent p95 time-to-first-byte,
+    // clamped; the default until enough samples are in.
+    uint32_t requestTimeoutMs() const;
+
+    void recordSuccess(uint32_t ttfbMs, uint32_t nowMs);
+    // afterReissue charges the deadline miss behind a re-issue as well.
+    // Returns true when this failure opened the circuit; `random` jitters
+    // the open window.
+    bool recordFailure(bool afterReissue, uint32_t nowMs, uint32_t random);
+    // A deadline miss being re-issued. It only counts as a failure if the
+    // re-issue fails too.
+    void recordReissue();
+    // A failed attempt of `loop`: records the re-issue or the failure and
+    // returns what the loop does next.
+    RetryStep recordAttemptFailure(UpstreamRetryLoop& loop, bool deadlineMissed,
+        uint32_t nowMs, uint32_t random);
+
+    CircuitState circuit() const { return circuitState; }
+    uint32_t openForMs() const { return openWindowMs; }
+    void getStats(UpstreamHealthStats& out, uint32_t nowMs) const;
+
+private:
+    void recomputeP95();
+    void openCircuit(uint32_t nowMs, uint32_t random);
+
+    uint16_t ttfbSamples[kTtfbSamples] = {0};
+    size_t ttfbCount = 0;
+    size_t ttfbNext = 0;
+    uint32_t p95TtfbMs = 0;
+
+    CircuitState circuitState = CircuitState::Closed;
+    uint16_t consecutiveFailures = 0;
+    uint8_t openStreak = 0;
+    uint32_t openedAtMs = 0;
+    uint32_t openWindowMs = 0;
+    bool probeInFlight = false;
+
+    uint32_t totalRequests = 0;
+    uint32_t totalFailures = 0;
+    uint32_t reissues = 0;
+    uint32_t circuitOpens = 0;
+    uint32_t lastSuccessMs = 0;
+    uint32_t successIntervalMs = 0;
+};
+
+const char* upstreamCircuitName(CircuitState state);
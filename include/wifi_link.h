@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Arduino.h>
+
+// WiFi link supervisor. A background task owns the station connection:
+// it reconnects with bounded backoff and uses the last BSSID, channel and
+// IP lease (kept in NVS) to skip the scan and DHCP when it can. The
+// pollers block on wifiLinkWaitUp() while the link is down instead of
+// burning retries against a dead network.
+
+enum class WifiLinkState : uint8_t {
+    Connecting,
+    Up,
+    Down
+};
+
+constexpr size_t kWifiReconnectBuckets = 6;
+
+struct WifiLinkStats {
+    WifiLinkState state;
+    uint32_t connects;          // successful associations, boot included
+    uint32_t reconnects;        // recoveries after a drop
+    uint32_t fastConnects;      // connects that used the cached BSSID/lease
+    uint32_t dhcpFallbacks;     // cached path failed, fell back to scan + DHCP
+    uint32_t lastReconnectMs;
+    uint32_t downForMs;         // 0 while up
+    int8_t rssi;
+    uint8_t channel;
+    // Time-to-reconnect histogram; bucket i counts reconnects that took
+    // at most kWifiReconnectBucketMs[i] (the last bucket is unbounded).
+    uint32_t reconnectHist[kWifiReconnectBuckets];
+};
+
+extern const uint32_t kWifiReconnectBucketMs[kWifiReconnectBuckets];
+
+void wifiLinkStart();
+bool wifiLinkIsUp();
+// Blocks until the link is up (station has an IP) or the timeout expires.
+bool wifiLinkWaitUp(uint32_t timeoutMs);
+void wifiLinkGetStats(WifiLinkStats& out);
+const char* wifiLinkStateName(WifiLinkState state);
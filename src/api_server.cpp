@@ -5,14 +5,32 @@
 #include <LittleFS.h>
 #include <ArduinoJson.h>
 
+#include "boot.h"
+#include "dvfs.h"
+#include "heap_tag.h"
+#include "logger.h"
+#include "metrics.h"
+#include "net_trace.h"
 #include "schedule_service.h"
+#include "static_assets.h"
+#include "sys_stats.h"
+#include "off_hours.h"
 #include "playbyplay_service.h"
+#include "power_manager.h"
+#include "upstream_health.h"
+#include "wifi_link.h"
 #include "display/data_model.h"
 #include "display/display_manager.h"
+#include "display/panel_mirror.h"
 static WebServer server(80);
 static uint32_t selectedGameId = 0;
 static const char* CONFIG_PATH = "/scoreboard.json";
 
+static MetricLabeledCounter stateResponses("scoreboard_state_responses_total",
+    "/api/state responses by HTTP status (304 = dashboard poll with nothing new)", "code");
+static MetricCounter stateBodyBytes("scoreboard_state_body_bytes_total",
+    "/api/state body bytes sent");
+
 static void loadSelectedGameId() {
     if (!LittleFS.exists(CONFIG_PATH)) {
         selectedGameId = 0;
@@ -42,24 +60,6 @@ static void saveSelectedGameId(uint32_t id) {
     f.close();
 }
 
-static void serveFile(const char* path, const char* contentType) {
-    if (!LittleFS.exists(path)) {
-        server.send(404, "text/plain", "Fichier non trouvé");
-        return;
-    }
-    File f = LittleFS.open(path, "r");
-    if (!f) {
-        server.send(500, "text/plain", "Erreur lecture");
-        return;
-    }
-    server.streamFile(f, contentType);
-    f.close();
-}
-
-static void handleRoot() {
-    serveFile("/index.html", "text/html");
-}
-
 static void handleApiSelectGame() {
     if (server.method() != HTTP_POST) {
         server.send(405, "application/json", "{\"error\":\"method\"}");
@@ -76,12 +76,7 @@ static void handleApiSelectGame() {
         server.send(400, "application/json", "{\"error\":\"json\"}");
         return;
     }
-    uint32_t id = doc["gameId"] | 0;
-    selectedGameId = id;
-    saveSelectedGameId(id);
-    dataModelSetSelectedGame(id);
-    Serial.printf("[api] select gameId=%u\n", (unsigned)id);
-
+    apiServerSelectGame(doc["gameId"] | 0);
     server.send(200, "application/json", "{}");
 }
 
@@ -93,10 +88,100 @@ static void handleApiSelectedGame() {
     server.send(200, "application/json", resp);
 }
 
+// Everything /api/state returns is covered by this tag: the data-model
+// version plus the selection, power and health flags. The version is read
+// before the snapshot, so a racing update can only make the tag older
+// than the body (one extra 200), never newer.
+static void buildStateEtag(char* out, size_t outSize) {
+    UpstreamHealthStats upstream{};
+    upstreamGetStats(upstream);
+    const unsigned flags = (displayIsEnabled() ? 1u : 0u) |
+        (powerIsStandby() ? 2u : 0u) |
+        (wifiLinkIsUp() ? 4u : 0u) |
+        ((unsigned)upstream.circuit << 3);
+    snprintf(out, outSize, "\"%lx.%lx.%x\"",
+        (unsigned long)dataModelGetVersion(), (unsigned long)selectedGameId, flags);
+}
+
+static void handleApiState() {
+    char etag[40];
+    buildStateEtag(etag, sizeof(etag));
+    server.sendHeader("ETag", etag);
+    // Browsers revalidate on every fetch and get the cached body on 304
+    server.sendHeader("Cache-Control", "no-cache");
+    if (server.header("If-None-Match") == etag) {
+        stateResponses.inc(304);
+        server.send(304);
+        return;
+    }
+
+    // Too big for the loop task stack
+    static GameSnapshot snap;
+    const bool haveGame = dataModelGetSnapshot(snap);
+    UpstreamHealthStats upstream{};
+    upstreamGetStats(upstream);
+
+    JsonDocument doc;
+    doc["selectedGameId"] = selectedGameId;
+    JsonObject display = doc["display"].to<JsonObject>();
+    display["enabled"] = displayIsEnabled();
+    display["standby"] = powerIsStandby();
+    JsonObject health = doc["health"].to<JsonObject>();
+    health["wifi"] = wifiLinkIsUp();
+    health["circuit"] = upstreamCircuitName(upstream.circuit);
+    if (haveGame) {
+        JsonObject game = doc["game"].to<JsonObject>();
+        game["id"] = snap.gameId;
+        game["state"] = snap.gameState;
+        game["start"] = snap.startLabel;
+        game["period"] = snap.period;
+        game["clock"] = snap.timeRemaining;
+        game["running"] = snap.clockRunning;
+        game["intermission"] = snap.inIntermission;
+        const TeamInfo* teams[2] = {&snap.away, &snap.home};
+        const char* keys[2] = {"away", "home"};
+        for (size_t i = 0; i < 2; ++i) {
+            JsonObject team = game[keys[i]].to<JsonObject>();
+            team["abbrev"] = teams[i]->abbrev;
+            team["score"] = teams[i]->score;
+            team["sog"] = teams[i]->sog;
+        }
+        if (snap.awayPP || snap.homePP) {
+            game["pp"] = snap.awayPP ? "away" : "home";
+        }
+        if (snap.goalEventId) {
+            JsonObject goal = game["goal"].to<JsonObject>();
+            goal["scorer"] = snap.goalScorer;
+            goal["assist1"] = snap.goalAssist1;
+            goal["assist2"] = snap.goalAssist2;
+            goal["period"] = snap.goalPeriod;
+            goal["time"] = snap.goalTime;
+        }
+    } else {
+        doc["game"] = nullptr;
+    }
+    String resp;
+    serializeJson(doc, resp);
+    stateResponses.inc(200);
+    stateBodyBytes.inc(resp.length());
+    server.send(200, "application/json", resp);
+}
+
 static void handleApiDisplayPower() {
     if (server.method() == HTTP_GET) {
+        PowerStats stats{};
+        powerGetStats(stats);
         JsonDocument doc;
         doc["enabled"] = displayIsEnabled();
+        doc["state"] = powerStateName(stats.state);
+        doc["releasePanel"] = powerGetPolicy().releasePanel;
+        doc["cpuMhz"] = stats.cpuMhz;
+        doc["panelReleased"] = stats.panelReleased;
+        doc["standbyEntries"] = stats.standbyEntries;
+        doc["standbyForMs"] = stats.standbyForMs;
+        doc["totalStandbyMs"] = stats.totalStandbyMs;
+        doc["enterMs"] = stats.lastEnterMs;
+        doc["wakeMs"] = stats.lastWakeMs;
         String resp;
         serializeJson(doc, resp);
         server.send(200, "application/json", resp);
@@ -117,10 +202,49 @@ static void handleApiDisplayPower() {
         return;
     }
     bool enabled = doc["enabled"] | true;
-    displaySetEnabled(enabled);
+    if (!doc["releasePanel"].isNull()) {
+        powerSetReleasePanel(doc["releasePanel"] | true);
+    }
+    if (enabled) {
+        powerRequestWake();
+    } else {
+        powerRequestStandby();
+    }
     server.send(200, "application/json", "{}");
 }
 
+static void handleApiOffHours() {
+    if (server.method() == HTTP_POST) {
+        String body = server.arg("plain");
+        JsonDocument req;
+        if (deserializeJson(req, body)) {
+            server.send(400, "application/json", "{\"error\":\"json\"}");
+            return;
+        }
+        offHoursSetEnabled(req["enabled"] | false);
+    } else if (server.method() != HTTP_GET) {
+        server.send(405, "application/json", "{\"error\":\"method\"}");
+        return;
+    }
+    OffHoursStats stats{};
+    offHoursGetStats(stats);
+    JsonDocument doc;
+    doc["enabled"] = stats.enabled;
+    doc["scheduleKnown"] = stats.scheduleKnown;
+    doc["sleepPlanned"] = stats.plan.sleep;
+    if (stats.plan.sleep) {
+        doc["wakeEpoch"] = stats.plan.wakeEpoch;
+        doc["sleepS"] = stats.plan.sleepS;
+    }
+    doc["sleeps"] = stats.sleeps;
+    doc["sleptS"] = stats.sleptS;
+    doc["sleepFractionPct"] = stats.sleepFractionPct;
+    doc["savedWhPerWeek"] = stats.savedWhPerWeek;
+    String resp;
+    serializeJson(doc, resp);
+    server.send(200, "application/json", resp);
+}
+
 static void handleApiPreviewGoal() {
     if (server.method() != HTTP_POST) {
         server.send(405, "application/json", "{\"error\":\"method\"}");
@@ -132,26 +256,348 @@ static void handleApiPreviewGoal() {
     }
     server.send(200, "application/json", "{}");
 }
+
+static void handleApiUpstream() {
+    UpstreamHealthStats stats{};
+    upstreamGetStats(stats);
+    JsonDocument doc;
+    doc["circuit"] = upstreamCircuitName(stats.circuit);
+    doc["retryInMs"] = stats.retryInMs;
+    doc["p95TtfbMs"] = stats.p95TtfbMs;
+    doc["requestTimeoutMs"] = stats.requestTimeoutMs;
+    doc["consecutiveFailures"] = stats.consecutiveFailures;
+    doc["requests"] = stats.totalRequests;
+    doc["failures"] = stats.totalFailures;
+    doc["reissues"] = stats.reissues;
+    doc["circuitOpens"] = stats.circuitOpens;
+    String resp;
+    serializeJson(doc, resp);
+    server.send(200, "application/json", resp);
+}
+
+static void handleApiWifi() {
+    WifiLinkStats stats{};
+    wifiLinkGetStats(stats);
+    JsonDocument doc;
+    doc["state"] = wifiLinkStateName(stats.state);
+    doc["rssi"] = stats.rssi;
+    doc["channel"] = stats.channel;
+    doc["connects"] = stats.connects;
+    doc["reconnects"] = stats.reconnects;
+    doc["fastConnects"] = stats.fastConnects;
+    doc["dhcpFallbacks"] = stats.dhcpFallbacks;
+    doc["lastReconnectMs"] = stats.lastReconnectMs;
+    doc["downForMs"] = stats.downForMs;
+    JsonArray hist = doc["reconnectHist"].to<JsonArray>();
+    for (size_t i = 0; i < kWifiReconnectBuckets; ++i) {
+        JsonObject bucket = hist.add<JsonObject>();
+        if (i + 1 < kWifiReconnectBuckets) {
+            bucket["leMs"] = kWifiReconnectBucketMs[i];
+        } else {
+            bucket["leMs"] = nullptr;
+        }
+        bucket["count"] = stats.reconnectHist[i];
+    }
+    String resp;
+    serializeJson(doc, resp);
+    server.send(200, "application/json", resp);
+}
+
+static void handleApiDvfs() {
+    DvfsStats stats{};
+    dvfsGetStats(stats);
+    JsonDocument doc;
+    doc["cpuMhz"] = stats.cpuMhz;
+    doc["wifiPs"] = dvfsPsName(stats.ps);
+    doc["transitions"] = stats.transitions;
+    JsonObject residency = doc["residencyMs"].to<JsonObject>();
+    for (size_t i = 0; i < kDvfsLevels; ++i) {
+        char key[8];
+        snprintf(key, sizeof(key), "%u", (unsigned)kDvfsLevelMhz[i]);
+        residency[key] = stats.residencyMs[i];
+    }
+    doc["estMwhPerHour"] = stats.estMwhPerHour;
+    doc["baselineMwhPerHour"] = stats.baselineMwhPerHour;
+    String resp;
+    serializeJson(doc, resp);
+    server.send(200, "application/json", resp);
+}
+
+static void handleApiLog() {
+    // Too big for the loop task stack
+    static LogEntry entries[kLogSlots];
+    const size_t count = logSnapshot(entries, kLogSlots);
+    LogStats stats{};
+    logGetStats(stats);
+    JsonDocument doc;
+    doc["level"] = logLevelName(LOG_LEVEL);
+    doc["written"] = stats.written;
+    doc["dropped"] = stats.dropped;
+    doc["truncated"] = stats.truncated;
+    doc["avgWriteUs"] = stats.written ? stats.writeUsTotal / stats.written : 0;
+    doc["serialUs"] = stats.serialUsTotal;
+    doc["writeUs"] = stats.writeUsTotal;
+    JsonArray lines = doc["entries"].to<JsonArray>();
+    for (size_t i = 0; i < count; ++i) {
+        JsonObject line = lines.add<JsonObject>();
+        line["ms"] = entries[i].ms;
+        line["level"] = logLevelName(entries[i].level);
+        line["text"] = entries[i].text;
+    }
+    String resp;
+    serializeJson(doc, resp);
+    server.send(200, "application/json", resp);
+}
+
+static void handleApiSys() {
+    if (server.method() == HTTP_POST) {
+        String body = server.arg("plain");
+        JsonDocument req;
+        if (deserializeJson(req, body)) {
+            server.send(400, "application/json", "{\"error\":\"json\"}");
+            return;
+        }
+        sysStatsSetLogInterval(req["logIntervalMs"] | 0);
+    } else if (server.method() != HTTP_GET) {
+        server.send(405, "application/json", "{\"error\":\"method\"}");
+        return;
+    }
+    // Too big for the loop task stack
+    static SysStats stats;
+    sysStatsSample(stats);
+    JsonDocument doc;
+    doc["uptimeMs"] = stats.uptimeMs;
+    doc["windowMs"] = stats.windowMs;
+    doc["logIntervalMs"] = sysStatsLogInterval();
+    JsonObject heap = doc["heap"].to<JsonObject>();
+    heap["free"] = stats.heap.internalFree;
+    heap["largest"] = stats.heap.internalLargest;
+    heap["minFree"] = stats.heap.internalMinFree;
+    heap["dmaFree"] = stats.heap.dmaFree;
+    heap["dmaLargest"] = stats.heap.dmaLargest;
+    heap["psramTotal"] = stats.heap.psramTotal;
+    heap["psramFree"] = stats.heap.psramFree;
+    heap["psramLargest"] = stats.heap.psramLargest;
+    heap["psramMinFree"] = stats.heap.psramMinFree;
+    doc["panelDmaBytes"] = stats.panelDmaBytes;
+    doc["runtimeStats"] = stats.runtimeStats;
+    if (stats.taskStats) {
+        JsonArray tasks = doc["tasks"].to<JsonArray>();
+        for (uint8_t i = 0; i < stats.taskCount; ++i) {
+            const TaskStat& t = stats.tasks[i];
+            JsonObject task = tasks.add<JsonObject>();
+            task["name"] = t.name;
+            task["state"] = sysStatsTaskStateName(t.state);
+            task["priority"] = t.priority;
+            task["stackFree"] = t.stackFreeBytes;
+            if (t.cpuPermille >= 0) {
+                task["cpuPct"] = t.cpuPermille / 10.0f;
+            }
+        }
+    }
+    String resp;
+    serializeJson(doc, resp);
+    server.send(200, "application/json", resp);
+}
+
+static void handleApiTraces() {
+    static NetTrace traces[kNetTraceSlots];
+    const size_t count = netTraceRecent(traces, kNetTraceSlots);
+    JsonDocument doc;
+    JsonArray list = doc["traces"].to<JsonArray>();
+    for (size_t i = 0; i < count; ++i) {
+        const NetTrace& t = traces[i];
+        JsonObject item = list.add<JsonObject>();
+        item["source"] = t.source;
+        item["startMs"] = t.startMs;
+        item["attempt"] = t.attempt + 1;
+        item["code"] = t.httpCode;
+        item["ok"] = t.ok;
+        item["bytes"] = t.bytes;
+        uint32_t totalMs = 0;
+        for (size_t p = 0; p < kNetPhaseCount; ++p) {
+            if (!(t.reached & (1u << p))) continue;
+            item[netPhaseName((NetPhase)p)] = t.phaseMs[p];
+            totalMs += t.phaseMs[p];
+        }
+        item["totalMs"] = totalMs;
+    }
+    JsonObject phases = doc["phases"].to<JsonObject>();
+    for (size_t p = 0; p < kNetPhaseCount; ++p) {
+        const MetricHistogram& hist = netTraceHistogram((NetPhase)p);
+        JsonObject phase = phases[netPhaseName((NetPhase)p)].to<JsonObject>();
+        JsonArray buckets = phase["buckets"].to<JsonArray>();
+        uint32_t n = 0;
+        for (size_t b = 0; b <= hist.boundCount(); ++b) {
+            JsonObject bucket = buckets.add<JsonObject>();
+            if (b < hist.boundCount()) {
+                bucket["le"] = hist.bound(b);
+            } else {
+                bucket["le"] = "inf";
+            }
+            bucket["n"] = hist.bucket(b);
+            n += hist.bucket(b);
+        }
+        phase["count"] = n;
+        phase["sumMs"] = hist.sum();
+    }
+    String resp;
+    serializeJson(doc, resp);
+    server.send(200, "application/json", resp);
+}
+
+static void handleApiHeapTags() {
+    HeapTagStats stats;
+    heapTagGetStats(stats);
+    JsonDocument doc;
+    doc["enabled"] = stats.enabled;
+    if (stats.enabled) {
+        JsonObject tags = doc["tags"].to<JsonObject>();
+        for (size_t i = 1; i < kHeapTagCount; ++i) {
+            JsonObject tag = tags[heapTagName((HeapTag)i)].to<JsonObject>();
+            tag["liveBytes"] = stats.tags[i].liveBytes;
+            tag["peakBytes"] = stats.tags[i].peakBytes;
+            tag["liveCount"] = stats.tags[i].liveCount;
+            tag["allocs"] = stats.tags[i].allocs;
+        }
+        JsonArray sizes = doc["sizes"].to<JsonArray>();
+        for (size_t i = 0; i < kHeapSizeBuckets; ++i) {
+            JsonObject bucket = sizes.add<JsonObject>();
+            const uint32_t limit = heapSizeBucketLimit(i);
+            if (limit) {
+                bucket["le"] = limit;
+            } else {
+                bucket["le"] = "inf";
+            }
+            bucket["n"] = stats.sizeHist[i];
+        }
+        doc["tracked"] = stats.tracked;
+        doc["untracked"] = stats.untracked;
+    }
+    String resp;
+    serializeJson(doc, resp);
+    server.send(200, "application/json", resp);
+}
+
+static void handleApiDebugHud() {
+    if (server.method() == HTTP_POST) {
+        String body = server.arg("plain");
+        JsonDocument req;
+        if (deserializeJson(req, body) || !req["enabled"].is<bool>()) {
+            server.send(400, "application/json", "{\"error\":\"enabled\"}");
+            return;
+        }
+        displaySetDebugHud(req["enabled"].as<bool>());
+    } else if (server.method() != HTTP_GET) {
+        server.send(405, "application/json", "{\"error\":\"method\"}");
+        return;
+    }
+    JsonDocument doc;
+    doc["enabled"] = displayDebugHudEnabled();
+    String resp;
+    serializeJson(doc, resp);
+    server.send(200, "application/json", resp);
+}
+
+static void handleApiMirror() {
+    if (server.method() == HTTP_POST) {
+        String body = server.arg("plain");
+        JsonDocument req;
+        if (deserializeJson(req, body) || !req["maxFps"].is<int>()) {
+            server.send(400, "application/json", "{\"error\":\"maxFps\"}");
+            return;
+        }
+        const int fps = req["maxFps"].as<int>();
+        panelMirrorSetMaxFps((uint8_t)(fps < 0 ? 0 : (fps > 255 ? 255 : fps)));
+    } else if (server.method() != HTTP_GET) {
+        server.send(405, "application/json", "{\"error\":\"method\"}");
+        return;
+    }
+    PanelMirrorStats stats{};
+    panelMirrorGetStats(stats);
+    JsonDocument doc;
+    doc["enabled"] = PANEL_MIRROR != 0;
+    doc["port"] = kPanelMirrorPort;
+    doc["clients"] = stats.clients;
+    doc["maxFps"] = stats.maxFps;
+    doc["framesSent"] = stats.framesSent;
+    doc["keyframes"] = stats.keyframes;
+    doc["bytesSent"] = stats.bytesSent;
+    doc["dropped"] = stats.dropped;
+    doc["sendFailures"] = stats.sendFailures;
+    String resp;
+    serializeJson(doc, resp);
+    server.send(200, "application/json", resp);
+}
+
+static void handleApiMetrics() {
+    // Reused between scrapes so the String keeps its capacity
+    static String resp;
+    resp = "";
+    metricsRender(resp);
+    server.send(200, "text/plain; version=0.0.4", resp);
+}
+
+static void handleApiBoot() {
+    JsonDocument doc;
+    JsonObject phases = doc["phases"].to<JsonObject>();
+    for (uint8_t i = 0; i < (uint8_t)BootPhase::Count; ++i) {
+        const BootPhase phase = (BootPhase)i;
+        if (bootIsDone(phase)) {
+            phases[bootPhaseName(phase)] = bootPhaseMs(phase);
+        } else {
+            phases[bootPhaseName(phase)] = nullptr;
+        }
+    }
+    doc["status"] = bootStatusText();
+    doc["uptimeMs"] = millis();
+    String resp;
+    serializeJson(doc, resp);
+    server.send(200, "application/json", resp);
+}
+
 uint32_t apiServerGetSelectedGameId() {
     return selectedGameId;
 }
 
+void apiServerSelectGame(uint32_t gameId) {
+    selectedGameId = gameId;
+    saveSelectedGameId(gameId);
+    dataModelSetSelectedGame(gameId);
+    Serial.printf("[api] select gameId=%u\n", (unsigned)gameId);
+}
+
 void apiServerInit() {
-    dataModelInit();
-    selectedGameId = 0;
-    saveSelectedGameId(0);
-    dataModelSetSelectedGame(0);
-    Serial.println("[api] selectedGameId reset to 0");
-
-    server.on("/", handleRoot);
-    server.on("/index.html", handleRoot);
+    upstreamHealthInit();
+    // The data model was set up (and possibly warm-started) by displayInit;
+    // a no-op when the restored snapshot is for the same game.
+    loadSelectedGameId();
+    dataModelSetSelectedGame(selectedGameId);
+    Serial.printf("[api] selectedGameId=%u\n", (unsigned)selectedGameId);
+
+    staticAssetsInit(server);
     server.on("/api/select-game", HTTP_POST, handleApiSelectGame);
     server.on("/api/selected-game", HTTP_GET, handleApiSelectedGame);
+    server.on("/api/state", HTTP_GET, handleApiState);
     server.on("/api/display-power", HTTP_ANY, handleApiDisplayPower);
     server.on("/api/preview-goal", HTTP_POST, handleApiPreviewGoal);
+    server.on("/api/off-hours", HTTP_ANY, handleApiOffHours);
+    server.on("/api/upstream", HTTP_GET, handleApiUpstream);
+    server.on("/api/boot", HTTP_GET, handleApiBoot);
+    server.on("/api/wifi", HTTP_GET, handleApiWifi);
+    server.on("/api/dvfs", HTTP_GET, handleApiDvfs);
+    server.on("/api/log", HTTP_GET, handleApiLog);
+    server.on("/api/sys", HTTP_ANY, handleApiSys);
+    server.on("/api/metrics", HTTP_GET, handleApiMetrics);
+    server.on("/api/traces", HTTP_GET, handleApiTraces);
+    server.on("/api/heap-tags", HTTP_GET, handleApiHeapTags);
+    server.on("/api/debug-hud", HTTP_ANY, handleApiDebugHud);
+    server.on("/api/mirror", HTTP_ANY, handleApiMirror);
     server.onNotFound([]() {
         server.send(404, "text/plain", "404");
     });
+    static const char* collectedHeaders[] = {"If-None-Match"};
+    server.collectHeaders(collectedHeaders, 1);
     server.begin();
     Serial.println("Serveur HTTP démarré.");
 
@@ -160,5 +606,8 @@ void apiServerInit() {
 }
 
 void apiServerLoop() {
+    // The server is started from the boot task once WiFi is up
+    if (!bootIsDone(BootPhase::ServicesStarted)) return;
+    HeapTagScope heapTag(HeapTag::Api);
     server.handleClient();
 }
@@ -0,0 +1,13 @@
+#include "backoff.h"
+
+uint32_t backoffJitterMs(uint32_t windowMs, uint32_t random) {
+    if (windowMs < 2) return windowMs;
+    const uint32_t half = windowMs / 2;
+    return half + (random % (half + 1));
+}
+
+uint32_t backoffDelayMs(uint32_t baseMs, int attempt, uint32_t random) {
+    if (attempt < 0) attempt = 0;
+    if (attempt > 6) attempt = 6;
+    return backoffJitterMs(baseMs << attempt, random);
+}
@@ -0,0 +1,172 @@
+#include "boot.h"
+
+#include <WiFi.h>
+#include <LittleFS.h>
+#include <ESPmDNS.h>
+#include <time.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <freertos/task.h>
+
+#include "api_server.h"
+#include "dvfs.h"
+#include "logger.h"
+#include "off_hours.h"
+#include "power_manager.h"
+#include "snapshot_store.h"
+#include "sys_stats.h"
+#include "wifi_link.h"
+#include "display/display_manager.h"
+#include "display/panel_mirror.h"
+
+namespace {
+    constexpr size_t PHASE_COUNT = (size_t)BootPhase::Count;
+    constexpr uint32_t NTP_TIMEOUT_MS = 30000;
+    constexpr uint32_t NTP_LATE_POLL_MS = 1000;
+    constexpr uint32_t BOOT_NET_STACK = 8192;
+    constexpr uint32_t BOOT_NTP_STACK = 3072;
+
+    const char* const PHASE_NAMES[PHASE_COUNT] = {
+        "fs",
+        "display",
+        "snapshot",
+        "firstFrame",
+        "wifi",
+        "ntp",
+        "mdns",
+        "services",
+        "firstLiveData"
+    };
+
+    EventGroupHandle_t bootEvents = nullptr;
+    uint32_t phaseMs[PHASE_COUNT] = {0};
+
+    EventBits_t bitFor(BootPhase phase) {
+        return (EventBits_t)1 << (uint8_t)phase;
+    }
+
+    void bootNtpTask(void*) {
+        bootWaitFor(BootPhase::WifiConnected, portMAX_DELAY);
+        // SNTP keeps retrying on its own; past the timeout this only checks
+        // less often, so TimeSynced (off-hours, snapshot age, lease age)
+        // still lands whenever the time does
+        const uint32_t start = millis();
+        bool late = false;
+        while (time(nullptr) < 100000) {
+            if (!late && millis() - start >= NTP_TIMEOUT_MS) {
+                Serial.println("[boot] NTP en retard - nouvel essai en arrière-plan");
+                late = true;
+            }
+            vTaskDelay(pdMS_TO_TICKS(late ? NTP_LATE_POLL_MS : 100));
+        }
+        time_t now = time(nullptr);
+        Serial.printf("[boot] NTP OK: %s", ctime(&now));
+        bootMark(BootPhase::TimeSynced);
+        vTaskDelete(nullptr);
+    }
+
+    void bootNetTask(void*) {
+        // The link supervisor keeps the connection alive from here on
+        wifiLinkStart();
+        wifiLinkWaitUp(portMAX_DELAY);
+        Serial.print("[boot] WiFi connecté. IP: ");
+        Serial.println(WiFi.localIP());
+        // SNTP runs in the background; bootNtpTask reports when it lands
+        configTime(-5 * 3600, 0, "pool.ntp.org", "time.nist.gov");
+        bootMark(BootPhase::WifiConnected);
+
+        if (MDNS.begin("scoreboardapp")) {
+            MDNS.addService("http", "tcp", 80);
+            Serial.println("[boot] mDNS OK → http://scoreboardapp.local");
+        } else {
+            Serial.println("[boot] mDNS échec");
+        }
+        bootMark(BootPhase::MdnsReady);
+
+        apiServerInit();
+        panelMirrorStart();
+        bootMark(BootPhase::ServicesStarted);
+        vTaskDelete(nullptr);
+    }
+}
+
+void bootStart() {
+    if (!bootEvents) {
+        bootEvents = xEventGroupCreate();
+    }
+    logStart();
+    sysStatsInit();
+
+    if (!LittleFS.begin(true)) {
+        Serial.println("Erreur LittleFS");
+    } else {
+        Serial.println("LittleFS OK");
+        bootMark(BootPhase::FsMounted);
+    }
+
+    // Panel first: the splash is up before WiFi has even started
+    displayInit();
+    dvfsInit();
+    powerManagerInit();
+    offHoursInit();
+    bootMark(BootPhase::DisplayReady);
+
+    // Last known score on the panel while WiFi is still connecting
+    if (snapshotStoreRestore()) {
+        bootMark(BootPhase::SnapshotRestored);
+    }
+    snapshotStoreStart();
+
+    if (xTaskCreate(bootNtpTask, "boot_ntp", BOOT_NTP_STACK, NULL, 1, NULL) != pdPASS) {
+        Serial.println("Warn: boot_ntp task creation failed");
+    }
+    if (xTaskCreate(bootNetTask, "boot_net", BOOT_NET_STACK, NULL, 1, NULL) != pdPASS) {
+        Serial.println("Warn: boot_net task creation failed");
+    }
+}
+
+void bootMark(BootPhase phase) {
+    if (!bootEvents || phase >= BootPhase::Count) return;
+    const EventBits_t bit = bitFor(phase);
+    if (xEventGroupGetBits(bootEvents) & bit) return;
+    phaseMs[(size_t)phase] = millis();
+    xEventGroupSetBits(bootEvents, bit);
+    Serial.printf("[boot] %s +%lums\n", bootPhaseName(phase), (unsigned long)phaseMs[(size_t)phase]);
+
+    if (phase == BootPhase::FirstLiveData) {
+        Serial.print("[boot] summary:");
+        for (size_t i = 0; i < PHASE_COUNT; ++i) {
+            Serial.printf(" %s=%lu", PHASE_NAMES[i], (unsigned long)phaseMs[i]);
+        }
+        Serial.println();
+    }
+}
+
+bool bootIsDone(BootPhase phase) {
+    if (!bootEvents || phase >= BootPhase::Count) return false;
+    return (xEventGroupGetBits(bootEvents) & bitFor(phase)) != 0;
+}
+
+bool bootWaitFor(BootPhase phase, uint32_t timeoutMs) {
+    if (!bootEvents || phase >= BootPhase::Count) return false;
+    const TickType_t ticks = timeoutMs == portMAX_DELAY ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs);
+    const EventBits_t bits = xEventGroupWaitBits(bootEvents, bitFor(phase), pdFALSE, pdTRUE, ticks);
+    return (bits & bitFor(phase)) != 0;
+}
+
+uint32_t bootPhaseMs(BootPhase phase) {
+    if (phase >= BootPhase::Count) return 0;
+    return phaseMs[(size_t)phase];
+}
+
+const char* bootPhaseName(BootPhase phase) {
+    if (phase >= BootPhase::Count) return "?";
+    return PHASE_NAMES[(size_t)phase];
+}
+
+const char* bootStatusText() {
+    if (!bootIsDone(BootPhase::WifiConnected)) return "WIFI";
+    if (!bootIsDone(BootPhase::ServicesStarted)) return "START";
+    if (!bootIsDone(BootPhase::FirstLiveData)) return "LOADING";
+    return "";
+}
@@ -0,0 +1,88 @@
+#include "display/clock_interpolator.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace {
+    constexpr int32_t SNAP_THRESHOLD_MS = 3000;
+    constexpr int32_t CORRECTION_WINDOW_MS = 2000;
+    constexpr int32_t MAX_RATE_SKEW_DIV = 4;
+}
+
+void ClockInterpolator::reset() {
+    synced = false;
+    running = false;
+    sampleTenths = 0;
+    sampleMs = 0;
+    displayMs = 0;
+    lastTickMs = 0;
+    lastErrorMs = 0;
+}
+
+int32_t ClockInterpolator::targetMs(uint32_t nowMs) const {
+    int32_t target = (int32_t)sampleTenths * 100;
+    if (running) {
+        target -= (int32_t)(nowMs - sampleMs);
+    }
+    return target < 0 ? 0 : target;
+}
+
+void ClockInterpolator::sync(uint16_t tenths, bool isRunning, uint32_t observedMs, uint32_t nowMs) {
+    sampleTenths = tenths;
+    running = isRunning;
+    sampleMs = observedMs;
+
+    const int32_t target = targetMs(nowMs);
+    if (!synced) {
+        displayMs = target;
+        lastTickMs = nowMs;
+        lastErrorMs = 0;
+        synced = true;
+        return;
+    }
+
+    // Advance to now before comparing against the new sample
+    displayTenths(nowMs);
+    lastErrorMs = displayMs - target;
+    if (!running || abs(lastErrorMs) > SNAP_THRESHOLD_MS) {
+        displayMs = target;
+    }
+}
+
+uint16_t ClockInterpolator::displayTenths(uint32_t nowMs) {
+    if (!synced) return 0;
+    const int32_t dt = (int32_t)(nowMs - lastTickMs);
+    lastTickMs = nowMs;
+
+    if (running && dt > 0) {
+        // Positive error means the display shows too much time: run faster
+        int32_t adjust = ((displayMs - targetMs(nowMs)) * dt) / CORRECTION_WINDOW_MS;
+        const int32_t maxAdjust = dt / MAX_RATE_SKEW_DIV;
+        if (adjust > maxAdjust) adjust = maxAdjust;
+        if (adjust < -maxAdjust) adjust = -maxAdjust;
+        displayMs -= dt + adjust;
+        if (displayMs < 0) displayMs = 0;
+    }
+    return (uint16_t)(displayMs / 100);
+}
+
+uint16_t parseClockTenths(const char* mmss) {
+    if (!mmss || !mmss[0]) return 0;
+    unsigned mm = 0;
+    unsigned ss = 0;
+    if (sscanf(mmss, "%u:%u", &mm, &ss) != 2) return 0;
+    if (ss > 59 || mm > 99) return 0;
+    return (uint16_t)((mm * 60 + ss) * 10);
+}
+
+void formatClockTenths(uint16_t tenths, char* out, size_t outSize) {
+    if (!out || outSize == 0) return;
+    // Round up like an arena clock: 12:34.5 still reads 12:35
+    const unsigned seconds = (tenths + 9) / 10;
+    snprintf(out, outSize, "%02u:%02u", seconds / 60, seconds % 60);
+}
+
+uint16_t countdownTenths(uint16_t tenthsAtSample, uint16_t clockAtSample, uint16_t clockNow) {
+    const uint16_t elapsed = clockAtSample > clockNow ? (uint16_t)(clockAtSample - clockNow) : 0;
+    return tenthsAtSample > elapsed ? (uint16_t)(tenthsAtSample - elapsed) : 0;
+}
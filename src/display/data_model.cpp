@@ -3,9 +3,13 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 
+#include "display/clock_interpolator.h"
+#include "time_utils.h"
+
 namespace {
     SemaphoreHandle_t dataModelMutex = nullptr;
     GameSnapshot current;
+    volatile uint32_t version = 0;
 
     void copyStr(char* dest, size_t destSize, const char* src) {
         if (!dest || destSize == 0) return;
@@ -14,6 +18,120 @@ namespace {
         dest[destSize - 1] = '\0';
     }
 
+    // The update functions below write through these and only bump the
+    // version when something actually changed, so an identical poll leaves
+    // the version (and the /api/state ETag) where it was.
+    bool setStr(char* dest, size_t destSize, const char* src) {
+        if (!src) src = "";
+        if (strncmp(dest, src, destSize - 1) == 0) return false;
+        copyStr(dest, destSize, src);
+        return true;
+    }
+
+    template <typename T, typename V>
+    bool setVal(T& field, V value) {
+        if (field == (T)value) return false;
+        field = (T)value;
+        return true;
+    }
+
+    // sampleMs is when the response headers arrived, not when the body was
+    // parsed: the interpolator counts down from it, so parse time would
+    // otherwise show up as the clock running behind. The scenes resync on
+    // every new clockFetchMs, so it only moves when the clock text, running
+    // or intermission state does; a poll that repeats the clock keeps the
+    // earlier sample.
+    bool setClock(GameSnapshot& snap, const char* timeRemaining, bool running, bool inIntermission,
+        uint32_t sampleMs) {
+        if (!timeRemaining) timeRemaining = "";
+        if (strncmp(snap.timeRemaining, timeRemaining, sizeof(snap.timeRemaining) - 1) == 0
+            && snap.clockRunning == running && snap.inIntermission == inIntermission) {
+            return false;
+        }
+        copyStr(snap.timeRemaining, sizeof(snap.timeRemaining), timeRemaining);
+        snap.clockTenths = parseClockTenths(timeRemaining);
+        snap.clockRunning = running;
+        snap.inIntermission = inIntermission;
+        snap.clockFetchMs = sampleMs;
+        return true;
+    }
+
+    bool setTeam(TeamInfo& team, uint32_t id, const char* abbrev, const char* name,
+        uint16_t score, uint16_t sog) {
+        bool changed = setVal(team.id, id);
+        changed |= setStr(team.abbrev, sizeof(team.abbrev), abbrev);
+        changed |= setStr(team.name, sizeof(team.name), name);
+        changed |= setVal(team.score, score);
+        changed |= setVal(team.sog, sog);
+        return changed;
+    }
+
+    bool setRecapGoal(RecapGoal& dest, const RecapGoal& src) {
+        bool changed = setVal(dest.eventId, src.eventId);
+        changed |= setStr(dest.teamAbbrev, sizeof(dest.teamAbbrev), src.teamAbbrev);
+        changed |= setStr(dest.scorer, sizeof(dest.scorer), src.scorer);
+        changed |= setStr(dest.assist1, sizeof(dest.assist1), src.assist1);
+        changed |= setStr(dest.assist2, sizeof(dest.assist2), src.assist2);
+        changed |= setStr(dest.timeRemaining, sizeof(dest.timeRemaining), src.timeRemaining);
+        changed |= setVal(dest.period, src.period);
+        return changed;
+    }
+
+    bool setPenalty(PenaltyEntry& dest, const PenaltyEntry& src) {
+        bool changed = setVal(dest.eventId, src.eventId);
+        changed |= setVal(dest.teamId, src.teamId);
+        changed |= setStr(dest.player, sizeof(dest.player), src.player);
+        changed |= setStr(dest.infraction, sizeof(dest.infraction), src.infraction);
+        changed |= setVal(dest.durationMin, src.durationMin);
+        changed |= setVal(dest.remainingTenths, src.remainingTenths);
+        return changed;
+    }
+
+    bool setStats(GameStats& dest, const GameStats& src) {
+        // TeamGameStats has no padding; leaders are compared field by field
+        bool changed = memcmp(&dest.away, &src.away, sizeof(dest.away)) != 0
+            || memcmp(&dest.home, &src.home, sizeof(dest.home)) != 0
+            || dest.leaderCount != src.leaderCount;
+        const size_t count = src.leaderCount < kMaxLeaders ? src.leaderCount : kMaxLeaders;
+        for (size_t i = 0; i < count && !changed; ++i) {
+            const StatLeader& a = dest.leaders[i];
+            const StatLeader& b = src.leaders[i];
+            changed = a.teamId != b.teamId || strncmp(a.name, b.name, sizeof(a.name)) != 0
+                || a.goals != b.goals || a.assists != b.assists;
+        }
+        if (changed) dest = src;
+        return changed;
+    }
+
+    // Start times only change when the schedule moves, so the local labels
+    // are derived here once instead of on every rendered frame.
+    bool setStartTime(GameSnapshot& snap, const char* startTimeUtc, const char* utcOffset) {
+        if (!startTimeUtc) startTimeUtc = "";
+        if (!utcOffset) utcOffset = "";
+        if (strcmp(snap.startTimeUtc, startTimeUtc) == 0 && strcmp(snap.utcOffset, utcOffset) == 0) {
+            return false;
+        }
+        copyStr(snap.startTimeUtc, sizeof(snap.startTimeUtc), startTimeUtc);
+        copyStr(snap.utcOffset, sizeof(snap.utcOffset), utcOffset);
+
+        int64_t startEpoch = 0;
+        if (!parseIsoUtc(startTimeUtc, startEpoch)) {
+            snap.startEpoch = 0;
+            snap.startDayEndEpoch = 0;
+            copyStr(snap.startLabel, sizeof(snap.startLabel), "??:??");
+            copyStr(snap.startDateLabel, sizeof(snap.startDateLabel), "");
+            return true;
+        }
+
+        LocalStartTime local;
+        localStartTime(startEpoch, parseUtcOffsetMinutes(utcOffset), local);
+        snap.startEpoch = startEpoch;
+        snap.startDayEndEpoch = local.dayEndEpoch;
+        copyStr(snap.startLabel, sizeof(snap.startLabel), local.label);
+        copyStr(snap.startDateLabel, sizeof(snap.startDateLabel), local.dateLabel);
+        return true;
+    }
+
     void clearTeam(TeamInfo& team) {
         team.id = 0;
         copyStr(team.abbrev, sizeof(team.abbrev), "");
@@ -27,11 +145,18 @@ namespace {
         copyStr(snap.gameState, sizeof(snap.gameState), "");
         copyStr(snap.startTimeUtc, sizeof(snap.startTimeUtc), "");
         copyStr(snap.utcOffset, sizeof(snap.utcOffset), "");
+        snap.startEpoch = 0;
+        snap.startDayEndEpoch = 0;
+        copyStr(snap.startLabel, sizeof(snap.startLabel), "??:??");
+        copyStr(snap.startDateLabel, sizeof(snap.startDateLabel), "");
         clearTeam(snap.away);
         clearTeam(snap.home);
         snap.period = 0;
         copyStr(snap.timeRemaining, sizeof(snap.timeRemaining), "");
         snap.inIntermission = false;
+        snap.clockTenths = 0;
+        snap.clockRunning = false;
+        snap.clockFetchMs = 0;
         snap.goalIsNew = false;
         snap.goalEventId = 0;
         snap.goalOwnerTeamId = 0;
@@ -42,6 +167,9 @@ namespace {
         snap.goalPeriod = 0;
         snap.awayPP = false;
         snap.homePP = false;
+        snap.ppTenths = 0;
+        snap.penaltyCount = 0;
+        memset(snap.penalties, 0, sizeof(snap.penalties));
         snap.recapReady = false;
         copyStr(snap.recapText, sizeof(snap.recapText), "");
         snap.recapGoalCount = 0;
@@ -54,6 +182,7 @@ namespace {
             copyStr(snap.recapGoals[i].timeRemaining, sizeof(snap.recapGoals[i].timeRemaining), "");
             snap.recapGoals[i].period = 0;
         }
+        memset(&snap.stats, 0, sizeof(snap.stats));
     }
 }
 
@@ -64,6 +193,7 @@ void dataModelInit() {
     if (dataModelMutex) {
         xSemaphoreTake(dataModelMutex, portMAX_DELAY);
         clearSnapshot(current);
+        version++;
         xSemaphoreGive(dataModelMutex);
     }
 }
@@ -74,6 +204,7 @@ void dataModelSetSelectedGame(uint32_t gameId) {
     if (current.gameId != gameId) {
         clearSnapshot(current);
         current.gameId = gameId;
+        version++;
     }
     xSemaphoreGive(dataModelMutex);
 }
@@ -88,26 +219,27 @@ void dataModelUpdateFromScheduleGame(JsonObjectConst game) {
         xSemaphoreGive(dataModelMutex);
         return;
     }
-    copyStr(current.gameState, sizeof(current.gameState), game["gameState"] | "");
+    bool changed = setStr(current.gameState, sizeof(current.gameState), game["gameState"] | "");
 
     JsonObjectConst away = game["away"];
     JsonObjectConst home = game["home"];
-    copyStr(current.away.abbrev, sizeof(current.away.abbrev), away["abbrev"] | "");
-    copyStr(current.away.name, sizeof(current.away.name), away["name"] | "");
-    current.away.score = away["score"] | 0;
-    current.away.sog = away["sog"] | 0;
+    changed |= setStr(current.away.abbrev, sizeof(current.away.abbrev), away["abbrev"] | "");
+    changed |= setStr(current.away.name, sizeof(current.away.name), away["name"] | "");
+    changed |= setVal(current.away.score, away["score"] | 0);
+    changed |= setVal(current.away.sog, away["sog"] | 0);
 
-    copyStr(current.home.abbrev, sizeof(current.home.abbrev), home["abbrev"] | "");
-    copyStr(current.home.name, sizeof(current.home.name), home["name"] | "");
-    current.home.score = home["score"] | 0;
-    current.home.sog = home["sog"] | 0;
+    changed |= setStr(current.home.abbrev, sizeof(current.home.abbrev), home["abbrev"] | "");
+    changed |= setStr(current.home.name, sizeof(current.home.name), home["name"] | "");
+    changed |= setVal(current.home.score, home["score"] | 0);
+    changed |= setVal(current.home.sog, home["sog"] | 0);
 
-    current.period = game["period"] | 0;
+    changed |= setVal(current.period, game["period"] | 0);
     if (!game["clock"].isNull()) {
         JsonObjectConst clock = game["clock"];
-        copyStr(current.timeRemaining, sizeof(current.timeRemaining), clock["timeRemaining"] | "");
-        current.inIntermission = clock["inIntermission"] | false;
+        changed |= setClock(current, clock["timeRemaining"] | "", clock["running"] | false,
+            clock["inIntermission"] | false, millis());
     }
+    if (changed) version++;
     xSemaphoreGive(dataModelMutex);
 }
 
@@ -118,6 +250,8 @@ void dataModelUpdateFromPbp(uint32_t gameId,
     uint8_t period,
     const char* timeRemaining,
     bool inIntermission,
+    bool clockRunning,
+    uint32_t clockSampleMs,
     uint32_t awayId,
     const char* awayAbbrev,
     const char* awayName,
@@ -148,57 +282,105 @@ void dataModelUpdateFromPbp(uint32_t gameId,
         xSemaphoreGive(dataModelMutex);
         return;
     }
-    copyStr(current.gameState, sizeof(current.gameState), gameState);
-    copyStr(current.startTimeUtc, sizeof(current.startTimeUtc), startTimeUtc);
-    copyStr(current.utcOffset, sizeof(current.utcOffset), utcOffset);
-    current.period = period;
-    copyStr(current.timeRemaining, sizeof(current.timeRemaining), timeRemaining);
-    current.inIntermission = inIntermission;
-    current.away.id = awayId;
-    copyStr(current.away.abbrev, sizeof(current.away.abbrev), awayAbbrev);
-    copyStr(current.away.name, sizeof(current.away.name), awayName);
-    current.away.score = awayScore;
-    current.away.sog = awaySog;
-    current.home.id = homeId;
-    copyStr(current.home.abbrev, sizeof(current.home.abbrev), homeAbbrev);
-    copyStr(current.home.name, sizeof(current.home.name), homeName);
-    current.home.score = homeScore;
-    current.home.sog = homeSog;
+    bool changed = setStr(current.gameState, sizeof(current.gameState), gameState);
+    changed |= setStartTime(current, startTimeUtc, utcOffset);
+    changed |= setVal(current.period, period);
+    changed |= setClock(current, timeRemaining, clockRunning, inIntermission, clockSampleMs);
+    changed |= setTeam(current.away, awayId, awayAbbrev, awayName, awayScore, awaySog);
+    changed |= setTeam(current.home, homeId, homeAbbrev, homeName, homeScore, homeSog);
     // Only SET goalIsNew, never clear it — only the display thread clears it
     // via dataModelClearGoalFlag(). This prevents a subsequent fetch from
     // overwriting goalIsNew=true before the display thread reads it.
     if (goalIsNew) {
-        current.goalIsNew = true;
-        current.goalEventId = goalEventId;
-        current.goalOwnerTeamId = goalOwnerTeamId;
-        copyStr(current.goalScorer, sizeof(current.goalScorer), goalScorer);
-        copyStr(current.goalAssist1, sizeof(current.goalAssist1), goalAssist1);
-        copyStr(current.goalAssist2, sizeof(current.goalAssist2), goalAssist2);
-        copyStr(current.goalTime, sizeof(current.goalTime), goalTime);
-        current.goalPeriod = goalPeriod;
-    }
-    current.awayPP = awayPP;
-    current.homePP = homePP;
-    current.recapReady = recapReady;
-    copyStr(current.recapText, sizeof(current.recapText), recapText);
-    if (recapGoals && recapGoalCount > 0) {
-        if (recapGoalCount > kMaxRecapGoals) recapGoalCount = kMaxRecapGoals;
-        current.recapGoalCount = recapGoalCount;
-        for (size_t i = 0; i < recapGoalCount; ++i) {
-            current.recapGoals[i].eventId = recapGoals[i].eventId;
-            copyStr(current.recapGoals[i].teamAbbrev, sizeof(current.recapGoals[i].teamAbbrev), recapGoals[i].teamAbbrev);
-            copyStr(current.recapGoals[i].scorer, sizeof(current.recapGoals[i].scorer), recapGoals[i].scorer);
-            copyStr(current.recapGoals[i].assist1, sizeof(current.recapGoals[i].assist1), recapGoals[i].assist1);
-            copyStr(current.recapGoals[i].assist2, sizeof(current.recapGoals[i].assist2), recapGoals[i].assist2);
-            copyStr(current.recapGoals[i].timeRemaining, sizeof(current.recapGoals[i].timeRemaining), recapGoals[i].timeRemaining);
-            current.recapGoals[i].period = recapGoals[i].period;
-        }
-    } else {
-        current.recapGoalCount = 0;
+        changed |= setVal(current.goalIsNew, true);
+        changed |= setVal(current.goalEventId, goalEventId);
+        changed |= setVal(current.goalOwnerTeamId, goalOwnerTeamId);
+        changed |= setStr(current.goalScorer, sizeof(current.goalScorer), goalScorer);
+        changed |= setStr(current.goalAssist1, sizeof(current.goalAssist1), goalAssist1);
+        changed |= setStr(current.goalAssist2, sizeof(current.goalAssist2), goalAssist2);
+        changed |= setStr(current.goalTime, sizeof(current.goalTime), goalTime);
+        changed |= setVal(current.goalPeriod, goalPeriod);
+    }
+    changed |= setVal(current.awayPP, awayPP);
+    changed |= setVal(current.homePP, homePP);
+    changed |= setVal(current.recapReady, recapReady);
+    changed |= setStr(current.recapText, sizeof(current.recapText), recapText);
+    if (!recapGoals) recapGoalCount = 0;
+    if (recapGoalCount > kMaxRecapGoals) recapGoalCount = kMaxRecapGoals;
+    changed |= setVal(current.recapGoalCount, recapGoalCount);
+    for (size_t i = 0; i < recapGoalCount; ++i) {
+        changed |= setRecapGoal(current.recapGoals[i], recapGoals[i]);
     }
+    if (changed) version++;
     xSemaphoreGive(dataModelMutex);
 }
 
+void dataModelUpdatePenalties(uint32_t gameId,
+    uint16_t ppTenths,
+    const PenaltyEntry* penalties,
+    uint8_t penaltyCount) {
+    if (!dataModelMutex || gameId == 0) return;
+    xSemaphoreTake(dataModelMutex, portMAX_DELAY);
+    if (current.gameId != gameId) {
+        xSemaphoreGive(dataModelMutex);
+        return;
+    }
+    if (!penalties) penaltyCount = 0;
+    if (penaltyCount > kMaxPenalties) penaltyCount = kMaxPenalties;
+    bool changed = setVal(current.ppTenths, ppTenths);
+    changed |= setVal(current.penaltyCount, penaltyCount);
+    for (size_t i = 0; i < penaltyCount; ++i) {
+        changed |= setPenalty(current.penalties[i], penalties[i]);
+    }
+    if (changed) version++;
+    xSemaphoreGive(dataModelMutex);
+}
+
+void dataModelUpdateGoalDetails(uint32_t gameId,
+    uint32_t goalEventId,
+    const char* goalScorer,
+    const char* goalAssist1,
+    const char* goalAssist2) {
+    if (!dataModelMutex || gameId == 0) return;
+    xSemaphoreTake(dataModelMutex, portMAX_DELAY);
+    if (current.gameId == gameId && current.goalEventId == goalEventId) {
+        bool changed = setStr(current.goalScorer, sizeof(current.goalScorer), goalScorer);
+        changed |= setStr(current.goalAssist1, sizeof(current.goalAssist1), goalAssist1);
+        changed |= setStr(current.goalAssist2, sizeof(current.goalAssist2), goalAssist2);
+        if (changed) version++;
+    }
+    xSemaphoreGive(dataModelMutex);
+}
+
+void dataModelUpdateStats(uint32_t gameId, const GameStats& stats) {
+    if (!dataModelMutex || gameId == 0) return;
+    xSemaphoreTake(dataModelMutex, portMAX_DELAY);
+    if (current.gameId == gameId && setStats(current.stats, stats)) {
+        version++;
+    }
+    xSemaphoreGive(dataModelMutex);
+}
+
+void dataModelRestore(const GameSnapshot& saved) {
+    if (!dataModelMutex || saved.gameId == 0) return;
+    xSemaphoreTake(dataModelMutex, portMAX_DELAY);
+    clearSnapshot(current);
+    current.gameId = saved.gameId;
+    copyStr(current.gameState, sizeof(current.gameState), saved.gameState);
+    setStartTime(current, saved.startTimeUtc, saved.utcOffset);
+    current.away = saved.away;
+    current.home = saved.home;
+    current.period = saved.period;
+    // Shown frozen until the first poll says whether it is running
+    setClock(current, saved.timeRemaining, false, saved.inIntermission, millis());
+    version++;
+    xSemaphoreGive(dataModelMutex);
+}
+
+uint32_t dataModelGetVersion() {
+    return version;
+}
+
 bool dataModelGetSnapshot(GameSnapshot& out) {
     if (!dataModelMutex) return false;
     xSemaphoreTake(dataModelMutex, portMAX_DELAY);
@@ -210,6 +392,7 @@ bool dataModelGetSnapshot(GameSnapshot& out) {
 void dataModelClearGoalFlag() {
     if (!dataModelMutex) return;
     xSemaphoreTake(dataModelMutex, portMAX_DELAY);
+    // Display-side bookkeeping, not new data: no version bump
     current.goalIsNew = false;
     xSemaphoreGive(dataModelMutex);
 }
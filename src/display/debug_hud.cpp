@@ -0,0 +1,104 @@
+#include "display/debug_hud.h"
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_heap_caps.h>
+
+#include "display/goal_assets.h"
+#include "upstream_health.h"
+#include "wifi_link.h"
+
+namespace {
+    constexpr uint32_t SAMPLE_MS = 500;
+    constexpr int LINE_PITCH = 6;
+
+    void drawMiniText(MatrixPanel_I2S_DMA& display, int x, int y, const char* text, uint16_t color) {
+        if (!text) return;
+        for (size_t i = 0; text[i]; ++i) {
+            const MiniGlyph* g = getMiniGlyph(text[i]);
+            for (int row = 0; row < 5; ++row) {
+                for (int col = 0; col < 3; ++col) {
+                    if (g->rows[row] & (1 << (2 - col))) {
+                        display.drawPixel(x + (int)i * 4 + col, y + row, color);
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool DebugHud::Values::operator==(const Values& other) const {
+    return fps == other.fps && frameTenthsMs == other.frameTenthsMs && heapKb == other.heapKb &&
+        okAgeS == other.okAgeS && failures == other.failures && rssi == other.rssi &&
+        pollS == other.pollS;
+}
+
+void DebugHud::reset() {
+    formatted = false;
+    lastSampleMs = 0;
+    windowStartMs = 0;
+    windowFrames = 0;
+}
+
+void DebugHud::noteFrame(uint32_t frameUs, uint32_t nowMs) {
+    lastFrameUs = frameUs;
+    if (windowStartMs == 0) windowStartMs = nowMs;
+    windowFrames++;
+}
+
+void DebugHud::sample(uint32_t nowMs) {
+    const uint32_t windowMs = nowMs - windowStartMs;
+    if (windowStartMs != 0 && windowMs > 0) {
+        values.fps = (uint16_t)((windowFrames * 1000u + windowMs / 2) / windowMs);
+    }
+    windowStartMs = nowMs;
+    windowFrames = 0;
+
+    const uint32_t tenths = (lastFrameUs + 50) / 100;
+    values.frameTenthsMs = (uint16_t)(tenths > 999 ? 999 : tenths);
+    values.heapKb = (uint16_t)(heap_caps_get_free_size(MALLOC_CAP_8BIT) / 1024);
+
+    UpstreamHealthStats upstream{};
+    upstreamGetStats(upstream);
+    values.okAgeS = upstream.lastSuccessMs ? (nowMs - upstream.lastSuccessMs) / 1000 : UINT32_MAX;
+    values.failures = upstream.totalFailures;
+    values.pollS = (upstream.successIntervalMs + 500) / 1000;
+    values.rssi = wifiLinkIsUp() ? (int16_t)WiFi.RSSI() : 0;
+}
+
+void DebugHud::format() {
+    snprintf(lines[0], sizeof(lines[0]), "FPS %u %u.%uMS",
+        (unsigned)values.fps, (unsigned)(values.frameTenthsMs / 10), (unsigned)(values.frameTenthsMs % 10));
+    snprintf(lines[1], sizeof(lines[1]), "HEAP %uK", (unsigned)values.heapKb);
+    if (values.okAgeS == UINT32_MAX) {
+        snprintf(lines[2], sizeof(lines[2]), "OK -- ERR %lu", (unsigned long)values.failures);
+    } else if (values.okAgeS < 600) {
+        snprintf(lines[2], sizeof(lines[2]), "OK %luS ERR %lu",
+            (unsigned long)values.okAgeS, (unsigned long)values.failures);
+    } else {
+        snprintf(lines[2], sizeof(lines[2]), "OK %luM ERR %lu",
+            (unsigned long)(values.okAgeS / 60), (unsigned long)values.failures);
+    }
+    if (values.rssi != 0) {
+        snprintf(lines[3], sizeof(lines[3]), "RSSI %d", (int)values.rssi);
+    } else {
+        snprintf(lines[3], sizeof(lines[3]), "RSSI --");
+    }
+    snprintf(lines[4], sizeof(lines[4]), "POLL %luS", (unsigned long)values.pollS);
+    shown = values;
+    formatted = true;
+}
+
+void DebugHud::render(MatrixPanel_I2S_DMA& display, const GameSnapshot&, uint32_t nowMs) {
+    if (lastSampleMs == 0 || nowMs - lastSampleMs >= SAMPLE_MS) {
+        lastSampleMs = nowMs;
+        sample(nowMs);
+        if (!formatted || !(values == shown)) format();
+    }
+
+    display.clearScreen();
+    const uint16_t color = display.color565(140, 220, 160);
+    for (int i = 0; i < kLines; ++i) {
+        drawMiniText(display, 1, 1 + i * LINE_PITCH, lines[i], color);
+    }
+}
@@ -1,11 +1,21 @@
 #include "display/display_manager.h"
 
 #include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include <esp_heap_caps.h>
 
+#include "boot.h"
+#include "dvfs.h"
+#include "heap_tag.h"
+#include "metrics.h"
 #include "display/data_model.h"
+#include "display/debug_hud.h"
+#include "display/goal_assets.h"
 #include "display/goal_scene.h"
+#include "display/heatmap_scene.h"
 #include "display/hub75_pins.h"
 #include "display/logo_cache.h"
+#include "display/mirrored_panel.h"
+#include "display/penalty_scene.h"
 #include "display/recap_scene.h"
 #include "display/scoreboard_scene.h"
 
@@ -18,17 +28,46 @@ namespace {
     constexpr uint32_t FRAME_INTERVAL_MS = 33;
     constexpr uint8_t DEFAULT_BRIGHTNESS = 50;
 
-    MatrixPanel_I2S_DMA* matrix = nullptr;
+    MirroredPanel* matrix = nullptr;
+    size_t panelDmaBytes = 0;
     ScoreboardScene scene;
     GoalScene goalScene;
     RecapScene recapScene;
+    PenaltyScene penaltyScene;
+    HeatmapScene heatmapScene;
+    DebugHud debugHud;
     uint32_t lastFrameMs = 0;
     bool displayReady = false;
     bool displayEnabled = true;
     bool previewActive = false;
+    bool hudEnabled = false;
+    uint32_t lastFrameUs = 0;
     GameSnapshot previewSnapshot{};
     GameSnapshot goalAnimSnapshot{};
     char lastGoalKey[64] = {0};
+
+    const uint32_t FRAME_US_BOUNDS[] = {500, 1000, 2000, 4000, 8000, 16000, 33000};
+    MetricCounter framesTotal("scoreboard_frames_total", "Frames rendered");
+    MetricCounter framesLate("scoreboard_frames_late_total",
+        "Frames that started more than two frame intervals after the previous one");
+    MetricHistogram frameRenderUs("scoreboard_frame_render_us",
+        "Time spent building one frame", FRAME_US_BOUNDS, 7);
+
+    // Hands the finished frame to the panel mirror on every exit path
+    struct FramePublisher {
+        ~FramePublisher() {
+            if (matrix) matrix->endFrame();
+        }
+    };
+
+    // displayTick() has a return per scene; time all of them in one place
+    struct FrameTimer {
+        uint32_t startUs = micros();
+        ~FrameTimer() {
+            lastFrameUs = micros() - startUs;
+            frameRenderUs.observe(lastFrameUs);
+        }
+    };
     bool goalAnimActive = false;
     uint32_t goalAnimStartMs = 0;
     uint32_t lastGameId = 0;
@@ -41,6 +80,18 @@ namespace {
     uint32_t recapModeStartMs = 0;
     constexpr uint32_t STANDARD_MS = 20000;
 
+    // Secondary views that alternate with the scoreboard while they apply:
+    // the penalty box during a power play, the shot heatmap in intermission
+    struct AltCycle {
+        uint32_t scoreboardMs;
+        uint32_t altMs;
+        bool active;
+        uint32_t startMs;
+    };
+    AltCycle ppCycle = {10000, 6000, false, 0};
+    AltCycle heatmapCycle = {12000, 8000, false, 0};
+    AltCycle hudCycle = {10000, 5000, false, 0};
+
     void copyStr(char* dest, size_t destSize, const char* src) {
         if (!dest || destSize == 0) return;
         if (!src) src = "";
@@ -77,6 +128,66 @@ namespace {
         return (strcasecmp(state, "FINAL") == 0) || (strcasecmp(state, "OFF") == 0);
     }
 
+    // Boot progress under the NHL logo until live data arrives
+    void drawBootStatus(MatrixPanel_I2S_DMA& display, const char* text) {
+        if (!text || !text[0]) return;
+        const int width = (int)strlen(text) * 4 - 1;
+        const int x = (display.width() - width) / 2;
+        const int y = display.height() - 6;
+        display.fillRect(0, y - 1, display.width(), 7, 0);
+        for (size_t i = 0; text[i]; ++i) {
+            const MiniGlyph* g = getMiniGlyph(text[i]);
+            for (int row = 0; row < 5; ++row) {
+                for (int col = 0; col < 3; ++col) {
+                    if (g->rows[row] & (1 << (2 - col))) {
+                        display.drawPixel(x + (int)i * 4 + col, y + row, display.color565(140, 160, 200));
+                    }
+                }
+            }
+        }
+    }
+
+    bool isLiveState(const char* state) {
+        if (!state || !state[0]) return false;
+        return (strcasecmp(state, "LIVE") == 0) || (strcasecmp(state, "CRIT") == 0);
+    }
+
+    void createMatrix() {
+        HUB75_I2S_CFG::i2s_pins pins = {
+            HUB75_R1_PIN, HUB75_G1_PIN, HUB75_B1_PIN,
+            HUB75_R2_PIN, HUB75_G2_PIN, HUB75_B2_PIN,
+            HUB75_A_PIN, HUB75_B_PIN, HUB75_C_PIN, HUB75_D_PIN, HUB75_E_PIN,
+            HUB75_LAT_PIN, HUB75_OE_PIN, HUB75_CLK_PIN
+        };
+
+        HUB75_I2S_CFG config(PANEL_RES_X, PANEL_RES_Y, PANEL_CHAIN, pins);
+        config.double_buff = true;
+        config.clkphase = false;
+
+        // The driver allocates its frame buffers and descriptors in begin()
+        const size_t dmaBefore = heap_caps_get_free_size(MALLOC_CAP_DMA);
+        matrix = new MirroredPanel(config);
+        matrix->begin();
+        const size_t dmaAfter = heap_caps_get_free_size(MALLOC_CAP_DMA);
+        panelDmaBytes = dmaBefore > dmaAfter ? dmaBefore - dmaAfter : 0;
+        matrix->setBrightness8(displayEnabled ? DEFAULT_BRIGHTNESS : 0);
+        matrix->setLatBlanking(3);
+        matrix->clearScreen();
+    }
+
+    // True while the cycle is in its secondary-view phase
+    bool altPhase(AltCycle& cycle, bool applies, uint32_t nowMs) {
+        if (!applies) {
+            cycle.active = false;
+            return false;
+        }
+        if (!cycle.active) {
+            cycle.active = true;
+            cycle.startMs = nowMs;
+        }
+        return (nowMs - cycle.startMs) % (cycle.scoreboardMs + cycle.altMs) >= cycle.scoreboardMs;
+    }
+
 }
 
 void displayInit() {
@@ -84,38 +195,55 @@ void displayInit() {
 
     dataModelInit();
     logoCacheInit();
-
-    HUB75_I2S_CFG::i2s_pins pins = {
-        HUB75_R1_PIN, HUB75_G1_PIN, HUB75_B1_PIN,
-        HUB75_R2_PIN, HUB75_G2_PIN, HUB75_B2_PIN,
-        HUB75_A_PIN, HUB75_B_PIN, HUB75_C_PIN, HUB75_D_PIN, HUB75_E_PIN,
-        HUB75_LAT_PIN, HUB75_OE_PIN, HUB75_CLK_PIN
-    };
-
-    HUB75_I2S_CFG config(PANEL_RES_X, PANEL_RES_Y, PANEL_CHAIN, pins);
-    config.double_buff = true;
-    config.clkphase = false;
-
-    matrix = new MatrixPanel_I2S_DMA(config);
-    matrix->begin();
-    matrix->setBrightness8(displayEnabled ? DEFAULT_BRIGHTNESS : 0);
-    matrix->setLatBlanking(3);
-    matrix->clearScreen();
+    createMatrix();
     displayReady = true;
     Serial.println("[display] init ok");
 }
 
-void displaySetEnabled(bool enabled) {
+void displaySetEnabled(bool enabled, bool releasePanel) {
+    // A panel already dark (turned off from the UI) still has to give up
+    // its DMA buffers when standby asks for them
+    const bool releaseDark = !enabled && !displayEnabled && releasePanel && matrix;
+    if (enabled == displayEnabled && !releaseDark) return;
     displayEnabled = enabled;
-    if (!displayReady || !matrix) return;
+    if (!displayReady) return;
     if (displayEnabled) {
+        if (!matrix) {
+            createMatrix();
+        }
         matrix->setBrightness8(DEFAULT_BRIGHTNESS);
-    } else {
-        matrix->setBrightness8(0);
-        matrix->clearScreen();
+        // A goal scored while dark is old news by now
+        dataModelClearGoalFlag();
+        goalAnimActive = false;
+        previewActive = false;
+        lastFrameMs = 0;
+        return;
+    }
+    if (!matrix) return;
+    matrix->setBrightness8(0);
+    matrix->clearScreen();
+    if (releasePanel) {
+        // Deleting the panel stops the DMA refresh and frees its buffers;
+        // it is rebuilt from scratch on wake
+        delete matrix;
+        matrix = nullptr;
+        panelDmaBytes = 0;
     }
 }
 
+void displaySetDebugHud(bool enabled) {
+    if (enabled && !hudEnabled) debugHud.reset();
+    hudEnabled = enabled;
+}
+
+bool displayDebugHudEnabled() {
+    return hudEnabled;
+}
+
+size_t displayDmaBytes() {
+    return panelDmaBytes;
+}
+
 bool displayIsEnabled() {
     return displayEnabled;
 }
@@ -142,9 +270,19 @@ void displayTick() {
     if (!displayEnabled) return;
     uint32_t now = millis();
     if (now - lastFrameMs < FRAME_INTERVAL_MS) return;
+    if (lastFrameMs != 0 && now - lastFrameMs >= 2 * FRAME_INTERVAL_MS) {
+        framesLate.inc();
+    }
     lastFrameMs = now;
+    framesTotal.inc();
+    // Declared first so it runs after the timer stops
+    FramePublisher framePublisher;
+    FrameTimer frameTimer;
+    HeapTagScope heapTag(HeapTag::Display);
+    if (hudEnabled) debugHud.noteFrame(lastFrameUs, now);
 
     matrix->flipDMABuffer();
+    matrix->beginFrame();
 
     GameSnapshot snapshot{};
     dataModelGetSnapshot(snapshot);
@@ -164,10 +302,22 @@ void displayTick() {
             dataModelClearGoalFlag();
         }
     }
+    if (goalAnimActive && !previewActive && snapshot.goalEventId == goalAnimSnapshot.goalEventId) {
+        // Follow-up polls may fill in assists while the animation runs
+        copyStr(goalAnimSnapshot.goalScorer, sizeof(goalAnimSnapshot.goalScorer), snapshot.goalScorer);
+        copyStr(goalAnimSnapshot.goalAssist1, sizeof(goalAnimSnapshot.goalAssist1), snapshot.goalAssist1);
+        copyStr(goalAnimSnapshot.goalAssist2, sizeof(goalAnimSnapshot.goalAssist2), snapshot.goalAssist2);
+    }
+    // The goal sequence is the only scene that needs the full clock
+    dvfsSetAnimating(goalAnimActive);
     if (goalAnimActive) {
         renderGoalOverlay(*matrix, snapshot, now);
         return;
     }
+    if (altPhase(hudCycle, hudEnabled, now)) {
+        debugHud.render(*matrix, snapshot, now);
+        return;
+    }
 
     const bool finalState = isFinalState(snapshot.gameState);
     const bool recapAvailable = snapshot.recapReady;
@@ -195,6 +345,20 @@ void displayTick() {
 
     recapMode = RecapMode::Standard;
     recapModeStartMs = now;
+
+    if (altPhase(ppCycle, PenaltyScene::hasContent(snapshot), now)) {
+        penaltyScene.render(*matrix, snapshot, now);
+        return;
+    }
+    const bool intermission = isLiveState(snapshot.gameState) && snapshot.inIntermission;
+    if (altPhase(heatmapCycle, intermission && HeatmapScene::hasContent(snapshot), now)) {
+        heatmapScene.render(*matrix, snapshot, now);
+        return;
+    }
     scene.render(*matrix, snapshot, now);
+    if (snapshot.gameId == 0) {
+        drawBootStatus(*matrix, bootStatusText());
+    }
+    bootMark(BootPhase::FirstFrame);
 }
 
@@ -6,6 +6,7 @@ namespace {
     const MiniGlyph kMiniFont[] = {
         {' ', {0b000, 0b000, 0b000, 0b000, 0b000}},
         {'-', {0b000, 0b000, 0b111, 0b000, 0b000}},
+        {'.', {0b000, 0b000, 0b000, 0b000, 0b010}},
         {':', {0b000, 0b010, 0b000, 0b010, 0b000}},
         {'0', {0b111, 0b101, 0b101, 0b101, 0b111}},
         {'1', {0b010, 0b110, 0b010, 0b010, 0b111}},
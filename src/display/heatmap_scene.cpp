@@ -0,0 +1,179 @@
+#include "display/heatmap_scene.h"
+
+#include <Arduino.h>
+
+#include "display/goal_assets.h"
+#include "display/logo_cache.h"
+
+namespace {
+    constexpr uint32_t COLOR_RETRY_MS = 2000;
+    constexpr int CELL_W = HeatmapScene::kWidth / kHeatCols;
+    constexpr int CELL_H = HeatmapScene::kHeight / kHeatRows;
+
+    // Rink markings in panel columns (200 ft over 64 px)
+    constexpr int CENTER_X = 31;
+    constexpr int BLUE_LINE_LEFT_X = 23;
+    constexpr int BLUE_LINE_RIGHT_X = 40;
+    constexpr int GOAL_LINE_LEFT_X = 3;
+    constexpr int GOAL_LINE_RIGHT_X = 60;
+
+    int miniTextWidth(const char* s) {
+        if (!s || !s[0]) return 0;
+        return (int)strlen(s) * 4 - 1;
+    }
+
+    void drawMiniText(MatrixPanel_I2S_DMA& display, int x, int y, const char* text, uint16_t color) {
+        if (!text) return;
+        for (size_t i = 0; text[i]; ++i) {
+            const MiniGlyph* g = getMiniGlyph(text[i]);
+            for (int row = 0; row < 5; ++row) {
+                for (int col = 0; col < 3; ++col) {
+                    if (g->rows[row] & (1 << (2 - col))) {
+                        display.drawPixel(x + (int)i * 4 + col, y + row, color);
+                    }
+                }
+            }
+        }
+    }
+
+    void unpack565(uint16_t c, uint8_t& r, uint8_t& g, uint8_t& b) {
+        r = (uint8_t)(((c >> 11) & 0x1F) * 255 / 31);
+        g = (uint8_t)(((c >> 5) & 0x3F) * 255 / 63);
+        b = (uint8_t)((c & 0x1F) * 255 / 31);
+    }
+
+    uint16_t pack565(uint8_t r, uint8_t g, uint8_t b) {
+        return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+    }
+
+    // Most common saturated color of a logo; near-black, near-white and
+    // grey pixels are skipped so the result reads as the team color.
+    bool dominantLogoColor(const char* abbrev, uint16_t& out) {
+        LogoBitmap logo{};
+        if (!abbrev || !abbrev[0] || !logoCacheGet(abbrev, logo) || !logo.pixels) return false;
+
+        constexpr int kMax = 8;
+        uint16_t colors[kMax];
+        uint16_t counts[kMax];
+        int unique = 0;
+        const int total = logo.width * logo.height;
+        for (int i = 0; i < total; ++i) {
+            uint8_t r, g, b;
+            unpack565(logo.pixels[i], r, g, b);
+            const uint8_t hi = max(r, max(g, b));
+            const uint8_t lo = min(r, min(g, b));
+            if (hi < 60 || hi - lo < 50) continue;
+            const uint16_t key = logo.pixels[i] & 0xE71C;  // merge near-identical shades
+            int slot = -1;
+            for (int j = 0; j < unique; ++j) {
+                if (colors[j] == key) {
+                    slot = j;
+                    break;
+                }
+            }
+            if (slot < 0) {
+                if (unique == kMax) continue;
+                slot = unique++;
+                colors[slot] = key;
+                counts[slot] = 0;
+            }
+            if (counts[slot] < 0xFFFF) counts[slot]++;
+        }
+        if (unique == 0) return false;
+        int best = 0;
+        for (int j = 1; j < unique; ++j) {
+            if (counts[j] > counts[best]) best = j;
+        }
+        out = colors[best];
+        return true;
+    }
+
+    uint16_t scaleColor(uint16_t c, uint8_t level) {
+        uint8_t r, g, b;
+        unpack565(c, r, g, b);
+        return pack565((uint8_t)(r * level / 255), (uint8_t)(g * level / 255), (uint8_t)(b * level / 255));
+    }
+
+    void vline(uint16_t* bmp, int x, uint16_t color) {
+        for (int y = 1; y < HeatmapScene::kHeight - 1; ++y) {
+            bmp[y * HeatmapScene::kWidth + x] = color;
+        }
+    }
+}
+
+bool HeatmapScene::hasContent(const GameSnapshot& data) {
+    for (size_t p = 0; p < kStatPeriods; ++p) {
+        if (data.stats.away.shots[p] || data.stats.home.shots[p]) return true;
+    }
+    return false;
+}
+
+void HeatmapScene::rebuild(MatrixPanel_I2S_DMA& display, const GameSnapshot& data, uint32_t nowMs) {
+    builtVersion = shotHeatmapCopy(grid);
+    builtGameId = data.gameId;
+    built = true;
+
+    if (!logoColors) {
+        lastColorAttemptMs = nowMs;
+        uint16_t away = 0;
+        uint16_t home = 0;
+        logoColors = dominantLogoColor(data.away.abbrev, away) && dominantLogoColor(data.home.abbrev, home);
+        awayColor = logoColors ? away : display.color565(80, 140, 255);
+        homeColor = logoColors ? home : display.color565(255, 70, 70);
+    }
+
+    // Rink outline
+    memset(bitmap, 0, sizeof(bitmap));
+    const uint16_t boards = display.color565(50, 50, 60);
+    for (int x = 2; x < kWidth - 2; ++x) {
+        bitmap[x] = boards;
+        bitmap[(kHeight - 1) * kWidth + x] = boards;
+    }
+    for (int y = 2; y < kHeight - 2; ++y) {
+        bitmap[y * kWidth] = boards;
+        bitmap[y * kWidth + kWidth - 1] = boards;
+    }
+    bitmap[1 * kWidth + 1] = boards;
+    bitmap[1 * kWidth + kWidth - 2] = boards;
+    bitmap[(kHeight - 2) * kWidth + 1] = boards;
+    bitmap[(kHeight - 2) * kWidth + kWidth - 2] = boards;
+    vline(bitmap, CENTER_X, display.color565(70, 20, 20));
+    vline(bitmap, CENTER_X + 1, display.color565(70, 20, 20));
+    vline(bitmap, BLUE_LINE_LEFT_X, display.color565(20, 30, 80));
+    vline(bitmap, BLUE_LINE_RIGHT_X, display.color565(20, 30, 80));
+    vline(bitmap, GOAL_LINE_LEFT_X, display.color565(60, 20, 20));
+    vline(bitmap, GOAL_LINE_RIGHT_X, display.color565(60, 20, 20));
+
+    if (grid.peak == 0) return;
+    for (int row = 0; row < kHeatRows; ++row) {
+        for (int col = 0; col < kHeatCols; ++col) {
+            const uint8_t a = grid.away[row][col];
+            const uint8_t h = grid.home[row][col];
+            if (!a && !h) continue;
+            const bool homeWins = h >= a;
+            const uint8_t weight = homeWins ? h : a;
+            // Keep single shots visible: 25% floor, linear up to the peak
+            const uint8_t level = (uint8_t)(64 + (191u * weight) / grid.peak);
+            const uint16_t c = scaleColor(homeWins ? homeColor : awayColor, level);
+            for (int dy = 0; dy < CELL_H; ++dy) {
+                for (int dx = 0; dx < CELL_W; ++dx) {
+                    bitmap[(row * CELL_H + dy) * kWidth + col * CELL_W + dx] = c;
+                }
+            }
+        }
+    }
+}
+
+void HeatmapScene::render(MatrixPanel_I2S_DMA& display, const GameSnapshot& data, uint32_t nowMs) {
+    const bool retryColors = !logoColors && (nowMs - lastColorAttemptMs >= COLOR_RETRY_MS);
+    if (!built || data.gameId != builtGameId) {
+        logoColors = false;
+        rebuild(display, data, nowMs);
+    } else if (shotHeatmapVersion() != builtVersion || retryColors) {
+        rebuild(display, data, nowMs);
+    }
+
+    display.drawRGBBitmap(0, 0, bitmap, kWidth, kHeight);
+    drawMiniText(display, 2, 2, data.away.abbrev, awayColor);
+    drawMiniText(display, kWidth - 2 - miniTextWidth(data.home.abbrev), 2, data.home.abbrev, homeColor);
+}
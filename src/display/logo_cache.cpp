@@ -3,6 +3,8 @@
 #include <LittleFS.h>
 #include <strings.h>
 
+#include "heap_tag.h"
+#include "metrics.h"
 
 namespace {
     struct LogoEntry {
@@ -22,6 +24,12 @@ namespace {
     };
     NegativeEntry negative[4];
 
+    MetricCounter cacheHits("scoreboard_logo_cache_hits_total", "Logo lookups served from RAM");
+    MetricCounter cacheMisses("scoreboard_logo_cache_misses_total", "Logo lookups that read LittleFS");
+    MetricCounter cacheNegativeHits("scoreboard_logo_cache_negative_hits_total",
+        "Logo lookups skipped by the negative cache");
+    MetricCounter cacheLoadFailures("scoreboard_logo_load_failures_total", "Logo files missing or unreadable");
+
     void clearEntry(LogoEntry& entry) {
         if (entry.pixels) {
             free(entry.pixels);
@@ -194,13 +202,16 @@ bool logoCacheGet(const char* abbrev, LogoBitmap& out) {
             out.pixels = entry.pixels;
             out.width = entry.width;
             out.height = entry.height;
+            cacheHits.inc();
             return true;
         }
     }
 
     if (negativeHit(abbrev)) {
+        cacheNegativeHits.inc();
         return false;
     }
+    cacheMisses.inc();
 
     LogoEntry* target = nullptr;
     for (auto& entry : cache) {
@@ -213,7 +224,9 @@ bool logoCacheGet(const char* abbrev, LogoBitmap& out) {
         target = &cache[0];
     }
 
+    HeapTagScope heapTag(HeapTag::Logos);
     if (!loadLogo(abbrev, *target)) {
+        cacheLoadFailures.inc();
         negativeRemember(abbrev, 3000);
         return false;
     }
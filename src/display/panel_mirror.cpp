@@ -0,0 +1,179 @@
+#include "display/panel_mirror.h"
+
+#include <string.h>
+
+#if PANEL_MIRROR
+#include <WebSocketsServer.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "display/mirrored_panel.h"
+#include "logger.h"
+
+namespace {
+    constexpr int FRAME_W = MirroredPanel::kWidth;
+    constexpr int FRAME_H = MirroredPanel::kHeight;
+    // Worst case: every row sent, one run per pixel
+    constexpr size_t MAX_MESSAGE = 4 + FRAME_H * (1 + 3 * FRAME_W);
+    constexpr uint32_t TASK_STACK = 6144;
+    constexpr uint32_t LOOP_MS = 5;
+    constexpr uint8_t MAX_CLIENTS = WEBSOCKETS_SERVER_CLIENT_MAX;
+
+    WebSocketsServer ws(kPanelMirrorPort);
+    TaskHandle_t mirrorTaskHandle = nullptr;
+
+    // Hand-off with the render loop: the sender raises wantFrame when the
+    // next frame is due, the render loop fills latest and raises frameReady
+    std::atomic<bool> wantFrame(false);
+    std::atomic<bool> frameReady(false);
+    uint16_t latest[FRAME_W * FRAME_H];
+    uint16_t previous[FRAME_W * FRAME_H];
+    bool havePrevious = false;
+    uint8_t message[MAX_MESSAGE];
+
+    // Only touched from the mirror task (events arrive inside ws.loop())
+    bool connected[MAX_CLIENTS];
+    bool needKey[MAX_CLIENTS];
+
+    volatile uint8_t maxFps = PANEL_MIRROR_FPS;
+    volatile uint8_t clientCount = 0;
+    volatile uint32_t framesSent = 0;
+    volatile uint32_t keyframes = 0;
+    volatile uint32_t bytesSent = 0;
+    volatile uint32_t dropped = 0;
+    volatile uint32_t sendFailures = 0;
+
+    void onEvent(uint8_t num, WStype_t type, uint8_t*, size_t) {
+        if (num >= MAX_CLIENTS) return;
+        if (type == WStype_CONNECTED) {
+            connected[num] = true;
+            needKey[num] = true;
+        } else if (type == WStype_DISCONNECTED) {
+            connected[num] = false;
+        }
+    }
+
+    bool sendTo(uint8_t num, size_t len) {
+        if (ws.sendBIN(num, message, len)) {
+            bytesSent += len;
+            return true;
+        }
+        // It missed a delta; resynchronise it with a full frame
+        sendFailures++;
+        needKey[num] = true;
+        return false;
+    }
+
+    void sendFrame() {
+        bool keyed[MAX_CLIENTS] = {};
+        bool anyKey = false;
+        for (uint8_t i = 0; i < MAX_CLIENTS; ++i) {
+            if (connected[i] && (needKey[i] || !havePrevious)) anyKey = true;
+        }
+        if (anyKey) {
+            const size_t len = panelMirrorEncode(nullptr, latest, FRAME_W, FRAME_H, message, sizeof(message));
+            for (uint8_t i = 0; i < MAX_CLIENTS; ++i) {
+                if (!connected[i] || !(needKey[i] || !havePrevious)) continue;
+                keyed[i] = true;
+                needKey[i] = false;
+                sendTo(i, len);
+            }
+            keyframes++;
+        }
+        if (havePrevious) {
+            const size_t len = panelMirrorEncode(previous, latest, FRAME_W, FRAME_H, message, sizeof(message));
+            // Header only: nothing changed
+            if (len > 4) {
+                for (uint8_t i = 0; i < MAX_CLIENTS; ++i) {
+                    if (connected[i] && !keyed[i]) sendTo(i, len);
+                }
+            }
+        }
+        memcpy(previous, latest, sizeof(previous));
+        havePrevious = true;
+        framesSent++;
+    }
+
+    void mirrorTask(void*) {
+        uint32_t lastRequestMs = 0;
+        for (;;) {
+            ws.loop();
+            uint8_t clients = 0;
+            for (uint8_t i = 0; i < MAX_CLIENTS; ++i) {
+                if (connected[i]) clients++;
+            }
+            clientCount = clients;
+
+            const uint32_t now = millis();
+            const uint32_t intervalMs = 1000 / maxFps;
+            if (clients == 0) {
+                // Nobody watching: the render loop pays one flag check
+                wantFrame.store(false, std::memory_order_relaxed);
+                frameReady.store(false, std::memory_order_relaxed);
+                havePrevious = false;
+            } else if (frameReady.load(std::memory_order_acquire)) {
+                sendFrame();
+                frameReady.store(false, std::memory_order_relaxed);
+            } else if (!wantFrame.load(std::memory_order_relaxed) && now - lastRequestMs >= intervalMs) {
+                // A slow client holds up sendFrame(); frames due meanwhile are skipped
+                if (lastRequestMs != 0 && now - lastRequestMs >= 2 * intervalMs) {
+                    dropped += (now - lastRequestMs) / intervalMs - 1;
+                }
+                lastRequestMs = now;
+                wantFrame.store(true, std::memory_order_release);
+            }
+            vTaskDelay(pdMS_TO_TICKS(LOOP_MS));
+        }
+    }
+}
+#endif
+
+#if PANEL_MIRROR
+
+void panelMirrorStart() {
+    if (mirrorTaskHandle) return;
+    ws.begin();
+    ws.onEvent(onEvent);
+    if (xTaskCreate(mirrorTask, "panel_mirror", TASK_STACK, NULL, 1, &mirrorTaskHandle) != pdPASS) {
+        Serial.println("Warn: panel mirror task creation failed");
+        mirrorTaskHandle = nullptr;
+        return;
+    }
+    LOGI("mirror", "panel mirror on ws://:%u/", (unsigned)kPanelMirrorPort);
+}
+
+void panelMirrorPublish(const uint16_t* pixels) {
+    if (!wantFrame.load(std::memory_order_acquire)) return;
+    memcpy(latest, pixels, sizeof(latest));
+    wantFrame.store(false, std::memory_order_relaxed);
+    frameReady.store(true, std::memory_order_release);
+}
+
+void panelMirrorSetMaxFps(uint8_t fps) {
+    if (fps < 1) fps = 1;
+    if (fps > kPanelMirrorMaxFps) fps = kPanelMirrorMaxFps;
+    maxFps = fps;
+}
+
+void panelMirrorGetStats(PanelMirrorStats& out) {
+    out.clients = clientCount;
+    out.maxFps = maxFps;
+    out.framesSent = framesSent;
+    out.keyframes = keyframes;
+    out.bytesSent = bytesSent;
+    out.dropped = dropped;
+    out.sendFailures = sendFailures;
+}
+
+#else
+
+void panelMirrorStart() {}
+void panelMirrorPublish(const uint16_t*) {}
+void panelMirrorSetMaxFps(uint8_t) {}
+
+void panelMirrorGetStats(PanelMirrorStats& out) {
+    memset(&out, 0, sizeof(out));
+}
+
+#endif
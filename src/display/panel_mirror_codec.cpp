@@ -0,0 +1,33 @@
+#include "display/panel_mirror_codec.h"
+
+#include <string.h>
+
+size_t panelMirrorEncode(const uint16_t* prev, const uint16_t* cur, int width, int height,
+    uint8_t* out, size_t outSize) {
+    if (outSize < 4 || width > 255 || height > 255) return 0;
+    size_t n = 4;
+    uint8_t rows = 0;
+    for (int y = 0; y < height; ++y) {
+        const uint16_t* row = cur + y * width;
+        if (prev && memcmp(row, prev + y * width, width * sizeof(uint16_t)) == 0) continue;
+        if (n + 1 > outSize) return 0;
+        out[n++] = (uint8_t)y;
+        int x = 0;
+        while (x < width) {
+            const uint16_t color = row[x];
+            int run = 1;
+            while (x + run < width && row[x + run] == color) ++run;
+            if (n + 3 > outSize) return 0;
+            out[n++] = (uint8_t)run;
+            out[n++] = (uint8_t)(color & 0xFF);
+            out[n++] = (uint8_t)(color >> 8);
+            x += run;
+        }
+        rows++;
+    }
+    out[0] = prev ? 0 : 1;
+    out[1] = (uint8_t)width;
+    out[2] = (uint8_t)height;
+    out[3] = rows;
+    return n;
+}
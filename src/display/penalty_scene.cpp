@@ -0,0 +1,100 @@
+#include "display/penalty_scene.h"
+
+#include <Arduino.h>
+
+#include "display/goal_assets.h"
+
+namespace {
+    constexpr int ROW_HEIGHT = 6;
+    constexpr int FIRST_ROW_Y = 9;
+    constexpr int MAX_ROWS = 4;
+
+    int miniTextWidth(const char* s) {
+        if (!s || !s[0]) return 0;
+        return (int)strlen(s) * 4 - 1;
+    }
+
+    void drawMiniChar(MatrixPanel_I2S_DMA& display, int x, int y, char c, uint16_t color) {
+        const MiniGlyph* g = getMiniGlyph(c);
+        for (int row = 0; row < 5; ++row) {
+            for (int col = 0; col < 3; ++col) {
+                if (g->rows[row] & (1 << (2 - col))) {
+                    display.drawPixel(x + col, y + row, color);
+                }
+            }
+        }
+    }
+
+    void drawMiniText(MatrixPanel_I2S_DMA& display, int x, int y, const char* text, uint16_t color) {
+        if (!text) return;
+        int cursor = x;
+        for (size_t i = 0; text[i]; ++i) {
+            drawMiniChar(display, cursor, y, text[i], color);
+            cursor += 4;
+        }
+    }
+
+    const char* teamAbbrevForId(const GameSnapshot& data, uint32_t teamId) {
+        if (teamId == data.away.id) return data.away.abbrev;
+        if (teamId == data.home.id) return data.home.abbrev;
+        return "";
+    }
+}
+
+bool PenaltyScene::hasContent(const GameSnapshot& data) {
+    return (data.awayPP || data.homePP) && !data.inIntermission &&
+        (data.ppTenths > 0 || data.penaltyCount > 0);
+}
+
+void PenaltyScene::syncClock(const GameSnapshot& data, uint32_t nowMs) {
+    if (data.gameId != clockGameId || data.period != clockPeriod) {
+        clock.reset();
+        clockGameId = data.gameId;
+        clockPeriod = data.period;
+        clockSampleMs = 0;
+    }
+    if (data.clockFetchMs != clockSampleMs) {
+        clock.sync(data.clockTenths, data.clockRunning && !data.inIntermission, data.clockFetchMs, nowMs);
+        clockSampleMs = data.clockFetchMs;
+        sampleTenths = data.clockTenths;
+    }
+}
+
+void PenaltyScene::render(MatrixPanel_I2S_DMA& display, const GameSnapshot& data, uint32_t nowMs) {
+    display.clearScreen();
+    display.setTextWrap(false);
+    syncClock(data, nowMs);
+
+    // The PP and penalty times refer to the clock sample they came with
+    const uint16_t clockNow = clock.displayTenths(nowMs);
+    const int panelW = display.width();
+    char timeText[8];
+
+    char header[12];
+    snprintf(header, sizeof(header), "%s PP", data.awayPP ? data.away.abbrev : data.home.abbrev);
+    drawMiniText(display, 1, 1, header, display.color565(255, 200, 60));
+    formatClockTenths(countdownTenths(data.ppTenths, sampleTenths, clockNow), timeText, sizeof(timeText));
+    drawMiniText(display, panelW - miniTextWidth(timeText) - 1, 1, timeText, display.color565(255, 200, 60));
+    display.drawFastHLine(0, 7, panelW, display.color565(60, 60, 80));
+
+    int rowY = FIRST_ROW_Y;
+    int rows = 0;
+    for (uint8_t i = 0; i < data.penaltyCount && rows < MAX_ROWS; ++i) {
+        const PenaltyEntry& p = data.penalties[i];
+        const uint16_t left = countdownTenths(p.remainingTenths, sampleTenths, clockNow);
+        if (left == 0) continue;
+
+        formatClockTenths(left, timeText, sizeof(timeText));
+        const int timeX = panelW - miniTextWidth(timeText) - 1;
+        const int maxChars = (timeX - 2) / 4;
+
+        char line[20];
+        snprintf(line, sizeof(line), "%s %s", teamAbbrevForId(data, p.teamId), p.player);
+        if (maxChars > 0 && (int)strlen(line) > maxChars) line[maxChars] = '\0';
+
+        drawMiniText(display, 1, rowY, line, display.color565(220, 220, 220));
+        drawMiniText(display, timeX, rowY, timeText, display.color565(255, 80, 80));
+        rowY += ROW_HEIGHT;
+        rows++;
+    }
+}
@@ -100,128 +100,10 @@ namespace
         return ((int)strlen(text) * 4) - 1;
     }
 
-    int parseTwo(const char *s)
+    bool isGameSoonToStart(const GameSnapshot &data, int64_t now)
     {
-        if (!s || s[0] < '0' || s[1] < '0')
-            return -1;
-        return (s[0] - '0') * 10 + (s[1] - '0');
-    }
-
-    int parseOffsetMinutes(const char *offset)
-    {
-        if (!offset || !offset[0])
-            return 0;
-        if ((offset[0] != '+' && offset[0] != '-') || strlen(offset) < 6)
-            return 0;
-        int sign = (offset[0] == '-') ? -1 : 1;
-        int hh = parseTwo(offset + 1);
-        int mm = parseTwo(offset + 4);
-        if (hh < 0 || mm < 0)
-            return 0;
-        return sign * (hh * 60 + mm);
-    }
-
-    void formatStartTime(const GameSnapshot &data, char *out, size_t outSize)
-    {
-        if (!out || outSize == 0)
-            return;
-        if (!data.startTimeUtc[0])
-        {
-            strncpy(out, "??:??", outSize);
-            out[outSize - 1] = '\0';
-            return;
-        }
-        const char *t = strchr(data.startTimeUtc, 'T');
-        if (!t || strlen(t) < 6)
-        {
-            strncpy(out, "??:??", outSize);
-            out[outSize - 1] = '\0';
-            return;
-        }
-        int hh = parseTwo(t + 1);
-        int mm = parseTwo(t + 4);
-        if (hh < 0 || mm < 0)
-        {
-            strncpy(out, "??:??", outSize);
-            out[outSize - 1] = '\0';
-            return;
-        }
-        int total = hh * 60 + mm + parseOffsetMinutes(data.utcOffset);
-        while (total < 0)
-            total += 24 * 60;
-        total %= 24 * 60;
-        int outH = total / 60;
-        int outM = total % 60;
-        if (outM == 0)
-        {
-            snprintf(out, outSize, "%02dH", outH);
-        }
-        else
-        {
-            snprintf(out, outSize, "%02dH%02d", outH, outM);
-        }
-    }
-
-    bool isGameSoonToStart(const GameSnapshot &data)
-    {
-        // Check if game start time has passed but game hasn't started
-        if (!data.startTimeUtc[0])
-            return false;
-
-        // Parse start time: format is "YYYY-MM-DDTHH:MM:SSZ"
-        // Example: "2026-02-11T15:30:00Z"
-        if (strlen(data.startTimeUtc) < 16)
-            return false;
-
-        int startYear = (data.startTimeUtc[0] - '0') * 1000 + (data.startTimeUtc[1] - '0') * 100 +
-                        (data.startTimeUtc[2] - '0') * 10 + (data.startTimeUtc[3] - '0');
-        int startMonth = parseTwo(data.startTimeUtc + 5);
-        int startDay = parseTwo(data.startTimeUtc + 8);
-
-        const char *t = strchr(data.startTimeUtc, 'T');
-        if (!t || strlen(t) < 6)
-            return false;
-
-        int startHH = parseTwo(t + 1);
-        int startMM = parseTwo(t + 4);
-        if (startHH < 0 || startMM < 0 || startMonth < 0 || startDay < 0)
-            return false;
-
-        // Get current time (ESP32 has current time from NTP)
-        time_t now;
-        time(&now);
-        struct tm timeinfo;
-        localtime_r(&now, &timeinfo);
-
-        // Apply UTC offset to start time
-        int startTotalMinutes = startHH * 60 + startMM + parseOffsetMinutes(data.utcOffset);
-        int startDayAdjust = 0;
-        while (startTotalMinutes < 0)
-        {
-            startTotalMinutes += 24 * 60;
-            startDayAdjust = -1;
-        }
-        if (startTotalMinutes >= 24 * 60)
-        {
-            startTotalMinutes -= 24 * 60;
-            startDayAdjust = 1;
-        }
-        int adjustedDay = startDay + startDayAdjust;
-
-        // Compare dates first (year, month, day)
-        int currentYear = timeinfo.tm_year + 1900;
-        int currentMonth = timeinfo.tm_mon + 1; // tm_mon is 0-11
-        int currentDay = timeinfo.tm_mday;
-
-        // If not the same day, not "soon"
-        if (startYear != currentYear || startMonth != currentMonth || adjustedDay != currentDay)
-        {
-            return false;
-        }
-
-        // Same day - check if current time >= start time
-        int currentTotalMinutes = timeinfo.tm_hour * 60 + timeinfo.tm_min;
-        return (currentTotalMinutes >= startTotalMinutes);
+        // Start time has passed on the local start day but the game has not started
+        return data.startEpoch != 0 && now >= data.startEpoch && now < data.startDayEndEpoch;
     }
 
     int textWidth(const char *s)
@@ -273,7 +155,23 @@ namespace
     }
 }
 
-void ScoreboardScene::render(MatrixPanel_I2S_DMA &display, const GameSnapshot &data, uint32_t)
+void ScoreboardScene::syncClock(const GameSnapshot &data, uint32_t nowMs)
+{
+    if (data.gameId != clockGameId || data.period != clockPeriod)
+    {
+        clock.reset();
+        clockGameId = data.gameId;
+        clockPeriod = data.period;
+        clockSampleMs = 0;
+    }
+    if (data.clockFetchMs != clockSampleMs)
+    {
+        clock.sync(data.clockTenths, data.clockRunning && !data.inIntermission, data.clockFetchMs, nowMs);
+        clockSampleMs = data.clockFetchMs;
+    }
+}
+
+void ScoreboardScene::render(MatrixPanel_I2S_DMA &display, const GameSnapshot &data, uint32_t nowMs)
 {
     display.clearScreen();
     display.setTextWrap(false);
@@ -306,55 +204,25 @@ void ScoreboardScene::render(MatrixPanel_I2S_DMA &display, const GameSnapshot &d
         return;
     }
 
+    syncClock(data, nowMs);
+
     const char *state = data.gameState;
     const bool isPre = (strcasecmp(state, "PRE") == 0 || strcasecmp(state, "FUT") == 0);
     const bool isFinal = (strcasecmp(state, "OFF") == 0 || strcasecmp(state, "FINAL") == 0);
     const bool isLive = (strcasecmp(state, "LIVE") == 0 || strcasecmp(state, "CRIT") == 0);
 
     char statusLine[32] = {0};
-    char startTime[8] = {0};
-    formatStartTime(data, startTime, sizeof(startTime));
-
-    char dateLabel[6] = {0};
+    const char *dateLabel = "";
     if (isPre)
     {
-        if (isGameSoonToStart(data))
+        if (isGameSoonToStart(data, (int64_t)time(nullptr)))
         {
             snprintf(statusLine, sizeof(statusLine), "SOON");
         }
         else
         {
-            snprintf(statusLine, sizeof(statusLine), "%s", startTime);
-            // Extract DD-MM from startTimeUtc with UTC offset applied
-            if (strlen(data.startTimeUtc) >= 16)
-            {
-                const char *tPos = strchr(data.startTimeUtc, 'T');
-                if (tPos && strlen(tPos) >= 6)
-                {
-                    int utcHH = parseTwo(tPos + 1);
-                    int utcMM = parseTwo(tPos + 4);
-                    int utcDay = parseTwo(data.startTimeUtc + 8);
-                    int utcMonth = parseTwo(data.startTimeUtc + 5);
-                    int utcYear = (data.startTimeUtc[0] - '0') * 1000 +
-                                  (data.startTimeUtc[1] - '0') * 100 +
-                                  (data.startTimeUtc[2] - '0') * 10 +
-                                  (data.startTimeUtc[3] - '0');
-                    if (utcHH >= 0 && utcMM >= 0 && utcDay > 0 && utcMonth > 0)
-                    {
-                        struct tm localTm = {};
-                        localTm.tm_year = utcYear - 1900;
-                        localTm.tm_mon = utcMonth - 1;
-                        localTm.tm_mday = utcDay;
-                        localTm.tm_hour = utcHH;
-                        localTm.tm_min = utcMM + parseOffsetMinutes(data.utcOffset);
-                        localTm.tm_sec = 0;
-                        localTm.tm_isdst = 0;
-                        mktime(&localTm);
-                        snprintf(dateLabel, sizeof(dateLabel), "%02d-%02d",
-                                 localTm.tm_mday, localTm.tm_mon + 1);
-                    }
-                }
-            }
+            snprintf(statusLine, sizeof(statusLine), "%s", data.startLabel);
+            dateLabel = data.startDateLabel;
         }
     }
     else if (isFinal)
@@ -458,7 +326,7 @@ void ScoreboardScene::render(MatrixPanel_I2S_DMA &display, const GameSnapshot &d
     char timeLine[16] = {0};
     if (isLive && data.timeRemaining[0] && !data.inIntermission && !isClockExpired(data.timeRemaining))
     {
-        snprintf(timeLine, sizeof(timeLine), "%s", data.timeRemaining);
+        formatClockTenths(clock.displayTenths(nowMs), timeLine, sizeof(timeLine));
     }
     const int statusBaseY = scoreY + 8 + 2; // Score height (8px) + 2px gap
     if (isLive && timeLine[0])
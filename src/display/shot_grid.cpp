@@ -0,0 +1,49 @@
+#include "display/shot_grid.h"
+
+#include <string.h>
+
+namespace {
+    constexpr int RINK_HALF_LENGTH_FT = 100;
+    constexpr int RINK_HALF_WIDTH_FT = 43;
+    constexpr uint8_t SHOT_WEIGHT = 1;
+    constexpr uint8_t GOAL_WEIGHT = 3;
+
+    int clampInt(int v, int lo, int hi) {
+        return v < lo ? lo : (v > hi ? hi : v);
+    }
+
+    int binCoord(int feet, int halfSpan, int cells) {
+        const int offset = clampInt(feet + halfSpan, 0, 2 * halfSpan);
+        return clampInt(offset * cells / (2 * halfSpan + 1), 0, cells - 1);
+    }
+}
+
+// Rotate the rink so home attacks to the right (+x)
+int ShotGrid::column(int x, bool homeDefendsRight) {
+    return binCoord(homeDefendsRight ? -x : x, RINK_HALF_LENGTH_FT, kHeatCols);
+}
+
+int ShotGrid::row(int y, bool homeDefendsRight) {
+    return binCoord(homeDefendsRight ? -y : y, RINK_HALF_WIDTH_FT, kHeatRows);
+}
+
+bool ShotGrid::add(bool homeTeam, int x, int y, bool homeDefendsRight, bool goal) {
+    const int col = column(x, homeDefendsRight);
+    const int r = row(y, homeDefendsRight);
+    const uint8_t weight = goal ? GOAL_WEIGHT : SHOT_WEIGHT;
+    grid_.shots++;
+    uint8_t& cell = homeTeam ? grid_.home[r][col] : grid_.away[r][col];
+    const uint8_t next = (uint8_t)(cell > 255 - weight ? 255 : cell + weight);
+    if (next == cell) return false;
+    cell = next;
+    if (cell > grid_.peak) grid_.peak = cell;
+    version_++;
+    return true;
+}
+
+bool ShotGrid::reset() {
+    if (grid_.peak == 0 && grid_.shots == 0) return false;
+    memset(&grid_, 0, sizeof(grid_));
+    version_++;
+    return true;
+}
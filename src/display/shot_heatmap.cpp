@@ -0,0 +1,44 @@
+#include "display/shot_heatmap.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+namespace {
+    SemaphoreHandle_t heatmapMutex = nullptr;
+    ShotGrid shots;
+    // Read without the lock by renderers polling for changes
+    volatile uint32_t version = 0;
+}
+
+void shotHeatmapInit() {
+    if (heatmapMutex) return;
+    heatmapMutex = xSemaphoreCreateMutex();
+    shotHeatmapReset();
+}
+
+void shotHeatmapReset() {
+    if (!heatmapMutex) return;
+    xSemaphoreTake(heatmapMutex, portMAX_DELAY);
+    if (shots.reset()) version = shots.version();
+    xSemaphoreGive(heatmapMutex);
+}
+
+void shotHeatmapAdd(bool homeTeam, int x, int y, bool homeDefendsRight, bool goal) {
+    if (!heatmapMutex) return;
+    xSemaphoreTake(heatmapMutex, portMAX_DELAY);
+    if (shots.add(homeTeam, x, y, homeDefendsRight, goal)) version = shots.version();
+    xSemaphoreGive(heatmapMutex);
+}
+
+uint32_t shotHeatmapVersion() {
+    return version;
+}
+
+uint32_t shotHeatmapCopy(ShotHeatmapGrid& out) {
+    if (!heatmapMutex) return 0;
+    xSemaphoreTake(heatmapMutex, portMAX_DELAY);
+    out = shots.grid();
+    const uint32_t v = shots.version();
+    xSemaphoreGive(heatmapMutex);
+    return v;
+}
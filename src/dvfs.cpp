@@ -0,0 +1,165 @@
+#include "dvfs.h"
+
+#include <WiFi.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+namespace {
+    constexpr uint32_t DOWNSHIFT_HOLD_MS = 1500;
+
+    // Board draw estimates (panel excluded) for the energy report
+    constexpr uint32_t LEVEL_MW[kDvfsLevels] = {330, 420, 520};
+    constexpr uint32_t MODEM_ON_EXTRA_MW = 180;   // PS none vs min modem
+
+    SemaphoreHandle_t dvfsMutex = nullptr;
+    DvfsInputs inputs = {0, false, false};
+    DvfsTarget applied = {kDvfsBusyMhz, DvfsPs::MinModem};
+    bool haveApplied = false;
+    uint32_t lowerSinceMs = 0;
+    bool lowerPending = false;
+
+    uint32_t transitions = 0;
+    uint32_t residencyMs[kDvfsLevels] = {0};
+    uint32_t modemOnMs = 0;
+    uint32_t lastAccountMs = 0;
+
+    void lock() {
+        if (dvfsMutex) xSemaphoreTake(dvfsMutex, portMAX_DELAY);
+    }
+
+    void unlock() {
+        if (dvfsMutex) xSemaphoreGive(dvfsMutex);
+    }
+
+    size_t levelIndex(uint16_t mhz) {
+        for (size_t i = 0; i < kDvfsLevels; ++i) {
+            if (kDvfsLevelMhz[i] >= mhz) return i;
+        }
+        return kDvfsLevels - 1;
+    }
+
+    // Charges the time since the last call to the current level
+    void account(uint32_t now) {
+        const uint32_t elapsed = now - lastAccountMs;
+        lastAccountMs = now;
+        residencyMs[levelIndex(applied.cpuMhz)] += elapsed;
+        if (applied.ps == DvfsPs::None) modemOnMs += elapsed;
+    }
+
+    wifi_ps_type_t toWifiPs(DvfsPs ps) {
+        switch (ps) {
+            case DvfsPs::None:
+                return WIFI_PS_NONE;
+            case DvfsPs::MinModem:
+                return WIFI_PS_MIN_MODEM;
+            case DvfsPs::MaxModem:
+                return WIFI_PS_MAX_MODEM;
+        }
+        return WIFI_PS_MIN_MODEM;
+    }
+
+    void applyTarget(const DvfsTarget& target, uint32_t now) {
+        account(now);
+        if (!haveApplied || target.cpuMhz != applied.cpuMhz) {
+            setCpuFrequencyMhz(target.cpuMhz);
+        }
+        if (!haveApplied || target.ps != applied.ps) {
+            WiFi.setSleep(toWifiPs(target.ps));
+        }
+        if (haveApplied) transitions++;
+        applied = target;
+        haveApplied = true;
+        lowerPending = false;
+    }
+
+    // Caller holds the mutex
+    void evaluate(uint32_t now) {
+        const DvfsTarget target = dvfsPolicy(inputs);
+        if (haveApplied && target.cpuMhz == applied.cpuMhz && target.ps == applied.ps) {
+            lowerPending = false;
+            return;
+        }
+        const bool raising = !haveApplied || dvfsIsRaise(applied, target);
+        // Standby is explicit, no need to wait for it to settle
+        if (raising || inputs.standby) {
+            applyTarget(target, now);
+            return;
+        }
+        if (!lowerPending) {
+            lowerPending = true;
+            lowerSinceMs = now;
+            return;
+        }
+        if (now - lowerSinceMs >= DOWNSHIFT_HOLD_MS) {
+            applyTarget(target, now);
+        }
+    }
+}
+
+void dvfsInit() {
+    if (!dvfsMutex) {
+        dvfsMutex = xSemaphoreCreateMutex();
+    }
+    lock();
+    lastAccountMs = millis();
+    applied.cpuMhz = (uint16_t)getCpuFrequencyMhz();
+    evaluate(lastAccountMs);
+    unlock();
+}
+
+void dvfsBeginNetwork() {
+    lock();
+    if (inputs.networkHolds < 255) inputs.networkHolds++;
+    evaluate(millis());
+    unlock();
+}
+
+void dvfsEndNetwork() {
+    lock();
+    if (inputs.networkHolds > 0) inputs.networkHolds--;
+    evaluate(millis());
+    unlock();
+}
+
+void dvfsSetAnimating(bool animating) {
+    if (inputs.animating == animating && !lowerPending) return;
+    lock();
+    inputs.animating = animating;
+    evaluate(millis());
+    unlock();
+}
+
+void dvfsSetStandby(bool standby) {
+    lock();
+    inputs.standby = standby;
+    evaluate(millis());
+    unlock();
+}
+
+void dvfsTick() {
+    if (!lowerPending) return;
+    lock();
+    evaluate(millis());
+    unlock();
+}
+
+void dvfsGetStats(DvfsStats& out) {
+    lock();
+    account(millis());
+    out.cpuMhz = applied.cpuMhz;
+    out.ps = applied.ps;
+    out.transitions = transitions;
+    uint64_t totalMs = 0;
+    uint64_t mwMs = 0;
+    for (size_t i = 0; i < kDvfsLevels; ++i) {
+        out.residencyMs[i] = residencyMs[i];
+        totalMs += residencyMs[i];
+        mwMs += (uint64_t)residencyMs[i] * LEVEL_MW[i];
+    }
+    mwMs += (uint64_t)modemOnMs * MODEM_ON_EXTRA_MW;
+    unlock();
+    // Average draw in mW is also mWh per hour
+    const uint32_t baseline = LEVEL_MW[kDvfsLevels - 1] + MODEM_ON_EXTRA_MW;
+    out.baselineMwhPerHour = baseline;
+    out.estMwhPerHour = totalMs ? (uint32_t)(mwMs / totalMs) : baseline;
+}
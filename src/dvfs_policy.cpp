@@ -0,0 +1,34 @@
+#include "dvfs_policy.h"
+
+const uint16_t kDvfsLevelMhz[kDvfsLevels] = {80, 160, 240};
+
+DvfsTarget dvfsPolicy(const DvfsInputs& in) {
+    if (in.standby) {
+        // Heartbeat fetches in standby stay slow: nobody is waiting on them
+        return {kDvfsIdleMhz, in.networkHolds > 0 ? DvfsPs::MinModem : DvfsPs::MaxModem};
+    }
+    if (in.networkHolds > 0) {
+        return {kDvfsBusyMhz, DvfsPs::None};
+    }
+    if (in.animating) {
+        return {kDvfsBusyMhz, DvfsPs::MinModem};
+    }
+    return {kDvfsIdleMhz, DvfsPs::MinModem};
+}
+
+bool dvfsIsRaise(const DvfsTarget& from, const DvfsTarget& to) {
+    // DvfsPs is ordered from most awake to deepest sleep
+    return to.cpuMhz > from.cpuMhz || (uint8_t)to.ps < (uint8_t)from.ps;
+}
+
+const char* dvfsPsName(DvfsPs ps) {
+    switch (ps) {
+        case DvfsPs::None:
+            return "none";
+        case DvfsPs::MinModem:
+            return "min-modem";
+        case DvfsPs::MaxModem:
+            return "max-modem";
+    }
+    return "?";
+}
@@ -0,0 +1,79 @@
+#include "goal_watch.h"
+
+#include <string.h>
+
+namespace {
+    void copyName(char* dest, size_t destSize, const char* src) {
+        if (!src) src = "";
+        strncpy(dest, src, destSize - 1);
+        dest[destSize - 1] = '\0';
+    }
+
+    bool sameName(const char* held, size_t heldSize, const char* src) {
+        if (!src) src = "";
+        return strncmp(held, src, heldSize - 1) == 0;
+    }
+}
+
+void goalWatchClear(GoalWatch& watch) {
+    memset(&watch, 0, sizeof(watch));
+}
+
+void goalWatchAdd(GoalWatch& watch, uint32_t eventId, const char* scorer,
+    const char* assist1, const char* assist2, uint32_t nowMs) {
+    WatchedGoal* slot = &watch.goals[0];
+    for (size_t i = 0; i < kGoalWatchMax; ++i) {
+        WatchedGoal& w = watch.goals[i];
+        if (w.eventId == eventId || w.eventId == 0) {
+            slot = &w;
+            break;
+        }
+        if (nowMs - w.announcedMs > nowMs - slot->announcedMs) slot = &w;
+    }
+    slot->eventId = eventId;
+    slot->announcedMs = nowMs;
+    copyName(slot->scorer, sizeof(slot->scorer), scorer);
+    copyName(slot->assist1, sizeof(slot->assist1), assist1);
+    copyName(slot->assist2, sizeof(slot->assist2), assist2);
+    watch.followUpPolls = kGoalFollowUpPolls;
+}
+
+size_t goalWatchExpire(GoalWatch& watch, uint32_t nowMs) {
+    size_t active = 0;
+    for (size_t i = 0; i < kGoalWatchMax; ++i) {
+        WatchedGoal& w = watch.goals[i];
+        if (w.eventId == 0) continue;
+        if (nowMs - w.announcedMs > kGoalWatchMs) {
+            w.eventId = 0;
+            continue;
+        }
+        active++;
+    }
+    return active;
+}
+
+WatchedGoal* goalWatchFind(GoalWatch& watch, uint32_t eventId) {
+    if (eventId == 0) return nullptr;
+    for (size_t i = 0; i < kGoalWatchMax; ++i) {
+        if (watch.goals[i].eventId == eventId) return &watch.goals[i];
+    }
+    return nullptr;
+}
+
+bool goalWatchSetNames(WatchedGoal& goal, const char* scorer, const char* assist1, const char* assist2) {
+    if (sameName(goal.scorer, sizeof(goal.scorer), scorer)
+        && sameName(goal.assist1, sizeof(goal.assist1), assist1)
+        && sameName(goal.assist2, sizeof(goal.assist2), assist2)) {
+        return false;
+    }
+    copyName(goal.scorer, sizeof(goal.scorer), scorer);
+    copyName(goal.assist1, sizeof(goal.assist1), assist1);
+    copyName(goal.assist2, sizeof(goal.assist2), assist2);
+    return true;
+}
+
+uint32_t goalWatchNextPollDelayMs(GoalWatch& watch, uint32_t baseMs) {
+    if (watch.followUpPolls == 0) return baseMs;
+    watch.followUpPolls--;
+    return kGoalFollowUpIntervalMs;
+}
@@ -0,0 +1,130 @@
+#include "heap_tag.h"
+
+#if HEAP_TRACE
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace {
+    constexpr size_t MAX_SCOPED_TASKS = 8;
+
+    struct TaskTag {
+        TaskHandle_t task;
+        HeapTag tag;
+    };
+
+    // Allocations can come from either core; keep every critical section
+    // free of anything that could allocate
+    portMUX_TYPE heapMux = portMUX_INITIALIZER_UNLOCKED;
+    HeapTagTable table;
+    TaskTag taskTags[MAX_SCOPED_TASKS];
+    size_t scopedTasks = 0;
+
+    HeapTag currentTag() {
+        if (scopedTasks == 0) return HeapTag::None;
+        const TaskHandle_t self = xTaskGetCurrentTaskHandle();
+        for (size_t i = 0; i < MAX_SCOPED_TASKS; ++i) {
+            if (taskTags[i].task == self) return taskTags[i].tag;
+        }
+        return HeapTag::None;
+    }
+
+    void recordAlloc(void* ptr, size_t size) {
+        portENTER_CRITICAL(&heapMux);
+        table.recordAlloc(ptr, size, currentTag());
+        portEXIT_CRITICAL(&heapMux);
+    }
+
+    void recordFree(void* ptr) {
+        portENTER_CRITICAL(&heapMux);
+        table.recordFree(ptr);
+        portEXIT_CRITICAL(&heapMux);
+    }
+}
+
+extern "C" {
+    void* __real_malloc(size_t size);
+    void* __real_calloc(size_t count, size_t size);
+    void* __real_realloc(void* ptr, size_t size);
+    void __real_free(void* ptr);
+
+    void* __wrap_malloc(size_t size) {
+        void* p = __real_malloc(size);
+        if (p) recordAlloc(p, size);
+        return p;
+    }
+
+    void* __wrap_calloc(size_t count, size_t size) {
+        void* p = __real_calloc(count, size);
+        if (p) recordAlloc(p, count * size);
+        return p;
+    }
+
+    void* __wrap_realloc(void* ptr, size_t size) {
+        void* p = __real_realloc(ptr, size);
+        portENTER_CRITICAL(&heapMux);
+        table.recordRealloc(ptr, p, size, currentTag());
+        portEXIT_CRITICAL(&heapMux);
+        return p;
+    }
+
+    void __wrap_free(void* ptr) {
+        if (ptr) recordFree(ptr);
+        __real_free(ptr);
+    }
+}
+
+HeapTag heapTagPush(HeapTag tag) {
+    const TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    HeapTag previous = HeapTag::None;
+    portENTER_CRITICAL(&heapMux);
+    size_t slot = MAX_SCOPED_TASKS;
+    for (size_t i = 0; i < MAX_SCOPED_TASKS; ++i) {
+        if (taskTags[i].task == self) {
+            slot = i;
+            break;
+        }
+        if (!taskTags[i].task && slot == MAX_SCOPED_TASKS) slot = i;
+    }
+    if (slot < MAX_SCOPED_TASKS) {
+        if (taskTags[slot].task == self) {
+            previous = taskTags[slot].tag;
+        } else {
+            taskTags[slot].task = self;
+            scopedTasks++;
+        }
+        taskTags[slot].tag = tag;
+    }
+    portEXIT_CRITICAL(&heapMux);
+    return previous;
+}
+
+void heapTagPop(HeapTag previous) {
+    const TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    portENTER_CRITICAL(&heapMux);
+    for (size_t i = 0; i < MAX_SCOPED_TASKS; ++i) {
+        if (taskTags[i].task != self) continue;
+        if (previous == HeapTag::None) {
+            taskTags[i].task = nullptr;
+            scopedTasks--;
+        } else {
+            taskTags[i].tag = previous;
+        }
+        break;
+    }
+    portEXIT_CRITICAL(&heapMux);
+}
+
+void heapTagGetStats(HeapTagStats& out) {
+    out.enabled = true;
+    portENTER_CRITICAL(&heapMux);
+    table.getStats(out);
+    portEXIT_CRITICAL(&heapMux);
+}
+
+#else
+
+void heapTagGetStats(HeapTagStats& out) {
+    memset(&out, 0, sizeof(out));
+}
+
+#endif
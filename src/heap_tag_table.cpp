@@ -0,0 +1,115 @@
+#include "heap_tag_table.h"
+
+#include <string.h>
+
+namespace {
+    size_t homeSlot(const void* ptr) {
+        return (((uint32_t)(uintptr_t)ptr >> 3) * 2654435761u) >> (32 - kHeapTableBits);
+    }
+
+    size_t sizeBucket(size_t size) {
+        size_t i = 0;
+        size_t limit = 16;
+        while (i < kHeapSizeBuckets - 1 && size > limit) {
+            limit <<= 1;
+            ++i;
+        }
+        return i;
+    }
+}
+
+void HeapTagTable::clear() {
+    memset(table_, 0, sizeof(table_));
+    count_ = 0;
+    memset(counters_, 0, sizeof(counters_));
+    memset(sizeHist_, 0, sizeof(sizeHist_));
+    untracked_ = 0;
+}
+
+void HeapTagTable::recordAlloc(void* ptr, size_t size, HeapTag tag) {
+    sizeHist_[sizeBucket(size)]++;
+    if (tag == HeapTag::None) return;
+    // Open addressing with linear probing; kept under 3/4 full
+    if (count_ >= kHeapTableLimit) {
+        untracked_++;
+        return;
+    }
+    size_t i = homeSlot(ptr);
+    while (table_[i].ptr) i = (i + 1) & kMask;
+    table_[i].ptr = ptr;
+    table_[i].sizeTag = ((uint32_t)tag << 24) | ((uint32_t)size & 0xFFFFFFu);
+    count_++;
+    HeapTagCounters& c = counters_[(size_t)tag];
+    c.liveBytes += size;
+    c.liveCount++;
+    c.allocs++;
+    if (c.liveBytes > c.peakBytes) c.peakBytes = c.liveBytes;
+}
+
+// Backward-shift deletion keeps probe chains intact without tombstones
+void HeapTagTable::removeAt(size_t hole) {
+    size_t j = hole;
+    for (;;) {
+        j = (j + 1) & kMask;
+        if (!table_[j].ptr) break;
+        const size_t home = homeSlot(table_[j].ptr);
+        const bool staysPut = hole <= j ? (hole < home && home <= j) : (hole < home || home <= j);
+        if (!staysPut) {
+            table_[hole] = table_[j];
+            hole = j;
+        }
+    }
+    table_[hole].ptr = nullptr;
+    count_--;
+}
+
+void HeapTagTable::recordFree(void* ptr) {
+    if (count_ == 0) return;
+    size_t i = homeSlot(ptr);
+    while (table_[i].ptr) {
+        if (table_[i].ptr == ptr) {
+            HeapTagCounters& c = counters_[table_[i].sizeTag >> 24];
+            c.liveBytes -= table_[i].sizeTag & 0xFFFFFFu;
+            c.liveCount--;
+            removeAt(i);
+            return;
+        }
+        i = (i + 1) & kMask;
+    }
+}
+
+void HeapTagTable::recordRealloc(void* oldPtr, void* newPtr, size_t size, HeapTag tag) {
+    if (!newPtr && size != 0) return;
+    if (oldPtr) recordFree(oldPtr);
+    if (newPtr) recordAlloc(newPtr, size, tag);
+}
+
+void HeapTagTable::getStats(HeapTagStats& out) const {
+    memcpy(out.tags, counters_, sizeof(out.tags));
+    memcpy(out.sizeHist, sizeHist_, sizeof(out.sizeHist));
+    out.tracked = (uint32_t)count_;
+    out.untracked = untracked_;
+}
+
+uint32_t heapSizeBucketLimit(size_t index) {
+    if (index >= kHeapSizeBuckets - 1) return 0;
+    return 16u << index;
+}
+
+const char* heapTagName(HeapTag tag) {
+    switch (tag) {
+        case HeapTag::None:
+            return "none";
+        case HeapTag::Pbp:
+            return "pbp";
+        case HeapTag::Schedule:
+            return "schedule";
+        case HeapTag::Api:
+            return "api";
+        case HeapTag::Display:
+            return "display";
+        case HeapTag::Logos:
+            return "logos";
+    }
+    return "?";
+}
@@ -0,0 +1,150 @@
+#include "logger.h"
+
+#include <stdarg.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace {
+    constexpr uint32_t DRAIN_INTERVAL_MS = 20;
+    constexpr uint32_t DRAIN_STACK = 3072;
+
+    // Multi-producer ring of fixed slots. A producer claims a sequence
+    // number with one atomic increment, marks the slot busy (seq 0),
+    // fills it and publishes seq + 1. Readers copy a slot and re-check
+    // its stamp, so a slot overwritten mid-copy is detected and skipped.
+    struct Slot {
+        std::atomic<uint32_t> stamp;
+        uint32_t ms;
+        uint8_t level;
+        char text[kLogTextMax];
+    };
+
+    Slot slots[kLogSlots];
+    std::atomic<uint32_t> nextSeq(0);
+    uint32_t drainSeq = 0;   // drain task only
+
+    std::atomic<uint32_t> truncated(0);
+    std::atomic<uint32_t> writeUsTotal(0);
+    uint32_t dropped = 0;
+    uint32_t serialUsTotal = 0;
+    TaskHandle_t drainTask = nullptr;
+
+    // Copies slot `seq` if it still holds that entry
+    bool readSlot(uint32_t seq, LogEntry& out) {
+        const Slot& slot = slots[seq % kLogSlots];
+        const uint32_t before = slot.stamp.load(std::memory_order_acquire);
+        if (before != seq + 1) return false;
+        out.seq = seq;
+        out.ms = slot.ms;
+        out.level = slot.level;
+        memcpy(out.text, slot.text, sizeof(out.text));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.stamp.load(std::memory_order_relaxed) != before) return false;
+        out.text[sizeof(out.text) - 1] = '\0';
+        return true;
+    }
+
+    void drainOnce() {
+        const uint32_t head = nextSeq.load(std::memory_order_acquire);
+        if (head - drainSeq > kLogSlots) {
+            dropped += head - drainSeq - kLogSlots;
+            drainSeq = head - kLogSlots;
+        }
+        LogEntry entry;
+        while (drainSeq != head) {
+            const Slot& slot = slots[drainSeq % kLogSlots];
+            const uint32_t stamp = slot.stamp.load(std::memory_order_acquire);
+            if (stamp == 0 || stamp == drainSeq + 1 - kLogSlots) {
+                break;  // producer still writing; pick it up next round
+            }
+            if (readSlot(drainSeq, entry)) {
+                const uint32_t start = micros();
+                Serial.println(entry.text);
+                serialUsTotal += micros() - start;
+            } else {
+                dropped++;
+            }
+            drainSeq++;
+        }
+    }
+
+    void logDrainTask(void*) {
+        for (;;) {
+            drainOnce();
+            vTaskDelay(pdMS_TO_TICKS(DRAIN_INTERVAL_MS));
+        }
+    }
+}
+
+void logWrite(uint8_t level, const char* tag, const char* fmt, ...) {
+    const uint32_t start = micros();
+    const uint32_t seq = nextSeq.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots[seq % kLogSlots];
+    slot.stamp.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.ms = millis();
+    slot.level = level;
+
+    int n = snprintf(slot.text, sizeof(slot.text), "[%s] ", tag);
+    if (n < 0) n = 0;
+    if ((size_t)n < sizeof(slot.text)) {
+        va_list args;
+        va_start(args, fmt);
+        const int m = vsnprintf(slot.text + n, sizeof(slot.text) - n, fmt, args);
+        va_end(args);
+        if (m > 0 && (size_t)(n + m) >= sizeof(slot.text)) {
+            truncated.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    // Messages carried their own newline when they went to Serial.printf
+    size_t len = strlen(slot.text);
+    while (len > 0 && (slot.text[len - 1] == '\n' || slot.text[len - 1] == '\r')) {
+        slot.text[--len] = '\0';
+    }
+
+    slot.stamp.store(seq + 1, std::memory_order_release);
+    writeUsTotal.fetch_add(micros() - start, std::memory_order_relaxed);
+}
+
+void logStart() {
+    if (drainTask) return;
+    if (xTaskCreate(logDrainTask, "log_drain", DRAIN_STACK, NULL, 1, &drainTask) != pdPASS) {
+        Serial.println("Warn: log_drain task creation failed");
+        drainTask = nullptr;
+    }
+}
+
+size_t logSnapshot(LogEntry* out, size_t maxEntries) {
+    const uint32_t head = nextSeq.load(std::memory_order_acquire);
+    const uint32_t span = head < kLogSlots ? head : kLogSlots;
+    const uint32_t count = span < maxEntries ? span : (uint32_t)maxEntries;
+    size_t n = 0;
+    for (uint32_t seq = head - count; seq != head; ++seq) {
+        if (readSlot(seq, out[n])) n++;
+    }
+    return n;
+}
+
+void logGetStats(LogStats& out) {
+    out.written = nextSeq.load(std::memory_order_relaxed);
+    out.dropped = dropped;
+    out.truncated = truncated.load(std::memory_order_relaxed);
+    out.writeUsTotal = writeUsTotal.load(std::memory_order_relaxed);
+    out.serialUsTotal = serialUsTotal;
+}
+
+const char* logLevelName(uint8_t level) {
+    switch (level) {
+        case LOG_LEVEL_ERROR:
+            return "error";
+        case LOG_LEVEL_WARN:
+            return "warn";
+        case LOG_LEVEL_INFO:
+            return "info";
+        case LOG_LEVEL_DEBUG:
+            return "debug";
+        default:
+            return "?";
+    }
+}
@@ -0,0 +1,140 @@
+#include "metrics.h"
+
+namespace {
+    // Constant-initialised, so registration from static constructors in
+    // any translation unit is safe
+    Metric* head = nullptr;
+    Metric* tail = nullptr;
+
+    void appendU64(String& out, uint64_t v) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), "%llu", (unsigned long long)v);
+        out += buf;
+    }
+}
+
+Metric::Metric(const char* name, const char* help)
+    : name_(name), help_(help), next_(nullptr) {
+    // Keep declaration order within a file for a stable scrape
+    if (tail) {
+        tail->next_ = this;
+    } else {
+        head = this;
+    }
+    tail = this;
+}
+
+void Metric::renderHeader(String& out, const char* type) const {
+    out += "# HELP ";
+    out += name_;
+    out += ' ';
+    out += help_;
+    out += "\n# TYPE ";
+    out += name_;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+void MetricCounter::render(String& out) const {
+    renderHeader(out, "counter");
+    out += name();
+    out += ' ';
+    appendU64(out, value());
+    out += '\n';
+}
+
+MetricLabeledCounter::MetricLabeledCounter(const char* name, const char* help, const char* label)
+    : Metric(name, help), label_(label), other_(0) {
+    for (size_t i = 0; i < kSlots; ++i) {
+        keys_[i].store(kEmpty, std::memory_order_relaxed);
+        counts_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricLabeledCounter::inc(int32_t labelValue) {
+    for (size_t i = 0; i < kSlots; ++i) {
+        int32_t key = keys_[i].load(std::memory_order_acquire);
+        if (key == kEmpty) {
+            // Claim the slot; if another task got there first, re-check it
+            if (keys_[i].compare_exchange_strong(key, labelValue, std::memory_order_acq_rel)) {
+                key = labelValue;
+            }
+        }
+        if (key == labelValue) {
+            counts_[i].fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    other_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MetricLabeledCounter::render(String& out) const {
+    renderHeader(out, "counter");
+    char line[96];
+    for (size_t i = 0; i < kSlots; ++i) {
+        const int32_t key = keys_[i].load(std::memory_order_acquire);
+        if (key == kEmpty) break;
+        snprintf(line, sizeof(line), "%s{%s=\"%ld\"} %lu\n", name(), label_,
+            (long)key, (unsigned long)counts_[i].load(std::memory_order_relaxed));
+        out += line;
+    }
+    const uint32_t other = other_.load(std::memory_order_relaxed);
+    if (other) {
+        snprintf(line, sizeof(line), "%s{%s=\"other\"} %lu\n", name(), label_, (unsigned long)other);
+        out += line;
+    }
+}
+
+void MetricGauge::render(String& out) const {
+    renderHeader(out, "gauge");
+    char line[64];
+    snprintf(line, sizeof(line), "%s %ld\n", name(), (long)value());
+    out += line;
+}
+
+MetricHistogram::MetricHistogram(const char* name, const char* help, const uint32_t* bounds, size_t count)
+    : Metric(name, help), bounds_(bounds), count_(count > kMaxBuckets ? kMaxBuckets : count), sum_(0) {
+    for (size_t i = 0; i <= kMaxBuckets; ++i) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricHistogram::observe(uint32_t v) {
+    size_t i = 0;
+    while (i < count_ && v > bounds_[i]) ++i;
+    buckets_[i].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(v, std::memory_order_relaxed);
+}
+
+void MetricHistogram::render(String& out) const {
+    renderHeader(out, "histogram");
+    char line[96];
+    // Prometheus buckets are cumulative
+    uint32_t cumulative = 0;
+    for (size_t i = 0; i < count_; ++i) {
+        cumulative += buckets_[i].load(std::memory_order_relaxed);
+        snprintf(line, sizeof(line), "%s_bucket{le=\"%lu\"} %lu\n", name(),
+            (unsigned long)bounds_[i], (unsigned long)cumulative);
+        out += line;
+    }
+    cumulative += buckets_[count_].load(std::memory_order_relaxed);
+    snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %lu\n", name(), (unsigned long)cumulative);
+    out += line;
+    out += name();
+    out += "_sum ";
+    appendU64(out, sum_.load(std::memory_order_relaxed));
+    out += '\n';
+    snprintf(line, sizeof(line), "%s_count %lu\n", name(), (unsigned long)cumulative);
+    out += line;
+}
+
+Metric* metricsFirst() {
+    return head;
+}
+
+void metricsRender(String& out) {
+    for (const Metric* m = head; m; m = m->next()) {
+        m->render(out);
+    }
+}
@@ -0,0 +1,80 @@
+#include "net_trace.h"
+
+#include <WiFi.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+namespace {
+    const uint32_t PHASE_MS_BOUNDS[] = {10, 25, 50, 100, 250, 500, 1000, 2500, 5000};
+
+    MetricHistogram phaseHist[kNetPhaseCount] = {
+        {"scoreboard_net_dns_ms", "DNS lookup time", PHASE_MS_BOUNDS, 9},
+        {"scoreboard_net_connect_ms", "TCP connect + TLS handshake time", PHASE_MS_BOUNDS, 9},
+        {"scoreboard_net_ttfb_ms", "Request sent to response headers", PHASE_MS_BOUNDS, 9},
+        {"scoreboard_net_body_ms", "Time spent waiting on body bytes", PHASE_MS_BOUNDS, 9},
+        {"scoreboard_net_parse_ms", "JSON parse time excluding waits", PHASE_MS_BOUNDS, 9},
+    };
+
+    SemaphoreHandle_t traceMutex = nullptr;
+    NetTraceRing ring;
+
+    void lock() {
+        if (traceMutex) xSemaphoreTake(traceMutex, portMAX_DELAY);
+    }
+
+    void unlock() {
+        if (traceMutex) xSemaphoreGive(traceMutex);
+    }
+}
+
+void netTraceInit() {
+    if (!traceMutex) {
+        traceMutex = xSemaphoreCreateMutex();
+    }
+}
+
+void netTraceBegin(NetTrace& trace, const char* source, int attempt) {
+    netTraceStartAt(trace, source, attempt, millis());
+}
+
+void netTraceMark(NetTrace& trace, NetPhase phase) {
+    netTraceMarkAt(trace, phase, millis());
+}
+
+void netTraceMarkBody(NetTrace& trace, uint32_t parseUs) {
+    netTraceMarkBodyAt(trace, parseUs, millis());
+}
+
+bool netTracePreconnect(NetTrace& trace, WiFiClientSecure& client, const char* host,
+    uint16_t port, uint32_t timeoutMs) {
+    // lwIP caches the answer, so the lookup inside connect() is free
+    IPAddress ip;
+    const bool resolved = WiFi.hostByName(host, ip) == 1;
+    netTraceMark(trace, NetPhase::Dns);
+    if (!resolved) return false;
+    const bool connected = client.connect(host, port, (int32_t)timeoutMs) == 1;
+    netTraceMark(trace, NetPhase::Connect);
+    return connected;
+}
+
+void netTraceEnd(NetTrace& trace, int httpCode, bool ok, uint32_t bytes) {
+    netTraceFinish(trace, httpCode, ok, bytes);
+    for (size_t i = 0; i < kNetPhaseCount; ++i) {
+        // Phases the attempt never reached stay out of the histograms
+        if (netTraceReached(trace, (NetPhase)i)) phaseHist[i].observe(trace.phaseMs[i]);
+    }
+    lock();
+    ring.push(trace);
+    unlock();
+}
+
+size_t netTraceRecent(NetTrace* out, size_t maxCount) {
+    lock();
+    const size_t count = ring.recent(out, maxCount);
+    unlock();
+    return count;
+}
+
+const MetricHistogram& netTraceHistogram(NetPhase phase) {
+    return phaseHist[(size_t)phase];
+}
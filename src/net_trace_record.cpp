@@ -0,0 +1,67 @@
+#include "net_trace_record.h"
+
+#include <string.h>
+
+void netTraceStartAt(NetTrace& trace, const char* source, int attempt, uint32_t nowMs) {
+    memset(&trace, 0, sizeof(trace));
+    trace.source = source;
+    trace.attempt = (uint8_t)(attempt < 0 ? 0 : attempt);
+    trace.startMs = nowMs;
+    trace.markMs = nowMs;
+}
+
+void netTraceMarkAt(NetTrace& trace, NetPhase phase, uint32_t nowMs) {
+    trace.phaseMs[(size_t)phase] += nowMs - trace.markMs;
+    trace.reached |= (uint8_t)(1u << (size_t)phase);
+    trace.markMs = nowMs;
+}
+
+void netTraceMarkBodyAt(NetTrace& trace, uint32_t parseUs, uint32_t nowMs) {
+    const uint32_t elapsed = nowMs - trace.markMs;
+    uint32_t parseMs = (parseUs + 500) / 1000;
+    if (parseMs > elapsed) parseMs = elapsed;
+    trace.phaseMs[(size_t)NetPhase::Body] += elapsed - parseMs;
+    trace.phaseMs[(size_t)NetPhase::Parse] += parseMs;
+    trace.reached |= (uint8_t)((1u << (size_t)NetPhase::Body) | (1u << (size_t)NetPhase::Parse));
+    trace.markMs = nowMs;
+}
+
+void netTraceFinish(NetTrace& trace, int httpCode, bool ok, uint32_t bytes) {
+    trace.httpCode = (int16_t)httpCode;
+    trace.ok = ok;
+    trace.bytes = bytes;
+}
+
+bool netTraceReached(const NetTrace& trace, NetPhase phase) {
+    return (trace.reached & (1u << (size_t)phase)) != 0;
+}
+
+void NetTraceRing::push(const NetTrace& trace) {
+    slots_[next_] = trace;
+    next_ = (next_ + 1) % kNetTraceSlots;
+    if (count_ < kNetTraceSlots) count_++;
+}
+
+size_t NetTraceRing::recent(NetTrace* out, size_t maxCount) const {
+    const size_t count = count_ < maxCount ? count_ : maxCount;
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = slots_[(next_ + kNetTraceSlots - 1 - i) % kNetTraceSlots];
+    }
+    return count;
+}
+
+const char* netPhaseName(NetPhase phase) {
+    switch (phase) {
+        case NetPhase::Dns:
+            return "dns";
+        case NetPhase::Connect:
+            return "connect";
+        case NetPhase::Ttfb:
+            return "ttfb";
+        case NetPhase::Body:
+            return "body";
+        case NetPhase::Parse:
+            return "parse";
+    }
+    return "?";
+}
@@ -0,0 +1,145 @@
+#include "off_hours.h"
+
+#include <WiFi.h>
+#include <Preferences.h>
+#include <esp_sleep.h>
+#include <time.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "api_server.h"
+#include "boot.h"
+#include "display/display_manager.h"
+
+namespace {
+    constexpr const char* PREFS_NAMESPACE = "offhours";
+    constexpr size_t MAX_STARTS = kOffHoursMaxStarts;
+    // Stay up this long after a boot so the web UI is reachable
+    constexpr uint32_t MIN_AWAKE_MS = 10 * 60 * 1000;
+    // Rough board draw for the savings estimate: S3 at 240 MHz with WiFi
+    // associated plus a dark panel, vs. deep sleep with the panel supply on
+    constexpr uint32_t ACTIVE_MW = 1300;
+    constexpr uint32_t DEEP_SLEEP_MW = 150;
+
+    // Kept across deep sleep
+    RTC_DATA_ATTR uint32_t rtcSleeps = 0;
+    RTC_DATA_ATTR uint32_t rtcSleptS = 0;
+    RTC_DATA_ATTR uint32_t rtcLastSleepS = 0;
+
+    SemaphoreHandle_t offHoursMutex = nullptr;
+    bool enabled = false;
+    bool scheduleKnown = false;
+    int64_t starts[MAX_STARTS];
+    size_t startCount = 0;
+    bool live = false;
+    OffHoursPlan plan = {false, 0, 0};
+    volatile bool sleepPending = false;
+
+    void lock() {
+        if (offHoursMutex) xSemaphoreTake(offHoursMutex, portMAX_DELAY);
+    }
+
+    void unlock() {
+        if (offHoursMutex) xSemaphoreGive(offHoursMutex);
+    }
+
+    int64_t nowEpoch() {
+        const time_t now = time(nullptr);
+        return now > 100000 ? (int64_t)now : 0;
+    }
+}
+
+void offHoursInit() {
+    if (!offHoursMutex) {
+        offHoursMutex = xSemaphoreCreateMutex();
+    }
+    Preferences prefs;
+    if (prefs.begin(PREFS_NAMESPACE, true)) {
+        enabled = prefs.getBool("enabled", false);
+        prefs.end();
+    }
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER) {
+        rtcSleptS += rtcLastSleepS;
+        Serial.printf("[offhours] woke after %lus (sleeps=%lu)\n",
+            (unsigned long)rtcLastSleepS, (unsigned long)rtcSleeps);
+    }
+    rtcLastSleepS = 0;
+}
+
+void offHoursSetEnabled(bool on) {
+    lock();
+    enabled = on;
+    if (!on) {
+        plan = {false, 0, 0};
+        sleepPending = false;
+    }
+    unlock();
+    Preferences prefs;
+    if (prefs.begin(PREFS_NAMESPACE, false)) {
+        prefs.putBool("enabled", on);
+        prefs.end();
+    }
+    Serial.printf("[offhours] %s\n", on ? "enabled" : "disabled");
+}
+
+bool offHoursIsEnabled() {
+    return enabled;
+}
+
+void offHoursUpdateSchedule(const int64_t* upcomingStarts, size_t count, bool anyLive) {
+    if (count > MAX_STARTS) count = MAX_STARTS;
+    const int64_t now = nowEpoch();
+    const OffHoursPlan next = offHoursPlan(upcomingStarts, count, anyLive, now, kOffHoursPolicy);
+
+    lock();
+    memcpy(starts, upcomingStarts, count * sizeof(int64_t));
+    startCount = count;
+    live = anyLive;
+    scheduleKnown = true;
+    plan = next;
+    const bool arm = enabled && plan.sleep
+        && apiServerGetSelectedGameId() == 0
+        && bootIsDone(BootPhase::TimeSynced)
+        && millis() >= MIN_AWAKE_MS;
+    unlock();
+
+    if (arm && !sleepPending) {
+        Serial.printf("[offhours] nothing until %lld, sleeping %lus\n",
+            (long long)plan.wakeEpoch, (unsigned long)plan.sleepS);
+        sleepPending = true;
+    }
+}
+
+void offHoursLoop() {
+    if (!sleepPending) return;
+    sleepPending = false;
+
+    lock();
+    const bool stillValid = enabled && plan.sleep && apiServerGetSelectedGameId() == 0;
+    const int64_t now = nowEpoch();
+    const int64_t remaining = plan.wakeEpoch - now;
+    unlock();
+    if (!stillValid || now == 0 || remaining < (int64_t)kOffHoursPolicy.minSleepS) return;
+
+    // Blank and release the panel first so it does not latch a frame
+    displaySetEnabled(false, true);
+    WiFi.disconnect(true, false);
+    rtcSleeps++;
+    rtcLastSleepS = (uint32_t)remaining;
+    Serial.printf("[offhours] deep sleep %lus\n", (unsigned long)remaining);
+    Serial.flush();
+    esp_sleep_enable_timer_wakeup((uint64_t)remaining * 1000000ULL);
+    esp_deep_sleep_start();
+}
+
+void offHoursGetStats(OffHoursStats& out) {
+    lock();
+    out.enabled = enabled;
+    out.scheduleKnown = scheduleKnown;
+    out.plan = plan;
+    out.sleepFractionPct = (uint16_t)(offHoursSleepPermille(starts, startCount, nowEpoch(), kOffHoursPolicy) / 10);
+    unlock();
+    out.sleeps = rtcSleeps;
+    out.sleptS = rtcSleptS;
+    out.savedWhPerWeek = (uint32_t)((uint64_t)(ACTIVE_MW - DEEP_SLEEP_MW) * 168 * out.sleepFractionPct / 100 / 1000);
+}
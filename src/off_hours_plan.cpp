@@ -0,0 +1,76 @@
+#include "off_hours_plan.h"
+
+const OffHoursPolicy kOffHoursPolicy = {
+    30 * 60,        // preGameLeadS
+    3 * 3600 + 1800,// gameLengthS
+    2 * 3600,       // minSleepS
+    24 * 3600       // maxSleepS
+};
+
+namespace {
+    // Earliest start strictly after `after`; 0 when there is none
+    int64_t nextStartAfter(const int64_t* upcomingStarts, size_t count, int64_t after) {
+        int64_t best = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const int64_t s = upcomingStarts[i];
+            if (s > after && (best == 0 || s < best)) best = s;
+        }
+        return best;
+    }
+}
+
+OffHoursPlan offHoursPlan(const int64_t* upcomingStarts, size_t count,
+    bool anyLive, int64_t now, const OffHoursPolicy& policy) {
+    OffHoursPlan out = {false, 0, 0};
+    if (anyLive || now <= 0) return out;
+
+    // A game that should have started but is not final yet (delays,
+    // stale schedule) keeps the board up
+    for (size_t i = 0; i < count; ++i) {
+        if (upcomingStarts[i] <= now + (int64_t)policy.preGameLeadS) return out;
+    }
+
+    int64_t wake = now + (int64_t)policy.maxSleepS;
+    const int64_t next = nextStartAfter(upcomingStarts, count, now);
+    if (next != 0 && next - (int64_t)policy.preGameLeadS < wake) {
+        wake = next - (int64_t)policy.preGameLeadS;
+    }
+    const int64_t sleepS = wake - now;
+    if (sleepS < (int64_t)policy.minSleepS) return out;
+
+    out.sleep = true;
+    out.wakeEpoch = wake;
+    out.sleepS = (uint32_t)sleepS;
+    return out;
+}
+
+uint16_t offHoursSleepPermille(const int64_t* upcomingStarts, size_t count,
+    int64_t now, const OffHoursPolicy& policy) {
+    if (count == 0 || now <= 0) return 0;
+    if (count > kOffHoursMaxStarts) count = kOffHoursMaxStarts;
+    int64_t sorted[kOffHoursMaxStarts];
+    for (size_t i = 0; i < count; ++i) {
+        const int64_t v = upcomingStarts[i];
+        size_t j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            --j;
+        }
+        sorted[j] = v;
+    }
+
+    // Each gap from the end of one game (or now) to the lead time before
+    // the next start is slept through if it is long enough
+    int64_t asleep = 0;
+    int64_t awakeUntil = now;
+    for (size_t i = 0; i < count; ++i) {
+        const int64_t gapEnd = sorted[i] - (int64_t)policy.preGameLeadS;
+        if (gapEnd - awakeUntil >= (int64_t)policy.minSleepS) {
+            asleep += gapEnd - awakeUntil;
+        }
+        const int64_t gameEnd = sorted[i] + (int64_t)policy.gameLengthS;
+        if (gameEnd > awakeUntil) awakeUntil = gameEnd;
+    }
+    if (awakeUntil <= now) return 0;
+    return (uint16_t)((asleep * 1000) / (awakeUntil - now));
+}
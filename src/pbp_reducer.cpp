@@ -0,0 +1,506 @@
+#include "pbp_reducer.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#include "display/clock_interpolator.h"
+
+// ============================================================================
+// JSON FILTER SETUP
+// ============================================================================
+
+void buildPlayByPlayFilter(JsonDocument& f, bool includeRoster) {
+    f["gameState"] = true;
+    f["startTimeUTC"] = true;
+    f["easternUTCOffset"] = true;
+    f["venueUTCOffset"] = true;
+    f["periodDescriptor"]["number"] = true;
+    f["clock"]["timeRemaining"] = true;
+    f["clock"]["inIntermission"] = true;
+    f["clock"]["running"] = true;
+    f["homeTeam"]["score"] = true;
+    f["homeTeam"]["sog"] = true;
+    f["homeTeam"]["id"] = true;
+    f["homeTeam"]["abbrev"] = true;
+    f["homeTeam"]["commonName"]["default"] = true;
+    f["homeTeam"]["placeName"]["default"] = true;
+    f["awayTeam"]["score"] = true;
+    f["awayTeam"]["sog"] = true;
+    f["awayTeam"]["id"] = true;
+    f["awayTeam"]["abbrev"] = true;
+    f["awayTeam"]["commonName"]["default"] = true;
+    f["awayTeam"]["placeName"]["default"] = true;
+    f["situation"]["timeRemaining"] = true;
+    f["situation"]["homeTeam"]["strength"] = true;
+    f["situation"]["homeTeam"]["situationDescriptions"][0] = true;
+    f["situation"]["awayTeam"]["strength"] = true;
+    f["situation"]["awayTeam"]["situationDescriptions"][0] = true;
+    JsonArray plays = f["plays"].to<JsonArray>();
+    JsonObject p = plays.add<JsonObject>();
+    p["typeDescKey"] = true;
+    p["timeRemaining"] = true;
+    p["periodDescriptor"]["number"] = true;
+    p["eventId"] = true;
+    p["sortOrder"] = true;
+    p["homeTeamDefendingSide"] = true;
+    p["situationCode"] = true;
+    JsonObject d = p["details"].to<JsonObject>();
+    d["eventOwnerTeamId"] = true;
+    d["scoringPlayerId"] = true;
+    d["scoringPlayerName"]["default"] = true;
+    d["shootingPlayerName"]["default"] = true;
+    d["assist1PlayerName"]["default"] = true;
+    d["assist2PlayerName"]["default"] = true;
+    d["goalieInNetName"]["default"] = true;
+    d["secondaryType"] = true;
+    d["shotType"] = true;
+    d["assist1PlayerId"] = true;
+    d["assist2PlayerId"] = true;
+    d["scoringPlayerId"] = true;
+    d["typeCode"] = true;
+    d["descKey"] = true;
+    d["duration"] = true;
+    d["committedByPlayerId"] = true;
+    d["servedByPlayerId"] = true;
+    d["xCoord"] = true;
+    d["yCoord"] = true;
+
+    if (!includeRoster) return;
+    JsonArray roster = f["rosterSpots"].to<JsonArray>();
+    JsonObject r = roster.add<JsonObject>();
+    r["playerId"] = true;
+    r["firstName"]["default"] = true;
+    r["lastName"]["default"] = true;
+}
+
+// ============================================================================
+// ROSTER & NAMES
+// ============================================================================
+
+namespace {
+    bool isAllowedRecapChar(char c) {
+        return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == ' ' || c == '-' || c == ':';
+    }
+
+    void extractLastName(const char* fullName, char* out, size_t outSize) {
+        if (!out || outSize == 0) return;
+        out[0] = '\0';
+        if (!fullName || !fullName[0]) return;
+        const char* last = fullName;
+        for (const char* p = fullName; *p; ++p) {
+            if (*p == ' ') last = p + 1;
+        }
+        strncpy(out, last, outSize - 1);
+        out[outSize - 1] = '\0';
+    }
+}
+
+void buildFullName(char* dest, size_t destSize, const char* part1, const char* part2) {
+    if (!dest || destSize == 0) return;
+    if (part1[0] && part2[0])
+        snprintf(dest, destSize, "%s %s", part1, part2);
+    else
+        snprintf(dest, destSize, "%s%s", part1, part2);
+}
+
+void buildRosterCache(RosterCache& cache, JsonArray roster, uint32_t gameId) {
+    cache.clear();
+    cache.gameId = gameId;
+    if (roster.isNull()) return;
+
+    for (JsonObject p : roster) {
+        if (cache.count >= sizeof(cache.players) / sizeof(cache.players[0])) break;
+
+        int id = p["playerId"] | 0;
+        const char* first = p["firstName"]["default"] | "";
+        const char* last = p["lastName"]["default"] | "";
+
+        if (id == 0) continue;
+
+        cache.players[cache.count].id = id;
+        buildFullName(cache.players[cache.count].name,
+                     sizeof(cache.players[cache.count].name),
+                     first, last);
+        cache.count++;
+    }
+}
+
+void copyField(char* dest, size_t destSize, const char* src) {
+    if (!dest || destSize == 0) return;
+    if (!src) src = "";
+    strncpy(dest, src, destSize - 1);
+    dest[destSize - 1] = '\0';
+}
+
+void resolvePlayerName(const RosterCache& roster, char* out, size_t outSize, const char* apiName, int playerId) {
+    if (apiName && apiName[0]) {
+        copyField(out, outSize, apiName);
+        return;
+    }
+    copyField(out, outSize, roster.lookupName(playerId));
+}
+
+void sanitizeToken(const char* in, char* out, size_t outSize) {
+    if (!out || outSize == 0) return;
+    out[0] = '\0';
+    if (!in || !in[0]) return;
+    size_t o = 0;
+    bool lastSpace = true;
+    for (size_t i = 0; in[i] && o + 1 < outSize; ++i) {
+        char c = (char)toupper((unsigned char)in[i]);
+        if (!isAllowedRecapChar(c)) c = ' ';
+        if (c == ' ') {
+            if (lastSpace) continue;
+            lastSpace = true;
+        } else {
+            lastSpace = false;
+        }
+        out[o++] = c;
+    }
+    while (o > 0 && out[o - 1] == ' ') {
+        --o;
+    }
+    out[o] = '\0';
+}
+
+void copyRecapName(const char* fullName, char* out, size_t outSize) {
+    char lastName[32];
+    extractLastName(fullName, lastName, sizeof(lastName));
+    sanitizeToken(lastName, out, outSize);
+}
+
+// ============================================================================
+// EVENT REDUCER
+// ============================================================================
+
+namespace {
+    // Regular-season overtime is 5 minutes; playoff overtime and regulation
+    // periods are 20. Game type is digits 5-6 of the id (02 regular, 03 playoffs).
+    int32_t periodLengthTenths(uint32_t gameId, int period) {
+        const bool playoffs = ((gameId / 10000) % 100) == 3;
+        return (period <= 3 || playoffs) ? 12000 : 3000;
+    }
+
+    // Tenths of game time elapsed since the opening faceoff
+    int32_t gameElapsedTenths(uint32_t gameId, int period, uint16_t remainingTenths) {
+        if (period < 1) return 0;
+        int32_t elapsed = 0;
+        for (int p = 1; p < period; ++p) {
+            elapsed += periodLengthTenths(gameId, p);
+        }
+        return elapsed + periodLengthTenths(gameId, period) - remainingTenths;
+    }
+
+    bool isTimedPenalty(const char* typeCode, int durationMin) {
+        // Misconducts do not leave a team short-handed
+        if (durationMin <= 0) return false;
+        return strcasecmp(typeCode, "MIS") != 0 && strcasecmp(typeCode, "GMIS") != 0;
+    }
+
+    // Players on the ice (goalie + skaters) per side from a play's
+    // situationCode: away goalie, away skaters, home skaters, home goalie,
+    // e.g. "1451" for an away penalty kill. False when absent or malformed.
+    bool playersOnIce(const char* code, int& away, int& home) {
+        if (strlen(code) != 4) return false;
+        for (int i = 0; i < 4; ++i) {
+            if (!isdigit((unsigned char)code[i])) return false;
+        }
+        away = (code[0] - '0') + (code[1] - '0');
+        home = (code[2] - '0') + (code[3] - '0');
+        return true;
+    }
+
+    int runningPenalties(const PenaltyWork* work, size_t count, int teamId, int32_t atTenths) {
+        int n = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const PenaltyWork& w = work[i];
+            if ((int)w.entry.teamId != teamId) continue;
+            if (w.startTenths > atTenths || w.endTenths <= atTenths) continue;
+            n++;
+        }
+        return n;
+    }
+
+    // Whether the scoring team had a man advantage. The play's situationCode
+    // decides when present (a pulled goalie is not an advantage); otherwise
+    // the timed penalties running on each side are compared, so coincidental
+    // minors cancel out.
+    bool scoredWithAdvantage(const GameReducer& r, JsonObject play, const TeamContext& ctx,
+        uint32_t teamId, int32_t goalTenths) {
+        if (teamId == 0 || (teamId != ctx.awayId && teamId != ctx.homeId)) return false;
+        const bool home = teamId == ctx.homeId;
+        int awayOnIce = 0;
+        int homeOnIce = 0;
+        if (playersOnIce(play["situationCode"] | "", awayOnIce, homeOnIce)) {
+            return home ? homeOnIce > awayOnIce : awayOnIce > homeOnIce;
+        }
+        const uint32_t opponentId = home ? ctx.awayId : ctx.homeId;
+        return runningPenalties(r.penalties, r.penaltyCount, (int)opponentId, goalTenths) >
+            runningPenalties(r.penalties, r.penaltyCount, (int)teamId, goalTenths);
+    }
+
+    // A power-play goal ends the scorer's opponent's earliest-expiring minor.
+    void releaseMinorOnGoal(PenaltyWork* work, size_t count, int scoringTeamId, int32_t goalTenths) {
+        PenaltyWork* target = nullptr;
+        for (size_t i = 0; i < count; ++i) {
+            PenaltyWork& w = work[i];
+            if (!w.minor || (int)w.entry.teamId == scoringTeamId) continue;
+            if (w.startTenths > goalTenths || w.endTenths <= goalTenths) continue;
+            if (!target || w.endTenths < target->endTenths) target = &w;
+        }
+        if (!target) return;
+        // A double minor only loses its current half
+        const int32_t served = goalTenths - target->startTenths;
+        if (target->entry.durationMin >= 4 && served < 1200) {
+            target->endTenths = goalTenths + 1200;
+        } else {
+            target->endTenths = goalTenths;
+        }
+    }
+
+    TeamGameStats* teamStats(GameReducer& r, const TeamContext& ctx, uint32_t teamId) {
+        if (teamId != 0 && teamId == ctx.awayId) return &r.stats.away;
+        if (teamId != 0 && teamId == ctx.homeId) return &r.stats.home;
+        return nullptr;
+    }
+
+    // Regulation and overtime share kStatPeriods buckets; the regular-season
+    // shootout (period 5) is not counted in shots or goals.
+    int statPeriodIndex(const TeamContext& ctx, int period) {
+        if (period < 1) return -1;
+        const bool playoffs = ((ctx.gameId / 10000) % 100) == 3;
+        if (!playoffs && period >= 5) return -1;
+        return period > (int)kStatPeriods ? (int)kStatPeriods - 1 : period - 1;
+    }
+
+    void resolveName(const TeamContext& ctx, char* out, size_t outSize, const char* apiName, int playerId) {
+        if (ctx.roster) {
+            resolvePlayerName(*ctx.roster, out, outSize, apiName, playerId);
+        } else {
+            copyField(out, outSize, apiName);
+        }
+    }
+
+    void tallyScorer(GameReducer& r, const TeamContext& ctx, uint32_t playerId, uint32_t teamId,
+        const char* apiName, bool goal) {
+        if (playerId == 0) return;
+        ScorerTally* t = nullptr;
+        for (uint8_t i = 0; i < r.scorerCount; ++i) {
+            if (r.scorers[i].playerId == playerId) {
+                t = &r.scorers[i];
+                break;
+            }
+        }
+        if (!t) {
+            if (r.scorerCount >= kPbpScorerMax) return;
+            t = &r.scorers[r.scorerCount++];
+            t->playerId = playerId;
+            t->teamId = teamId;
+            char name[32];
+            resolveName(ctx, name, sizeof(name), apiName, (int)playerId);
+            copyRecapName(name, t->name, sizeof(t->name));
+        }
+        if (goal) {
+            if (t->goals < 255) t->goals++;
+        } else if (t->assists < 255) {
+            t->assists++;
+        }
+    }
+
+    void addShotLocation(JsonObject play, JsonObject details, const TeamContext& ctx, uint32_t teamId, bool goal) {
+        if (details["xCoord"].isNull() || details["yCoord"].isNull()) return;
+        if (!ctx.shots.add) return;
+        if (teamId == 0 || (teamId != ctx.awayId && teamId != ctx.homeId)) return;
+        const bool homeDefendsRight = strcasecmp(play["homeTeamDefendingSide"] | "", "right") == 0;
+        ctx.shots.add(teamId == ctx.homeId, details["xCoord"] | 0, details["yCoord"] | 0, homeDefendsRight, goal);
+    }
+
+    void applyGoal(GameReducer& r, JsonObject play, JsonObject details, const TeamContext& ctx, int period, int32_t at) {
+        const uint32_t teamId = details["eventOwnerTeamId"] | 0;
+        if (scoredWithAdvantage(r, play, ctx, teamId, at)) {
+            releaseMinorOnGoal(r.penalties, r.penaltyCount, (int)teamId, at);
+        }
+
+        const int idx = statPeriodIndex(ctx, period);
+        TeamGameStats* team = teamStats(r, ctx, teamId);
+        if (team && idx >= 0) {
+            if (team->goals[idx] < 255) team->goals[idx]++;
+            if (team->shots[idx] < 255) team->shots[idx]++;
+        }
+        if (idx >= 0) {
+            addShotLocation(play, details, ctx, teamId, true);
+            tallyScorer(r, ctx, details["scoringPlayerId"] | 0, teamId, details["scoringPlayerName"]["default"] | "", true);
+            tallyScorer(r, ctx, details["assist1PlayerId"] | 0, teamId, details["assist1PlayerName"]["default"] | "", false);
+            tallyScorer(r, ctx, details["assist2PlayerId"] | 0, teamId, details["assist2PlayerName"]["default"] | "", false);
+        }
+
+        if (r.goalCount >= kMaxRecapGoals) return;
+        RecapGoal& g = r.goals[r.goalCount++];
+        g.eventId = play["eventId"] | 0;
+        const char* abbrev = teamId == ctx.awayId ? ctx.awayAbbrev : (teamId == ctx.homeId ? ctx.homeAbbrev : "");
+        sanitizeToken(abbrev, g.teamAbbrev, sizeof(g.teamAbbrev));
+
+        char name[32];
+        resolveName(ctx, name, sizeof(name),
+            details["scoringPlayerName"]["default"] | "",
+            details["scoringPlayerId"] | 0);
+        copyRecapName(name, g.scorer, sizeof(g.scorer));
+        resolveName(ctx, name, sizeof(name),
+            details["assist1PlayerName"]["default"] | "",
+            details["assist1PlayerId"] | 0);
+        copyRecapName(name, g.assist1, sizeof(g.assist1));
+        resolveName(ctx, name, sizeof(name),
+            details["assist2PlayerName"]["default"] | "",
+            details["assist2PlayerId"] | 0);
+        copyRecapName(name, g.assist2, sizeof(g.assist2));
+        sanitizeToken(play["timeRemaining"] | "", g.timeRemaining, sizeof(g.timeRemaining));
+        g.period = (uint8_t)period;
+    }
+
+    void applyPenalty(GameReducer& r, JsonObject play, JsonObject details, const TeamContext& ctx, int32_t at) {
+        const uint32_t teamId = details["eventOwnerTeamId"] | 0;
+        const char* typeCode = details["typeCode"] | "";
+        const int duration = details["duration"] | 0;
+
+        TeamGameStats* team = teamStats(r, ctx, teamId);
+        if (team && duration > 0) team->pim += (uint16_t)duration;
+        if (!isTimedPenalty(typeCode, duration)) return;
+
+        if (r.penaltyCount == kPbpPenaltyScanMax) {
+            // Keep the most recent ones; older penalties are long expired
+            memmove(&r.penalties[0], &r.penalties[1],
+                sizeof(r.penalties[0]) * (kPbpPenaltyScanMax - 1));
+            r.penaltyCount--;
+        }
+        PenaltyWork& w = r.penalties[r.penaltyCount++];
+        memset(&w, 0, sizeof(w));
+        w.entry.eventId = play["eventId"] | 0;
+        w.entry.teamId = teamId;
+        w.entry.durationMin = (uint8_t)duration;
+        int playerId = details["committedByPlayerId"] | 0;
+        if (playerId == 0) playerId = details["servedByPlayerId"] | 0;
+        char name[32];
+        resolveName(ctx, name, sizeof(name), "", playerId);
+        copyRecapName(name[0] ? name : "BENCH", w.entry.player, sizeof(w.entry.player));
+        sanitizeToken(details["descKey"] | "", w.entry.infraction, sizeof(w.entry.infraction));
+        w.startTenths = at;
+        w.endTenths = at + duration * 600;
+        w.minor = strcasecmp(typeCode, "MIN") == 0 || strcasecmp(typeCode, "BEN") == 0;
+    }
+
+    void applyPlay(GameReducer& r, JsonObject play, const TeamContext& ctx) {
+        const char* type = play["typeDescKey"] | "";
+        JsonObject details = play["details"];
+        const int period = play["periodDescriptor"]["number"] | 0;
+
+        const bool isGoal = strcasecmp(type, "goal") == 0;
+        if (isGoal || strcasecmp(type, "penalty") == 0) {
+            const int32_t at = gameElapsedTenths(ctx.gameId, period, parseClockTenths(play["timeRemaining"] | ""));
+            if (isGoal) {
+                applyGoal(r, play, details, ctx, period, at);
+            } else {
+                applyPenalty(r, play, details, ctx, at);
+            }
+            return;
+        }
+
+        const uint32_t teamId = details["eventOwnerTeamId"] | 0;
+        TeamGameStats* team = teamStats(r, ctx, teamId);
+        if (!team) return;
+        if (strcasecmp(type, "shot-on-goal") == 0) {
+            const int idx = statPeriodIndex(ctx, period);
+            if (idx >= 0 && team->shots[idx] < 255) team->shots[idx]++;
+            if (idx >= 0) addShotLocation(play, details, ctx, teamId, false);
+        } else if (strcasecmp(type, "hit") == 0) {
+            team->hits++;
+        } else if (strcasecmp(type, "faceoff") == 0) {
+            team->faceoffWins++;
+        }
+    }
+
+    void restart(GameReducer& r, const TeamContext& ctx) {
+        reducerReset(r, ctx.gameId);
+        if (ctx.shots.reset) ctx.shots.reset();
+    }
+}
+
+void reducerReset(GameReducer& r, uint32_t gameId) {
+    const uint32_t rebuilds = r.gameId == gameId ? r.rebuilds : 0;
+    memset(&r, 0, sizeof(r));
+    r.gameId = gameId;
+    r.watermark = -1;
+    r.rebuilds = rebuilds;
+}
+
+uint32_t reducerConsume(GameReducer& r, JsonArray plays, const TeamContext& ctx) {
+    if (r.gameId != ctx.gameId) restart(r, ctx);
+    if (plays.isNull() || plays.size() == 0) return 0;
+
+    const int lastSortOrder = plays[(int)plays.size() - 1]["sortOrder"] | 0;
+    if (lastSortOrder < r.watermark) {
+        restart(r, ctx);
+        r.rebuilds++;
+    }
+    if (lastSortOrder == r.watermark) return 0;
+
+    uint32_t applied = 0;
+    for (JsonObject play : plays) {
+        const int sortOrder = play["sortOrder"] | 0;
+        if (sortOrder <= r.watermark) continue;
+        applyPlay(r, play, ctx);
+        r.watermark = sortOrder;
+        applied++;
+    }
+    r.playsReduced += applied;
+    return applied;
+}
+
+void reducerReconcileFinal(GameReducer& r, JsonArray plays, const TeamContext& ctx) {
+    if (r.reconciled) return;
+    restart(r, ctx);
+    reducerConsume(r, plays, ctx);
+    r.reconciled = true;
+}
+
+uint8_t reducerLeaders(const GameReducer& r, StatLeader* out, uint8_t maxOut) {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < r.scorerCount; ++i) {
+        const ScorerTally& t = r.scorers[i];
+        const int points = t.goals + t.assists;
+        uint8_t pos = n;
+        while (pos > 0) {
+            const StatLeader& prev = out[pos - 1];
+            const int prevPoints = prev.goals + prev.assists;
+            if (points < prevPoints || (points == prevPoints && t.goals <= prev.goals)) break;
+            pos--;
+        }
+        if (pos >= maxOut) continue;
+        const uint8_t last = n < maxOut ? n : (uint8_t)(maxOut - 1);
+        for (uint8_t j = last; j > pos; --j) {
+            out[j] = out[j - 1];
+        }
+        out[pos].teamId = t.teamId;
+        copyField(out[pos].name, sizeof(out[pos].name), t.name);
+        out[pos].goals = t.goals;
+        out[pos].assists = t.assists;
+        if (n < maxOut) n++;
+    }
+    return n;
+}
+
+uint8_t reducerActivePenalties(const GameReducer& r, int period, uint16_t clockTenths,
+    PenaltyEntry* out, uint8_t maxOut) {
+    const int32_t now = gameElapsedTenths(r.gameId, period, clockTenths);
+    uint8_t n = 0;
+    for (size_t i = 0; i < r.penaltyCount && n < maxOut; ++i) {
+        const PenaltyWork& w = r.penalties[i];
+        if (w.startTenths > now || w.endTenths <= now) continue;
+        out[n] = w.entry;
+        const int32_t left = w.endTenths - now;
+        out[n].remainingTenths = (uint16_t)(left > 0xFFFF ? 0xFFFF : left);
+        n++;
+    }
+    return n;
+}
@@ -5,74 +5,130 @@
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <esp_heap_caps.h>
 #include <ctype.h>
 #include <strings.h>
 
 #include "api_server.h"
+#include "boot.h"
+#include "arena_allocator.h"
+#include "dvfs.h"
+#include "goal_watch.h"
+#include "heap_tag.h"
+#include "logger.h"
+#include "pbp_reducer.h"
+#include "metrics.h"
+#include "net_trace.h"
+#include "display/clock_interpolator.h"
 #include "display/data_model.h"
+#include "display/shot_heatmap.h"
 #include "prefix_stream.h"
+#include "ring_stream.h"
+#include "section_gate_stream.h"
+#include "timed_stream.h"
+#include "spsc_byte_ring.h"
+#include "power_manager.h"
+#include "upstream_health.h"
+#include "wifi_link.h"
 
 // ============================================================================
 // CONSTANTS
 // ============================================================================
+static const char* NHL_API_HOST = "api-web.nhle.com";
 static const char* NHL_PBP_URL_FMT = "https://api-web.nhle.com/v1/gamecenter/%u/play-by-play";
 static const unsigned long PBP_MIN_INTERVAL_MS = 5000;
 static const unsigned long PBP_FAIL_BACKOFF_MS = 5000;
 static const int PBP_MAX_RETRIES = 3;
 static const unsigned long PBP_RETRY_BASE_MS = 1000;
+static const unsigned long PBP_STALL_TIMEOUT_MS = 5000;
+
+// Pipelined fetch: TLS receive runs on core 0 (next to the WiFi stack),
+// JSON parsing runs in the poll task on core 1. Build with
+// -DPBP_PIPELINED_FETCH=0 to compare against the single-task path.
+#ifndef PBP_PIPELINED_FETCH
+#define PBP_PIPELINED_FETCH 1
+#endif
+static const size_t PBP_RING_SIZE = 8192;
+static const uint32_t PBP_RX_STACK = 6144;
+static const BaseType_t PBP_RX_CORE = 0;
+static const BaseType_t PBP_PARSE_CORE = 1;
+
+// Per-poll JSON documents live in one arena (PSRAM when available) that
+// is rewound before each poll, so steady-state polling does not allocate.
+static const size_t PBP_ARENA_SIZE = 192 * 1024;
+static const size_t PBP_RESPONSE_MAX = 3072;
+
+// Top-level sections a poll keeps, in feed order. Parsing stops once the
+// required ones have been read; rosterSpots is only required until the
+// roster is cached. The UTC offsets and situation (only sent during
+// special-teams play) are optional: they are kept when they show up ahead
+// of plays, which is where the feed sends them. If the feed ever reorders
+// them, the gate is turned off for good rather than cut them.
+static const char* const PBP_SECTIONS[] = {
+    "startTimeUTC",
+    "easternUTCOffset",   // optional
+    "venueUTCOffset",     // optional
+    "gameState",
+    "periodDescriptor",
+    "awayTeam",
+    "homeTeam",
+    "clock",
+    "situation",          // optional
+    "plays",
+    "rosterSpots"
+};
+static const uint32_t PBP_OPTIONAL_SECTIONS = (1u << 1) | (1u << 2) | (1u << 8);
+static const size_t PBP_SECTION_COUNT = sizeof(PBP_SECTIONS) / sizeof(PBP_SECTIONS[0]);
+static const size_t PBP_SECTION_COUNT_NO_ROSTER = PBP_SECTION_COUNT - 1;
 
 // ============================================================================
 // DATA STRUCTURES
 // ============================================================================
-struct PlayerEntry {
-    int id;
-    char name[32];
-};
-
 struct GoalInfo {
     bool isNew;
     int eventId;
     int ownerTeamId;
     int scoringPlayerId;
     int period;
-    String type;
-    String time;
-    String scoringPlayerName;
-    String shootingPlayerName;
-    String assist1Name;
-    String assist2Name;
-    String goalieName;
-    String secondaryType;
-    String shotType;
+    char type[16];
+    char time[8];
+    char scoringPlayerName[32];
+    char shootingPlayerName[32];
+    char assist1Name[32];
+    char assist2Name[32];
+    char goalieName[32];
+    char secondaryType[24];
+    char shotType[16];
 };
 
 struct PbpState {
-    String lastGoodResponse;
+    char lastGoodResponse[PBP_RESPONSE_MAX];
+    size_t lastGoodResponseLen;
     unsigned long lastFetchMs;
     unsigned long lastFailMs;
     uint32_t gameId;
     int lastPlaySortOrder;
     bool primed;
     bool hadEmptyFetch;
+    uint32_t followUpRequests;
 };
 
-struct RosterCache {
-    PlayerEntry players[80];
-    size_t count;
-    uint32_t gameId;
-    
-    void clear() {
-        count = 0;
-        gameId = 0;
-    }
-    
-    const char* lookupName(int playerId) const {
-        if (playerId == 0) return "";
-        for (size_t i = 0; i < count; ++i) {
-            if (players[i].id == playerId) return players[i].name;
-        }
-        return "";
-    }
+struct ParseStats {
+    size_t bytesParsed;
+    size_t bytesReceived;
+    uint32_t parseUs;
+    bool closedEarly;
+};
+
+// Set once the feed sends the gated sections out of order
+static bool sectionGateOff = false;
+
+struct BodyReceiver {
+    WiFiClient* client;
+    int contentLength;
+    size_t bytesIn;
+    SemaphoreHandle_t done;
 };
 
 // ============================================================================
@@ -81,177 +137,70 @@ struct RosterCache {
 static WebServer* playByPlayServer = nullptr;
 static WiFiClientSecure playByPlayClient;
 static PbpState state;
+
+static const uint32_t FETCH_MS_BOUNDS[] = {100, 250, 500, 1000, 2000, 5000, 10000};
+static MetricCounter fetchAttempts("scoreboard_pbp_fetch_attempts_total",
+    "Play-by-play HTTP attempts");
+static MetricLabeledCounter fetchFailures("scoreboard_pbp_fetch_failures_total",
+    "Play-by-play attempts without a 200, by HTTP code (0 = not started, <0 = client error)", "code");
+static MetricCounter fetchBytes("scoreboard_pbp_bytes_total",
+    "Play-by-play body bytes received");
+static MetricCounter jsonErrors("scoreboard_pbp_json_errors_total",
+    "Play-by-play bodies that did not parse (including no JSON start)");
+static MetricHistogram ttfbMsHist("scoreboard_pbp_ttfb_ms",
+    "Play-by-play time to first byte", FETCH_MS_BOUNDS, 7);
+static MetricHistogram parseMsHist("scoreboard_pbp_parse_ms",
+    "Play-by-play body receive + parse time", FETCH_MS_BOUNDS, 7);
+static MetricCounter goalEvents("scoreboard_goal_events_total",
+    "New goals detected in the play-by-play feed");
 static RosterCache rosterCache;
+static uint8_t pbpRingBuffer[PBP_RING_SIZE];
+static SpscByteRing pbpRing(pbpRingBuffer, PBP_RING_SIZE);
+static BodyReceiver receiver;
+static uint8_t* pbpArenaBlock = nullptr;
+static ArenaAllocator pbpArena;
+static JsonDocument pbpDoc(&pbpArena);
+static JsonDocument pbpOut(&pbpArena);
+static SemaphoreHandle_t responseMutex = nullptr;
+static GoalWatch goalWatch;
 
 // ============================================================================
 // HELPER FUNCTIONS
 // ============================================================================
 
-static void buildFullName(char* dest, size_t destSize, const char* part1, const char* part2) {
-    if (!dest || destSize == 0) return;
-    if (part1[0] && part2[0])
-        snprintf(dest, destSize, "%s %s", part1, part2);
-    else
-        snprintf(dest, destSize, "%s%s", part1, part2);
-}
-
-static void buildRosterCache(JsonArray roster, uint32_t gameId) {
-    rosterCache.clear();
-    rosterCache.gameId = gameId;
-    if (roster.isNull()) return;
-    
-    for (JsonObject p : roster) {
-        if (rosterCache.count >= sizeof(rosterCache.players) / sizeof(rosterCache.players[0])) break;
-        
-        int id = p["playerId"] | 0;
-        const char* first = p["firstName"]["default"] | "";
-        const char* last = p["lastName"]["default"] | "";
-        
-        if (id == 0) continue;
-        
-        rosterCache.players[rosterCache.count].id = id;
-        buildFullName(rosterCache.players[rosterCache.count].name, 
-                     sizeof(rosterCache.players[rosterCache.count].name), 
-                     first, last);
-        rosterCache.count++;
-    }
-}
-
-static String resolvePlayerName(const char* apiName, int playerId) {
-    if (apiName && apiName[0]) return String(apiName);
-    const char* cached = rosterCache.lookupName(playerId);
-    return String(cached);
-}
-
 static bool isFinalState(const char* state) {
     if (!state || !state[0]) return false;
     return (strcasecmp(state, "FINAL") == 0) || (strcasecmp(state, "OFF") == 0);
 }
 
-static bool isAllowedRecapChar(char c) {
-    return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == ' ' || c == '-' || c == ':';
-}
-
-static void sanitizeToken(const char* in, char* out, size_t outSize) {
-    if (!out || outSize == 0) return;
-    out[0] = '\0';
-    if (!in || !in[0]) return;
-    size_t o = 0;
-    bool lastSpace = true;
-    for (size_t i = 0; in[i] && o + 1 < outSize; ++i) {
-        char c = (char)toupper((unsigned char)in[i]);
-        if (!isAllowedRecapChar(c)) c = ' ';
-        if (c == ' ') {
-            if (lastSpace) continue;
-            lastSpace = true;
-        } else {
-            lastSpace = false;
-        }
-        out[o++] = c;
-    }
-    while (o > 0 && out[o - 1] == ' ') {
-        --o;
-    }
-    out[o] = '\0';
-}
-
-static void extractLastName(const char* fullName, char* out, size_t outSize) {
-    if (!out || outSize == 0) return;
-    out[0] = '\0';
-    if (!fullName || !fullName[0]) return;
-    const char* last = fullName;
-    for (const char* p = fullName; *p; ++p) {
-        if (*p == ' ') last = p + 1;
-    }
-    strncpy(out, last, outSize - 1);
-    out[outSize - 1] = '\0';
-}
-
-static const char* teamAbbrevForId(int teamId, int awayId, const char* awayAbbrev, int homeId, const char* homeAbbrev) {
-    if (teamId == awayId) return awayAbbrev;
-    if (teamId == homeId) return homeAbbrev;
-    return "";
-}
-
-static void copyRecapName(const String& fullName, char* out, size_t outSize) {
-    char lastName[32];
-    extractLastName(fullName.c_str(), lastName, sizeof(lastName));
-    sanitizeToken(lastName, out, outSize);
-}
-
-static uint8_t buildRecapGoals(JsonDocument& doc,
-    const char* awayAbbrev,
-    const char* homeAbbrev,
-    RecapGoal* outGoals,
-    uint8_t maxGoals) {
-    if (!outGoals || maxGoals == 0) return 0;
-
-    JsonArray plays = doc["plays"];
-    uint8_t goalCount = 0;
-    for (JsonObject play : plays) {
-        const char* type = play["typeDescKey"] | "";
-        if (strcasecmp(type, "goal") != 0) continue;
-        if (goalCount >= maxGoals) break;
-
-        RecapGoal& g = outGoals[goalCount];
-        g.eventId = play["eventId"] | 0;
-        const int teamId = play["details"]["eventOwnerTeamId"] | 0;
-        const char* teamAbbrev = teamAbbrevForId(teamId,
-            (int)(doc["awayTeam"]["id"] | 0), awayAbbrev,
-            (int)(doc["homeTeam"]["id"] | 0), homeAbbrev);
-        sanitizeToken(teamAbbrev, g.teamAbbrev, sizeof(g.teamAbbrev));
-
-        String scorerName = resolvePlayerName(
-            play["details"]["scoringPlayerName"]["default"] | "",
-            play["details"]["scoringPlayerId"] | 0);
-        copyRecapName(scorerName, g.scorer, sizeof(g.scorer));
-
-        String assist1 = resolvePlayerName(
-            play["details"]["assist1PlayerName"]["default"] | "",
-            play["details"]["assist1PlayerId"] | 0);
-        copyRecapName(assist1, g.assist1, sizeof(g.assist1));
-
-        String assist2 = resolvePlayerName(
-            play["details"]["assist2PlayerName"]["default"] | "",
-            play["details"]["assist2PlayerId"] | 0);
-        copyRecapName(assist2, g.assist2, sizeof(g.assist2));
-
-        sanitizeToken(play["timeRemaining"] | "", g.timeRemaining, sizeof(g.timeRemaining));
-        g.period = play["periodDescriptor"]["number"] | 0;
-
-        goalCount++;
-    }
-
-    return goalCount;
-}
-
 static void parseGoalEvent(JsonObject play, GoalInfo& goal) {
     goal.isNew = true;
-    goal.type = play["typeDescKey"] | "";
-    goal.time = play["timeRemaining"] | "";
+    copyField(goal.type, sizeof(goal.type), play["typeDescKey"] | "");
+    copyField(goal.time, sizeof(goal.time), play["timeRemaining"] | "");
     goal.period = play["periodDescriptor"]["number"] | 0;
     goal.eventId = play["eventId"] | 0;
     goal.ownerTeamId = play["details"]["eventOwnerTeamId"] | 0;
     goal.scoringPlayerId = play["details"]["scoringPlayerId"] | 0;
     
     // Resolve player names (API or roster cache)
-    goal.scoringPlayerName = resolvePlayerName(
+    resolvePlayerName(rosterCache, goal.scoringPlayerName, sizeof(goal.scoringPlayerName),
         play["details"]["scoringPlayerName"]["default"] | "",
         goal.scoringPlayerId
     );
-    goal.shootingPlayerName = play["details"]["shootingPlayerName"]["default"] | "";
-    goal.assist1Name = resolvePlayerName(
+    copyField(goal.shootingPlayerName, sizeof(goal.shootingPlayerName),
+        play["details"]["shootingPlayerName"]["default"] | "");
+    resolvePlayerName(rosterCache, goal.assist1Name, sizeof(goal.assist1Name),
         play["details"]["assist1PlayerName"]["default"] | "",
         play["details"]["assist1PlayerId"] | 0
     );
-    goal.assist2Name = resolvePlayerName(
+    resolvePlayerName(rosterCache, goal.assist2Name, sizeof(goal.assist2Name),
         play["details"]["assist2PlayerName"]["default"] | "",
         play["details"]["assist2PlayerId"] | 0
     );
     
-    goal.goalieName = play["details"]["goalieInNetName"]["default"] | "";
-    goal.secondaryType = play["details"]["secondaryType"] | "";
-    goal.shotType = play["details"]["shotType"] | "";
+    copyField(goal.goalieName, sizeof(goal.goalieName), play["details"]["goalieInNetName"]["default"] | "");
+    copyField(goal.secondaryType, sizeof(goal.secondaryType), play["details"]["secondaryType"] | "");
+    copyField(goal.shotType, sizeof(goal.shotType), play["details"]["shotType"] | "");
 }
 
 static void detectNewGoals(JsonArray plays, GoalInfo& goal) {
@@ -271,7 +220,7 @@ static void detectNewGoals(JsonArray plays, GoalInfo& goal) {
         if (state.hadEmptyFetch) {
             for (JsonObject play : plays) {
                 const char* type = play["typeDescKey"] | "";
-                if (String(type).equalsIgnoreCase("goal")) {
+                if (strcasecmp(type, "goal") == 0) {
                     parseGoalEvent(play, goal);
                     break;
                 }
@@ -293,7 +242,7 @@ static void detectNewGoals(JsonArray plays, GoalInfo& goal) {
         if (sortOrder <= state.lastPlaySortOrder) continue;
         
         const char* type = play["typeDescKey"] | "";
-        if (String(type).equalsIgnoreCase("goal")) {
+        if (strcasecmp(type, "goal") == 0) {
             parseGoalEvent(play, goal);
             break; // Only process first new goal
         }
@@ -302,130 +251,254 @@ static void detectNewGoals(JsonArray plays, GoalInfo& goal) {
     state.lastPlaySortOrder = lastSortOrder;
 }
 
+static GameReducer reducer;
+
 // ============================================================================
-// JSON FILTER SETUP
+// GOAL FOLLOW-UP
 // ============================================================================
 
-static void buildPlayByPlayFilter(JsonDocument& f) {
-    f["gameState"] = true;
-    f["startTimeUTC"] = true;
-    f["easternUTCOffset"] = true;
-    f["venueUTCOffset"] = true;
-    f["periodDescriptor"]["number"] = true;
-    f["clock"]["timeRemaining"] = true;
-    f["clock"]["inIntermission"] = true;
-    f["clock"]["running"] = true;
-    f["homeTeam"]["score"] = true;
-    f["homeTeam"]["sog"] = true;
-    f["homeTeam"]["id"] = true;
-    f["homeTeam"]["abbrev"] = true;
-    f["homeTeam"]["commonName"]["default"] = true;
-    f["homeTeam"]["placeName"]["default"] = true;
-    f["awayTeam"]["score"] = true;
-    f["awayTeam"]["sog"] = true;
-    f["awayTeam"]["id"] = true;
-    f["awayTeam"]["abbrev"] = true;
-    f["awayTeam"]["commonName"]["default"] = true;
-    f["awayTeam"]["placeName"]["default"] = true;
-    f["situation"]["homeTeam"]["strength"] = true;
-    f["situation"]["homeTeam"]["situationDescriptions"][0] = true;
-    f["situation"]["awayTeam"]["strength"] = true;
-    f["situation"]["awayTeam"]["situationDescriptions"][0] = true;
-    JsonArray plays = f["plays"].to<JsonArray>();
-    JsonObject p = plays.add<JsonObject>();
-    p["typeDescKey"] = true;
-    p["timeRemaining"] = true;
-    p["periodDescriptor"]["number"] = true;
-    p["eventId"] = true;
-    p["sortOrder"] = true;
-    JsonObject d = p["details"].to<JsonObject>();
-    d["eventOwnerTeamId"] = true;
-    d["scoringPlayerId"] = true;
-    d["scoringPlayerName"]["default"] = true;
-    d["shootingPlayerName"]["default"] = true;
-    d["assist1PlayerName"]["default"] = true;
-    d["assist2PlayerName"]["default"] = true;
-    d["goalieInNetName"]["default"] = true;
-    d["secondaryType"] = true;
-    d["shotType"] = true;
-    d["assist1PlayerId"] = true;
-    d["assist2PlayerId"] = true;
-    d["scoringPlayerId"] = true;
-
-    JsonArray roster = f["rosterSpots"].to<JsonArray>();
-    JsonObject r = roster.add<JsonObject>();
-    r["playerId"] = true;
-    r["firstName"]["default"] = true;
-    r["lastName"]["default"] = true;
-    r["lastName"]["default"] = true;
+// Reducer goal entries keep recap-style names; refresh them alongside
+static void refreshReducerGoal(uint32_t eventId, const WatchedGoal& w) {
+    for (uint8_t i = 0; i < reducer.goalCount; ++i) {
+        RecapGoal& g = reducer.goals[i];
+        if (g.eventId != eventId) continue;
+        copyRecapName(w.scorer, g.scorer, sizeof(g.scorer));
+        copyRecapName(w.assist1, g.assist1, sizeof(g.assist1));
+        copyRecapName(w.assist2, g.assist2, sizeof(g.assist2));
+        return;
+    }
+}
+
+// Re-reads scorer and assists of watched goals and pushes any change to
+// the data model, which also updates a goal animation already playing.
+static void refreshWatchedGoals(JsonArray plays, uint32_t gameId) {
+    const uint32_t now = millis();
+    size_t active = goalWatchExpire(goalWatch, now);
+    if (active == 0 || plays.isNull()) return;
+
+    for (JsonObject play : plays) {
+        WatchedGoal* w = goalWatchFind(goalWatch, play["eventId"] | 0);
+        if (!w) continue;
+
+        JsonObject details = play["details"];
+        char scorer[32], assist1[32], assist2[32];
+        resolvePlayerName(rosterCache, scorer, sizeof(scorer),
+            details["scoringPlayerName"]["default"] | "",
+            details["scoringPlayerId"] | 0);
+        resolvePlayerName(rosterCache, assist1, sizeof(assist1),
+            details["assist1PlayerName"]["default"] | "",
+            details["assist1PlayerId"] | 0);
+        resolvePlayerName(rosterCache, assist2, sizeof(assist2),
+            details["assist2PlayerName"]["default"] | "",
+            details["assist2PlayerId"] | 0);
+        if (goalWatchSetNames(*w, scorer, assist1, assist2)) {
+            LOGI("pbp", "goal %u updated: scorer='%s' a1='%s' a2='%s' after %lums",
+                (unsigned)w->eventId, scorer, assist1, assist2, (unsigned long)(now - w->announcedMs));
+            refreshReducerGoal(w->eventId, *w);
+            dataModelUpdateGoalDetails(gameId, w->eventId, scorer, assist1, assist2);
+        }
+        if (--active == 0) break;
+    }
 }
 
 // ============================================================================
 // HTTP REQUEST & PARSING
 // ============================================================================
 
-static DeserializationError fetchAndParseJson(const char* url, JsonDocument& doc, JsonDocument& filterDoc) {
+// Receive task: drains the TLS stream into the ring on the network core
+// while the poll task parses from the other end. A full ring stalls the
+// receiver until the parser catches up.
+static void pbpReceiveTask(void*) {
+    HeapTagScope heapTag(HeapTag::Pbp);
+    WiFiClient* client = receiver.client;
+    unsigned long lastDataMs = millis();
+
+    while (!pbpRing.isReadAborted()) {
+        if (receiver.contentLength >= 0 && receiver.bytesIn >= (size_t)receiver.contentLength) break;
+
+        int avail = client->available();
+        if (avail <= 0) {
+            if (!client->connected()) break;
+            if (millis() - lastDataMs >= PBP_STALL_TIMEOUT_MS) break;
+            vTaskDelay(1);
+            continue;
+        }
+
+        uint8_t* dst = nullptr;
+        size_t space = pbpRing.writeSpan(dst);
+        if (space == 0) {
+            vTaskDelay(1);
+            continue;
+        }
+        if ((size_t)avail < space) space = (size_t)avail;
+
+        int got = client->read(dst, space);
+        if (got > 0) {
+            pbpRing.commitWrite((size_t)got);
+            receiver.bytesIn += (size_t)got;
+            lastDataMs = millis();
+        }
+    }
+
+    pbpRing.closeWrite();
+    xSemaphoreGive(receiver.done);
+    vTaskDelete(nullptr);
+}
+
+static DeserializationError parseJsonFromStream(Stream& source, JsonDocument& doc, JsonDocument& filterDoc,
+    size_t sectionCount, ParseStats& stats) {
+    TimedStream s(source);
+    // Skip any garbage before JSON
+    uint32_t start = millis();
+    int c = -1;
+    size_t skipped = 0;
+
+    while ((millis() - start) < PBP_STALL_TIMEOUT_MS) {
+        if (s.available()) {
+            c = s.read();
+            if (c == '{') break;
+            skipped++;
+        } else {
+            delay(1);
+        }
+    }
+
+    if (c != '{') {
+        LOGW("pbp", "no JSON start (skipped=%u)", (unsigned)skipped);
+        return DeserializationError::InvalidInput;
+    }
+    if (skipped > 0) {
+        LOGD("pbp", "skipped=%u before JSON", (unsigned)skipped);
+    }
+    PrefixStream ps(s, '{');
+    SectionGateStream gate(ps, PBP_SECTIONS, sectionGateOff ? 0 : sectionCount, PBP_OPTIONAL_SECTIONS);
+    const uint32_t parseStartUs = micros();
+    const uint32_t waitStartUs = s.waitUs();
+    DeserializationError err = deserializeJson(doc, gate,
+        DeserializationOption::Filter(filterDoc),
+        DeserializationOption::NestingLimit(16));
+    stats.parseUs = (micros() - parseStartUs) - (s.waitUs() - waitStartUs);
+    stats.bytesParsed = skipped + gate.bytesRead();
+    stats.bytesReceived = s.bytesRead();
+    stats.closedEarly = gate.closedEarly();
+    if (gate.outOfOrder() && !sectionGateOff) {
+        sectionGateOff = true;
+        LOGW("pbp", "feed sections out of order, early close disabled");
+    }
+    return err;
+}
+
+static DeserializationError parseHttpBody(HTTPClient& http, JsonDocument& doc, JsonDocument& filterDoc,
+    size_t sectionCount, ParseStats& stats) {
+#if PBP_PIPELINED_FETCH
+    pbpRing.reset();
+    receiver.client = http.getStreamPtr();
+    receiver.contentLength = http.getSize();
+    receiver.bytesIn = 0;
+
+    if (xTaskCreatePinnedToCore(pbpReceiveTask, "pbp_rx", PBP_RX_STACK, NULL, 2, NULL, PBP_RX_CORE) == pdPASS) {
+        RingStream rs(pbpRing, PBP_STALL_TIMEOUT_MS);
+        DeserializationError err = parseJsonFromStream(rs, doc, filterDoc, sectionCount, stats);
+        pbpRing.abortRead();
+        xSemaphoreTake(receiver.done, portMAX_DELAY);
+        stats.bytesReceived = receiver.bytesIn;
+        return err;
+    }
+    LOGW("pbp", "pbp_rx task creation failed, parsing inline");
+#endif
+    return parseJsonFromStream(*http.getStreamPtr(), doc, filterDoc, sectionCount, stats);
+}
+
+// responseMs is set to when the headers of the parsed response arrived
+static DeserializationError fetchAndParseJson(const char* url, JsonDocument& doc, JsonDocument& filterDoc,
+    size_t sectionCount, uint32_t& responseMs) {
     DeserializationError err = DeserializationError::InvalidInput;
     int code = -1;
     
-    for (int attempt = 0; attempt < PBP_MAX_RETRIES; attempt++) {
+    // One re-issue per fetch on a deadline miss, on top of the retries
+    UpstreamRetryLoop loop(PBP_MAX_RETRIES);
+    while (loop.next()) {
+        const int attempt = loop.attempt();
+        // The re-issue continues a request the gate already let through
+        if (!loop.reissuing() && !upstreamAllowRequest()) {
+            LOGW("pbp", "upstream circuit open, skipping fetch");
+            break;
+        }
+
+        fetchAttempts.inc();
+        NetTrace trace;
+        netTraceBegin(trace, "pbp", attempt);
         playByPlayClient.stop();
         HTTPClient http;
-        http.setTimeout(30000);
+        const uint32_t timeoutMs = upstreamRequestTimeoutMs();
+        http.setTimeout((uint16_t)timeoutMs);
+        http.setConnectTimeout((int32_t)timeoutMs);
         http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
 
         if (!http.begin(playByPlayClient, url)) {
-            Serial.printf("[pbp] attempt %d: http.begin failed\n", attempt + 1);
-            if (attempt < PBP_MAX_RETRIES - 1) delay(PBP_RETRY_BASE_MS);
+            LOGW("pbp", "attempt %d: http.begin failed", attempt + 1);
+            fetchFailures.inc(0);
+            netTraceEnd(trace, 0, false, 0);
+            if (upstreamRecordAttemptFailure(loop, false) == RetryStep::Backoff) {
+                delay(upstreamRetryDelayMs(PBP_RETRY_BASE_MS, attempt));
+            }
             continue;
         }
         
+        netTracePreconnect(trace, playByPlayClient, NHL_API_HOST, 443, timeoutMs);
         http.addHeader("User-Agent", "Mozilla/5.0 (compatible; Scoreboard/1.0)");
+        const uint32_t startMs = millis();
         code = http.GET();
+        const uint32_t ttfbMs = millis() - startMs;
+        netTraceMark(trace, NetPhase::Ttfb);
         
         if (code != HTTP_CODE_OK) {
-            Serial.printf("[pbp] attempt %d: GET code=%d\n", attempt + 1, code);
+            LOGW("pbp", "attempt %d: GET code=%d after %lums",
+                attempt + 1, code, (unsigned long)ttfbMs);
+            fetchFailures.inc(code);
+            netTraceEnd(trace, code, false, 0);
             http.end();
-            if (attempt < PBP_MAX_RETRIES - 1) delay(PBP_RETRY_BASE_MS);
+            // A read timeout is past the p95-derived deadline: re-issued at once
+            if (upstreamRecordAttemptFailure(loop, code == HTTPC_ERROR_READ_TIMEOUT) == RetryStep::Backoff) {
+                delay(upstreamRetryDelayMs(PBP_RETRY_BASE_MS, attempt));
+            }
             continue;
         }
 
-        // Skip any garbage before JSON
-        Stream& s = *http.getStreamPtr();
-        uint32_t start = millis();
-        int c = -1;
-        size_t skipped = 0;
-        
-        while ((millis() - start) < 5000) {
-            if (s.available()) {
-                c = s.read();
-                if (c == '{') break;
-                skipped++;
-            } else {
-                delay(1);
-            }
-        }
-        
-        if (c != '{') {
-            err = DeserializationError::InvalidInput;
-            Serial.printf("[pbp] no JSON start (skipped=%u)\n", (unsigned)skipped);
+        ttfbMsHist.observe(ttfbMs);
+        ParseStats stats = {};
+        RetryStep step = RetryStep::GiveUp;
+        err = parseHttpBody(http, doc, filterDoc, sectionCount, stats);
+        netTraceMarkBody(trace, stats.parseUs);
+        netTraceEnd(trace, code, !err, (uint32_t)stats.bytesReceived);
+        fetchBytes.inc((uint32_t)stats.bytesReceived);
+        if (!err) {
+            responseMs = startMs + ttfbMs;
+            upstreamRecordSuccess(ttfbMs);
+            parseMsHist.observe(millis() - startMs - ttfbMs);
+            LOGD("pbp", "fetch+parse ms=%lu ttfb=%lu parsed=%u received=%u early=%d (%s)",
+                (unsigned long)(millis() - startMs),
+                (unsigned long)ttfbMs,
+                (unsigned)stats.bytesParsed,
+                (unsigned)stats.bytesReceived,
+                stats.closedEarly ? 1 : 0,
+                PBP_PIPELINED_FETCH ? "pipelined" : "inline");
         } else {
-            if (skipped > 0) {
-                Serial.printf("[pbp] skipped=%u before JSON\n", (unsigned)skipped);
-            }
-            PrefixStream ps(s, '{');
-            err = deserializeJson(doc, ps,
-                DeserializationOption::Filter(filterDoc),
-                DeserializationOption::NestingLimit(16));
+            step = upstreamRecordAttemptFailure(loop, false);
+            jsonErrors.inc();
         }
         
+        if (stats.closedEarly) {
+            // Drop the connection instead of draining the unneeded tail
+            playByPlayClient.stop();
+        }
         http.end();
         playByPlayClient.stop();
         delay(50);
         
         if (!err) break;
-        Serial.printf("[pbp] attempt %d: parse %s\n", attempt + 1, err.c_str());
-        if (attempt < PBP_MAX_RETRIES - 1) delay(PBP_RETRY_BASE_MS);
+        LOGW("pbp", "attempt %d: parse %s", attempt + 1, err.c_str());
+        if (step == RetryStep::Backoff) delay(upstreamRetryDelayMs(PBP_RETRY_BASE_MS, attempt));
     }
     
     return err;
@@ -441,29 +514,42 @@ static bool fetchPlayByPlayOnce(uint32_t gameId) {
     char url[128];
     snprintf(url, sizeof(url), NHL_PBP_URL_FMT, (unsigned)gameId);
 
-    Serial.printf("[pbp] fetch start game=%u\n", (unsigned)gameId);
+    LOGD("pbp", "fetch start game=%u", (unsigned)gameId);
     state.lastFetchMs = millis();
+    // Full clock and no modem sleep for the TLS handshake, receive and parse
+    DvfsNetworkBoost boost;
     
-    // Prepare filter
-    JsonDocument doc;
+    // Rewind the per-poll arena; both documents must be empty first
+    pbpDoc.clear();
+    pbpOut.clear();
+    pbpArena.reset();
+    JsonDocument& doc = pbpDoc;
+
+    // Prepare filters; rosterSpots is only requested until it is cached
     static JsonDocument filterDoc;
+    static JsonDocument filterNoRosterDoc;
     static bool filterReady = false;
     if (!filterReady) {
-        buildPlayByPlayFilter(filterDoc);
+        buildPlayByPlayFilter(filterDoc, true);
+        buildPlayByPlayFilter(filterNoRosterDoc, false);
         filterReady = true;
     }
+    const bool needRoster = (gameId != rosterCache.gameId || rosterCache.count == 0);
     
     // Fetch and parse
-    DeserializationError err = fetchAndParseJson(url, doc, filterDoc);
+    uint32_t responseMs = 0;
+    DeserializationError err = fetchAndParseJson(url, doc,
+        needRoster ? filterDoc : filterNoRosterDoc,
+        needRoster ? PBP_SECTION_COUNT : PBP_SECTION_COUNT_NO_ROSTER,
+        responseMs);
     if (err) {
         state.lastFailMs = millis();
         return false;
     }
 
     // Build roster cache if needed
-    JsonArray roster = doc["rosterSpots"];
-    if (gameId != rosterCache.gameId || rosterCache.count == 0) {
-        buildRosterCache(roster, gameId);
+    if (needRoster) {
+        buildRosterCache(rosterCache, doc["rosterSpots"], gameId);
     }
 
     // Build team names
@@ -481,8 +567,8 @@ static bool fetchPlayByPlayOnce(uint32_t gameId) {
     bool awayPP = false, homePP = false;
     JsonObject situation = doc["situation"];
     if (!situation.isNull()) {
-        awayPP = String(situation["awayTeam"]["situationDescriptions"][0] | "").equalsIgnoreCase("PP");
-        homePP = String(situation["homeTeam"]["situationDescriptions"][0] | "").equalsIgnoreCase("PP");
+        awayPP = strcasecmp(situation["awayTeam"]["situationDescriptions"][0] | "", "PP") == 0;
+        homePP = strcasecmp(situation["homeTeam"]["situationDescriptions"][0] | "", "PP") == 0;
     }
 
     // Detect new goals
@@ -491,10 +577,11 @@ static bool fetchPlayByPlayOnce(uint32_t gameId) {
     detectNewGoals(plays, goal);
 
     if (goal.isNew) {
-        Serial.printf("[pbp] GOAL detected: scorer='%s' a1='%s' a2='%s' eventId=%d\n",
-            goal.scoringPlayerName.c_str(),
-            goal.assist1Name.c_str(),
-            goal.assist2Name.c_str(),
+        goalEvents.inc();
+        LOGI("pbp", "GOAL detected: scorer='%s' a1='%s' a2='%s' eventId=%d",
+            goal.scoringPlayerName,
+            goal.assist1Name,
+            goal.assist2Name,
             goal.eventId);
     }
 
@@ -509,20 +596,38 @@ static bool fetchPlayByPlayOnce(uint32_t gameId) {
     const uint16_t awaySog = doc["awayTeam"]["sog"] | 0;
     const uint16_t homeSog = doc["homeTeam"]["sog"] | 0;
 
-    bool recapReady = false;
-    char recapText[kRecapTextMax] = {0};
-    RecapGoal recapGoals[kMaxRecapGoals] = {};
-    uint8_t recapGoalCount = 0;
-    if (isFinalState(gameState)) {
-        recapReady = true;
-        recapGoalCount = buildRecapGoals(doc,
-            awayAbbrev,
-            homeAbbrev,
-            recapGoals,
-            kMaxRecapGoals);
+    // Fold new plays into the per-game aggregates
+    const TeamContext ctx = {gameId, awayId, homeId, awayAbbrev, homeAbbrev, &rosterCache,
+        {shotHeatmapAdd, shotHeatmapReset}};
+    const uint32_t rebuildsBefore = reducer.rebuilds;
+    const uint32_t reduceStartUs = micros();
+    const bool finalState = isFinalState(gameState);
+    uint32_t playsApplied = 0;
+    if (finalState && !reducer.reconciled) {
+        reducerReconcileFinal(reducer, plays, ctx);
+        playsApplied = reducer.playsReduced;
+    } else {
+        playsApplied = reducerConsume(reducer, plays, ctx);
     }
+    reducer.stats.leaderCount = reducerLeaders(reducer, reducer.stats.leaders, kMaxLeaders);
+    const uint32_t reduceUs = micros() - reduceStartUs;
+    if (reducer.rebuilds != rebuildsBefore) {
+        LOGI("pbp", "play feed rewound, stats rebuilt from %u plays", (unsigned)playsApplied);
+    }
+
+    PenaltyEntry penalties[kMaxPenalties];
+    const uint8_t penaltyCount = reducerActivePenalties(reducer, period,
+        parseClockTenths(doc["clock"]["timeRemaining"] | ""),
+        penalties, kMaxPenalties);
+    const uint16_t ppTenths = (awayPP || homePP) ? parseClockTenths(situation["timeRemaining"] | "") : 0;
 
-    // Update data model
+    const bool recapReady = finalState;
+    const char* recapText = "";
+
+    // Update data model. Penalties go first so the scene picks them up
+    // together with the clock sample they are relative to.
+    dataModelUpdatePenalties(gameId, ppTenths, penalties, penaltyCount);
+    dataModelUpdateStats(gameId, reducer.stats);
     dataModelUpdateFromPbp(
         gameId,
         gameState,
@@ -531,6 +636,8 @@ static bool fetchPlayByPlayOnce(uint32_t gameId) {
         period,
         doc["clock"]["timeRemaining"] | "",
         doc["clock"]["inIntermission"] | false,
+        doc["clock"]["running"] | false,
+        responseMs,
         awayId,
         awayAbbrev,
         awayName,
@@ -544,21 +651,27 @@ static bool fetchPlayByPlayOnce(uint32_t gameId) {
         goal.isNew,
         (uint32_t)goal.eventId,
         (uint32_t)goal.ownerTeamId,
-        goal.scoringPlayerName.c_str(),
-        goal.assist1Name.c_str(),
-        goal.assist2Name.c_str(),
-        goal.time.c_str(),
+        goal.scoringPlayerName,
+        goal.assist1Name,
+        goal.assist2Name,
+        goal.time,
         (uint8_t)goal.period,
         awayPP,
         homePP,
         recapReady,
         recapText,
-        recapGoalCount,
-        recapGoals
+        recapReady ? reducer.goalCount : 0,
+        reducer.goals
     );
 
+    if (goal.isNew) {
+        goalWatchAdd(goalWatch, (uint32_t)goal.eventId, goal.scoringPlayerName,
+            goal.assist1Name, goal.assist2Name, millis());
+    }
+    refreshWatchedGoals(plays, gameId);
+
     // Build API response
-    JsonDocument out;
+    JsonDocument& out = pbpOut;
     JsonObject root = out.to<JsonObject>();
     root["gameId"] = gameId;
     root["gameState"] = doc["gameState"] | "";
@@ -571,11 +684,50 @@ static bool fetchPlayByPlayOnce(uint32_t gameId) {
     
     root["home"]["score"] = doc["homeTeam"]["score"] | 0;
     root["away"]["score"] = doc["awayTeam"]["score"] | 0;
+
+    JsonObject stats = root["stats"].to<JsonObject>();
+    const TeamGameStats* sides[2] = {&reducer.stats.away, &reducer.stats.home};
+    const char* sideNames[2] = {"away", "home"};
+    for (size_t i = 0; i < 2; ++i) {
+        JsonObject t = stats[sideNames[i]].to<JsonObject>();
+        JsonArray shots = t["shots"].to<JsonArray>();
+        JsonArray goals = t["goals"].to<JsonArray>();
+        for (size_t p = 0; p < kStatPeriods; ++p) {
+            shots.add(sides[i]->shots[p]);
+            goals.add(sides[i]->goals[p]);
+        }
+        t["pim"] = sides[i]->pim;
+        t["hits"] = sides[i]->hits;
+        t["faceoffWins"] = sides[i]->faceoffWins;
+    }
+    JsonArray leaders = stats["leaders"].to<JsonArray>();
+    for (uint8_t i = 0; i < reducer.stats.leaderCount; ++i) {
+        JsonObject l = leaders.add<JsonObject>();
+        l["name"] = reducer.stats.leaders[i].name;
+        l["teamId"] = reducer.stats.leaders[i].teamId;
+        l["g"] = reducer.stats.leaders[i].goals;
+        l["a"] = reducer.stats.leaders[i].assists;
+    }
+
+    if (ppTenths > 0 || penaltyCount > 0) {
+        JsonObject pp = root["powerPlay"].to<JsonObject>();
+        pp["team"] = awayPP ? awayAbbrev : (homePP ? homeAbbrev : "");
+        pp["timeRemaining"] = situation["timeRemaining"] | "";
+        JsonArray box = pp["box"].to<JsonArray>();
+        for (uint8_t i = 0; i < penaltyCount; ++i) {
+            JsonObject b = box.add<JsonObject>();
+            b["teamId"] = penalties[i].teamId;
+            b["player"] = penalties[i].player;
+            b["infraction"] = penalties[i].infraction;
+            b["duration"] = penalties[i].durationMin;
+            b["remainingTenths"] = penalties[i].remainingTenths;
+        }
+    }
     
     // Last play info
     if (!plays.isNull() && plays.size() > 0) {
         JsonObject lastPlay = plays[(int)plays.size() - 1];
-        Serial.printf("[pbp] lastPlay type=%s period=%d time=%s\n",
+        LOGD("pbp", "lastPlay type=%s period=%d time=%s",
             lastPlay["typeDescKey"] | "",
             (int)(lastPlay["periodDescriptor"]["number"] | 0),
             lastPlay["timeRemaining"] | "");
@@ -617,10 +769,25 @@ static bool fetchPlayByPlayOnce(uint32_t gameId) {
     }
     root["goalIsNew"] = goal.isNew;
 
-    serializeJson(out, state.lastGoodResponse);
+    const size_t responseLen = measureJson(out);
+    if (responseLen < sizeof(state.lastGoodResponse)) {
+        xSemaphoreTake(responseMutex, portMAX_DELAY);
+        state.lastGoodResponseLen = serializeJson(out, state.lastGoodResponse, sizeof(state.lastGoodResponse));
+        xSemaphoreGive(responseMutex);
+    } else {
+        LOGW("pbp", "response too large (%u bytes), keeping previous", (unsigned)responseLen);
+    }
     state.lastFetchMs = millis();
     state.lastFailMs = 0;
-    Serial.printf("[pbp] fetch ok bytes=%u\n", (unsigned)state.lastGoodResponse.length());
+    bootMark(BootPhase::FirstLiveData);
+    LOGI("pbp", "fetch ok bytes=%u reduce=%uus plays=%u/%u arena=%u/%u fallbacks=%u",
+        (unsigned)responseLen,
+        (unsigned)reduceUs,
+        (unsigned)playsApplied,
+        (unsigned)reducer.playsReduced,
+        (unsigned)pbpArena.peak(),
+        (unsigned)pbpArena.capacity(),
+        (unsigned)pbpArena.fallbacks());
     return true;
 }
 
@@ -629,6 +796,7 @@ static bool fetchPlayByPlayOnce(uint32_t gameId) {
 // ============================================================================
 
 static void playByPlayPollTask(void*) {
+    HeapTagScope heapTag(HeapTag::Pbp);
     for (;;) {
         uint32_t gameId = apiServerGetSelectedGameId();
         
@@ -637,16 +805,40 @@ static void playByPlayPollTask(void*) {
             continue;
         }
         
+        // Park until the link supervisor reports the network is back
+        if (!wifiLinkIsUp()) {
+            LOGI("pbp", "waiting for WiFi");
+            wifiLinkWaitUp(portMAX_DELAY);
+            state.lastFailMs = 0;
+            continue;
+        }
+
+        // Standby: a slow heartbeat keeps the reducer near live so waking
+        // does not replay a whole period; 0 stops polling outright
+        if (powerIsStandby() && gameId == state.gameId) {
+            const uint32_t heartbeatMs = powerGetPolicy().pbpHeartbeatMs;
+            if (powerWaitActive(heartbeatMs ? heartbeatMs : portMAX_DELAY)) continue;
+            goalWatch.followUpPolls = 0;
+            fetchPlayByPlayOnce(gameId);
+            continue;
+        }
+
         // New game selected - reset state
         if (gameId != state.gameId) {
             state.gameId = gameId;
-            state.lastGoodResponse = "";
+            xSemaphoreTake(responseMutex, portMAX_DELAY);
+            state.lastGoodResponse[0] = '\0';
+            state.lastGoodResponseLen = 0;
+            xSemaphoreGive(responseMutex);
             state.lastFailMs = 0;
             state.lastFetchMs = 0;
             state.lastPlaySortOrder = -1;
             state.primed = false;
             state.hadEmptyFetch = false;
             rosterCache.clear();
+            reducerReset(reducer, gameId);
+            shotHeatmapReset();
+            goalWatchClear(goalWatch);
             
             fetchPlayByPlayOnce(gameId);
             vTaskDelay(PBP_MIN_INTERVAL_MS / portTICK_PERIOD_MS);
@@ -663,7 +855,15 @@ static void playByPlayPollTask(void*) {
         }
         
         fetchPlayByPlayOnce(gameId);
-        vTaskDelay(PBP_MIN_INTERVAL_MS / portTICK_PERIOD_MS);
+        // Short burst after a goal so late assists reach the animation
+        const bool followUp = goalWatch.followUpPolls > 0;
+        const uint32_t nextPollMs = goalWatchNextPollDelayMs(goalWatch, PBP_MIN_INTERVAL_MS);
+        if (followUp) {
+            state.followUpRequests++;
+            LOGD("pbp", "goal follow-up poll, %u left (follow-ups=%u)",
+                (unsigned)goalWatch.followUpPolls, (unsigned)state.followUpRequests);
+        }
+        vTaskDelay(nextPollMs / portTICK_PERIOD_MS);
     }
 }
 
@@ -672,8 +872,14 @@ static void playByPlayPollTask(void*) {
 // ============================================================================
 
 static void handleApiPlayByPlay() {
-    if (state.lastGoodResponse.length() > 0) {
-        playByPlayServer->send(200, "application/json", state.lastGoodResponse);
+    String resp;
+    xSemaphoreTake(responseMutex, portMAX_DELAY);
+    if (state.lastGoodResponseLen > 0) {
+        resp = state.lastGoodResponse;
+    }
+    xSemaphoreGive(responseMutex);
+    if (resp.length() > 0) {
+        playByPlayServer->send(200, "application/json", resp);
         return;
     }
     playByPlayServer->send(503, "application/json", "{\"error\":\"warming\"}");
@@ -688,9 +894,22 @@ void playByPlayServiceInit(WebServer& server) {
     playByPlayClient.setInsecure();
     playByPlayClient.setTimeout(30);
     
+    receiver.done = xSemaphoreCreateBinary();
+    responseMutex = xSemaphoreCreateMutex();
+
+    pbpArenaBlock = (uint8_t*)heap_caps_malloc(PBP_ARENA_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (pbpArenaBlock) {
+        pbpArena.attach(pbpArenaBlock, PBP_ARENA_SIZE);
+    } else {
+        Serial.println("Warn: pbp arena unavailable, JSON documents will use the heap");
+    }
+    upstreamHealthInit();
+    netTraceInit();
+    shotHeatmapInit();
+    
     playByPlayServer->on("/api/playbyplay", HTTP_GET, handleApiPlayByPlay);
     
-    if (xTaskCreate(playByPlayPollTask, "pbp_poll", 16384, NULL, 1, NULL) != pdPASS) {
+    if (xTaskCreatePinnedToCore(playByPlayPollTask, "pbp_poll", 16384, NULL, 1, NULL, PBP_PARSE_CORE) != pdPASS) {
         Serial.println("Warn: pbp_poll task creation failed");
     }
 }
@@ -0,0 +1,136 @@
+#include "power_manager.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <freertos/semphr.h>
+
+#include "dvfs.h"
+#include "display/display_manager.h"
+
+namespace {
+    constexpr EventBits_t ACTIVE_BIT = 1 << 0;
+
+    EventGroupHandle_t powerEvents = nullptr;
+    SemaphoreHandle_t powerMutex = nullptr;
+
+    PowerPolicy policy = {true, 300000};
+    PowerState state = PowerState::Active;
+
+    uint32_t standbyEntries = 0;
+    uint32_t standbySinceMs = 0;
+    uint32_t totalStandbyMs = 0;
+    uint32_t lastEnterMs = 0;
+    uint32_t lastWakeMs = 0;
+    bool panelReleased = false;
+
+    void lock() {
+        if (powerMutex) xSemaphoreTake(powerMutex, portMAX_DELAY);
+    }
+
+    void unlock() {
+        if (powerMutex) xSemaphoreGive(powerMutex);
+    }
+
+    void enterStandby() {
+        const uint32_t start = millis();
+        // Park the pollers before the panel goes dark: they check the bit
+        // before each poll, so no new schedule or play-by-play cycle starts
+        // after this. A fetch already in flight still finishes, possibly at
+        // the standby clock, and the PBP heartbeat polls in standby anyway.
+        xEventGroupClearBits(powerEvents, ACTIVE_BIT);
+        displaySetEnabled(false, policy.releasePanel);
+        dvfsSetStandby(true);
+
+        lock();
+        panelReleased = policy.releasePanel;
+        standbyEntries++;
+        standbySinceMs = millis();
+        lastEnterMs = standbySinceMs - start;
+        unlock();
+        Serial.printf("[power] standby in %lums (cpu=%uMHz panel=%s)\n",
+            (unsigned long)lastEnterMs, (unsigned)getCpuFrequencyMhz(),
+            policy.releasePanel ? "released" : "blanked");
+    }
+
+    void exitStandby() {
+        const uint32_t start = millis();
+        dvfsSetStandby(false);
+        displaySetEnabled(true);
+        xEventGroupSetBits(powerEvents, ACTIVE_BIT);
+
+        lock();
+        const uint32_t now = millis();
+        totalStandbyMs += now - standbySinceMs;
+        lastWakeMs = now - start;
+        panelReleased = false;
+        unlock();
+        Serial.printf("[power] awake in %lums\n", (unsigned long)lastWakeMs);
+    }
+
+    void apply(PowerEvent event) {
+        const PowerState next = powerNextState(state, event);
+        if (next == state) return;
+        if (next == PowerState::Standby) {
+            enterStandby();
+        } else {
+            exitStandby();
+        }
+        lock();
+        state = next;
+        unlock();
+    }
+}
+
+void powerManagerInit() {
+    if (!powerMutex) {
+        powerMutex = xSemaphoreCreateMutex();
+    }
+    if (!powerEvents) {
+        powerEvents = xEventGroupCreate();
+        xEventGroupSetBits(powerEvents, ACTIVE_BIT);
+    }
+}
+
+void powerRequestStandby() {
+    if (!powerEvents) return;
+    apply(PowerEvent::StandbyRequested);
+}
+
+void powerRequestWake() {
+    if (!powerEvents) return;
+    apply(PowerEvent::WakeRequested);
+}
+
+bool powerIsStandby() {
+    return powerEvents && (xEventGroupGetBits(powerEvents) & ACTIVE_BIT) == 0;
+}
+
+bool powerWaitActive(uint32_t timeoutMs) {
+    if (!powerEvents) return true;
+    const TickType_t ticks = timeoutMs == portMAX_DELAY ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs);
+    const EventBits_t bits = xEventGroupWaitBits(powerEvents, ACTIVE_BIT, pdFALSE, pdTRUE, ticks);
+    return (bits & ACTIVE_BIT) != 0;
+}
+
+const PowerPolicy& powerGetPolicy() {
+    return policy;
+}
+
+void powerSetReleasePanel(bool release) {
+    lock();
+    policy.releasePanel = release;
+    unlock();
+}
+
+void powerGetStats(PowerStats& out) {
+    lock();
+    out.state = state;
+    out.standbyEntries = standbyEntries;
+    out.standbyForMs = state == PowerState::Standby ? millis() - standbySinceMs : 0;
+    out.totalStandbyMs = totalStandbyMs;
+    out.lastEnterMs = lastEnterMs;
+    out.lastWakeMs = lastWakeMs;
+    out.panelReleased = panelReleased;
+    unlock();
+    out.cpuMhz = (uint16_t)getCpuFrequencyMhz();
+}
@@ -0,0 +1,21 @@
+#include "power_state.h"
+
+PowerState powerNextState(PowerState current, PowerEvent event) {
+    switch (event) {
+        case PowerEvent::StandbyRequested:
+            return PowerState::Standby;
+        case PowerEvent::WakeRequested:
+            return PowerState::Active;
+    }
+    return current;
+}
+
+const char* powerStateName(PowerState state) {
+    switch (state) {
+        case PowerState::Active:
+            return "active";
+        case PowerState::Standby:
+            return "standby";
+    }
+    return "?";
+}
@@ -5,18 +5,33 @@
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <freertos/task.h>
+#include <strings.h>
 
 #include "api_server.h"
+#include "boot.h"
+#include "dvfs.h"
+#include "heap_tag.h"
+#include "logger.h"
+#include "metrics.h"
+#include "net_trace.h"
+#include "off_hours.h"
 #include "prefix_stream.h"
+#include "timed_stream.h"
+#include "time_utils.h"
+#include "power_manager.h"
+#include "upstream_health.h"
+#include "wifi_link.h"
 
 // ============================================================================
 // CONSTANTS
 // ============================================================================
+static const char* NHL_API_HOST = "api-web.nhle.com";
 static const char* NHL_SCHEDULE_URL = "https://api-web.nhle.com/v1/scoreboard/now";
 static const unsigned long SCHEDULE_MIN_INTERVAL_MS = 30000;
 static const unsigned long SCHEDULE_FAIL_BACKOFF_MS = 30000;
 static const int SCHEDULE_MAX_RETRIES = 5;
 static const unsigned long SCHEDULE_RETRY_BASE_MS = 700;
+static const size_t SCHEDULE_MAX_UPCOMING = 64;
 
 // ============================================================================
 // DATA STRUCTURES
@@ -42,6 +57,20 @@ static WebServer* scheduleServer = nullptr;
 static WiFiClientSecure scheduleClient;
 static ScheduleState state;
 
+static const uint32_t FETCH_MS_BOUNDS[] = {100, 250, 500, 1000, 2000, 5000, 10000};
+static MetricCounter fetchAttempts("scoreboard_schedule_fetch_attempts_total",
+    "Schedule HTTP attempts");
+static MetricLabeledCounter fetchFailures("scoreboard_schedule_fetch_failures_total",
+    "Schedule attempts without a 200, by HTTP code (0 = not started, <0 = client error)", "code");
+static MetricCounter fetchBytes("scoreboard_schedule_bytes_total",
+    "Schedule body bytes read");
+static MetricCounter jsonErrors("scoreboard_schedule_json_errors_total",
+    "Schedule bodies that did not parse (including no JSON start)");
+static MetricHistogram ttfbMsHist("scoreboard_schedule_ttfb_ms",
+    "Schedule time to first byte", FETCH_MS_BOUNDS, 7);
+static MetricHistogram parseMsHist("scoreboard_schedule_parse_ms",
+    "Schedule body receive + parse time", FETCH_MS_BOUNDS, 7);
+
 // ============================================================================
 // HELPER FUNCTIONS
 // ============================================================================
@@ -116,34 +145,62 @@ static DeserializationError fetchAndParseJson(JsonDocument& doc, JsonDocument& f
     DeserializationError err = DeserializationError::InvalidInput;
     int code = -1;
     
-    for (int attempt = 0; attempt < SCHEDULE_MAX_RETRIES; attempt++) {
+    // One re-issue per fetch on a deadline miss, on top of the retries
+    UpstreamRetryLoop loop(SCHEDULE_MAX_RETRIES);
+    while (loop.next()) {
+        const int attempt = loop.attempt();
+        // The re-issue continues a request the gate already let through
+        if (!loop.reissuing() && !upstreamAllowRequest()) {
+            LOGW("schedule", "upstream circuit open, skipping fetch");
+            break;
+        }
+
+        fetchAttempts.inc();
+        NetTrace trace;
+        netTraceBegin(trace, "schedule", attempt);
         scheduleClient.stop();
         HTTPClient http;
-        http.setTimeout(30000);
+        const uint32_t timeoutMs = upstreamRequestTimeoutMs();
+        http.setTimeout((uint16_t)timeoutMs);
+        http.setConnectTimeout((int32_t)timeoutMs);
         http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
 
         if (!http.begin(scheduleClient, NHL_SCHEDULE_URL)) {
-            Serial.printf("[schedule] attempt %d: http.begin failed\n", attempt + 1);
-            if (attempt < SCHEDULE_MAX_RETRIES - 1) {
-                delay(SCHEDULE_RETRY_BASE_MS * (1UL << attempt));
+            LOGW("schedule", "attempt %d: http.begin failed", attempt + 1);
+            fetchFailures.inc(0);
+            netTraceEnd(trace, 0, false, 0);
+            if (upstreamRecordAttemptFailure(loop, false) == RetryStep::Backoff) {
+                delay(upstreamRetryDelayMs(SCHEDULE_RETRY_BASE_MS, attempt));
             }
             continue;
         }
         
+        netTracePreconnect(trace, scheduleClient, NHL_API_HOST, 443, timeoutMs);
         http.addHeader("User-Agent", "Mozilla/5.0 (compatible; Scoreboard/1.0)");
+        const uint32_t startMs = millis();
         code = http.GET();
+        const uint32_t ttfbMs = millis() - startMs;
+        netTraceMark(trace, NetPhase::Ttfb);
         
         if (code != HTTP_CODE_OK) {
-            Serial.printf("[schedule] attempt %d: GET code=%d\n", attempt + 1, code);
+            LOGW("schedule", "attempt %d: GET code=%d after %lums",
+                attempt + 1, code, (unsigned long)ttfbMs);
+            fetchFailures.inc(code);
+            netTraceEnd(trace, code, false, 0);
             http.end();
-            if (attempt < SCHEDULE_MAX_RETRIES - 1) {
-                delay(SCHEDULE_RETRY_BASE_MS * (1UL << attempt));
+            // A read timeout is past the p95-derived deadline: re-issued at once
+            if (upstreamRecordAttemptFailure(loop, code == HTTPC_ERROR_READ_TIMEOUT) == RetryStep::Backoff) {
+                delay(upstreamRetryDelayMs(SCHEDULE_RETRY_BASE_MS, attempt));
             }
             continue;
         }
         
+        ttfbMsHist.observe(ttfbMs);
+
         // Skip any garbage before JSON
-        Stream& s = *http.getStreamPtr();
+        TimedStream s(*http.getStreamPtr());
+        RetryStep step = RetryStep::GiveUp;
+        uint32_t parseUs = 0;
         uint32_t start = millis();
         int c = -1;
         size_t skipped = 0;
@@ -160,15 +217,29 @@ static DeserializationError fetchAndParseJson(JsonDocument& doc, JsonDocument& f
         
         if (c != '{') {
             err = DeserializationError::InvalidInput;
-            Serial.printf("[schedule] no JSON start (skipped=%u)\n", (unsigned)skipped);
+            LOGW("schedule", "no JSON start (skipped=%u)", (unsigned)skipped);
         } else {
             if (skipped > 0) {
-                Serial.printf("[schedule] skipped=%u before JSON\n", (unsigned)skipped);
+                LOGD("schedule", "skipped=%u before JSON", (unsigned)skipped);
             }
             PrefixStream ps(s, '{');
+            const uint32_t parseStartUs = micros();
+            const uint32_t waitStartUs = s.waitUs();
             err = deserializeJson(doc, ps,
                 DeserializationOption::Filter(filterDoc),
                 DeserializationOption::NestingLimit(16));
+            parseUs = (micros() - parseStartUs) - (s.waitUs() - waitStartUs);
+        }
+        netTraceMarkBody(trace, parseUs);
+        netTraceEnd(trace, code, !err, (uint32_t)s.bytesRead());
+        fetchBytes.inc((uint32_t)s.bytesRead());
+        
+        if (!err) {
+            upstreamRecordSuccess(ttfbMs);
+            parseMsHist.observe(millis() - startMs - ttfbMs);
+        } else {
+            step = upstreamRecordAttemptFailure(loop, false);
+            jsonErrors.inc();
         }
         
         http.end();
@@ -176,9 +247,9 @@ static DeserializationError fetchAndParseJson(JsonDocument& doc, JsonDocument& f
         delay(50);
         
         if (!err) break;
-        Serial.printf("[schedule] attempt %d: parse %s\n", attempt + 1, err.c_str());
-        if (attempt < SCHEDULE_MAX_RETRIES - 1) {
-            delay(SCHEDULE_RETRY_BASE_MS * (1UL << attempt));
+        LOGW("schedule", "attempt %d: parse %s", attempt + 1, err.c_str());
+        if (step == RetryStep::Backoff) {
+            delay(upstreamRetryDelayMs(SCHEDULE_RETRY_BASE_MS, attempt));
         }
     }
     
@@ -190,8 +261,9 @@ static DeserializationError fetchAndParseJson(JsonDocument& doc, JsonDocument& f
 // ============================================================================
 
 static bool fetchScheduleOnce() {
-    Serial.printf("[schedule] fetch start @%lu\n", millis());
+    LOGD("schedule", "fetch start @%lu", millis());
     state.lastFetchMs = millis();
+    DvfsNetworkBoost boost;
     
     // Prepare filter
     JsonDocument doc;
@@ -214,18 +286,18 @@ static bool fetchScheduleOnce() {
     JsonArray gamesByDate = doc["gamesByDate"];
     
     if (gamesByDate.isNull()) {
-        Serial.println("[schedule] gamesByDate is null");
+        LOGW("schedule", "gamesByDate is null");
         state.lastFailMs = millis();
         return false;
     }
     
-    Serial.printf("[schedule] focusedDate=%s days=%u\n",
+    LOGD("schedule", "focusedDate=%s days=%u",
         focusedDate[0] ? focusedDate : "(empty)",
         (unsigned)gamesByDate.size());
     
     if (gamesByDate.size() > 0) {
         const char* firstDate = gamesByDate[0]["date"] | "?";
-        Serial.printf("[schedule] firstDate=%s\n", firstDate);
+        LOGD("schedule", "firstDate=%s", firstDate);
     }
     
     // Build output with ALL days
@@ -233,6 +305,9 @@ static bool fetchScheduleOnce() {
     out["focusedDate"] = focusedDate;
     JsonArray outGames = out["games"].to<JsonArray>();
     unsigned totalGames = 0;
+    int64_t upcomingStarts[SCHEDULE_MAX_UPCOMING];
+    size_t upcomingCount = 0;
+    bool anyLive = false;
 
     for (JsonObject day : gamesByDate) {
         const char* date = day["date"] | "?";
@@ -241,10 +316,23 @@ static bool fetchScheduleOnce() {
             JsonObject outGame = outGames.add<JsonObject>();
             buildGameJson(outGame, game, date);
             totalGames++;
+
+            // Feed the off-hours planner: games still to be played
+            const char* gameState = game["gameState"] | "";
+            if (strcasecmp(gameState, "LIVE") == 0 || strcasecmp(gameState, "CRIT") == 0) {
+                anyLive = true;
+            } else if (strcasecmp(gameState, "FUT") == 0 || strcasecmp(gameState, "PRE") == 0) {
+                int64_t startEpoch = 0;
+                if (upcomingCount < SCHEDULE_MAX_UPCOMING
+                    && parseIsoUtc(game["startTimeUTC"] | "", startEpoch)) {
+                    upcomingStarts[upcomingCount++] = startEpoch;
+                }
+            }
         }
     }
+    offHoursUpdateSchedule(upcomingStarts, upcomingCount, anyLive);
 
-    Serial.printf("[schedule] focused=%s days=%u games=%u\n",
+    LOGI("schedule", "focused=%s days=%u games=%u",
         focusedDate[0] ? focusedDate : "(empty)",
         (unsigned)gamesByDate.size(),
         totalGames);
@@ -252,8 +340,9 @@ static bool fetchScheduleOnce() {
     serializeJson(out, state.lastGoodResponse);
     state.lastFetchMs = millis();
     state.lastFailMs = 0;
+    bootMark(BootPhase::FirstLiveData);
     
-    Serial.printf("[schedule] fetch ok bytes=%u\n", 
+    LOGI("schedule", "fetch ok bytes=%u", 
         (unsigned)state.lastGoodResponse.length());
     return true;
 }
@@ -263,11 +352,12 @@ static bool fetchScheduleOnce() {
 // ============================================================================
 
 static void schedulePollTask(void*) {
+    HeapTagScope heapTag(HeapTag::Schedule);
     for (;;) {
         // Pause when a game is selected
         if (apiServerGetSelectedGameId() != 0) {
             if (!state.paused) {
-                Serial.println("[schedule] paused (game selected)");
+                LOGI("schedule", "paused (game selected)");
                 state.paused = true;
             }
             vTaskDelay(1000 / portTICK_PERIOD_MS);
@@ -275,9 +365,23 @@ static void schedulePollTask(void*) {
         }
         
         if (state.paused) {
-            Serial.println("[schedule] resumed (no game selected)");
+            LOGI("schedule", "resumed (no game selected)");
             state.paused = false;
         }
+
+        // Nothing to show the schedule on in standby
+        if (powerIsStandby()) {
+            LOGI("schedule", "paused (standby)");
+            powerWaitActive(portMAX_DELAY);
+            state.lastFailMs = 0;
+        }
+
+        // Park until the link supervisor reports the network is back
+        if (!wifiLinkIsUp()) {
+            LOGI("schedule", "waiting for WiFi");
+            wifiLinkWaitUp(portMAX_DELAY);
+            state.lastFailMs = 0;
+        }
         
         // Backoff after failure
         if (state.lastFailMs > 0) {
@@ -313,6 +417,8 @@ void scheduleServiceInit(WebServer& server) {
     scheduleServer = &server;
     scheduleClient.setInsecure();
     scheduleClient.setTimeout(30);
+    upstreamHealthInit();
+    netTraceInit();
     
     scheduleServer->on("/api/schedule", HTTP_GET, handleApiSchedule);
     
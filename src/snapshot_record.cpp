@@ -0,0 +1,114 @@
+#include "snapshot_record.h"
+
+#include <string.h>
+
+namespace {
+    void copyStr(char* dst, size_t dstSize, const char* src) {
+        if (!dst || dstSize == 0) return;
+        strncpy(dst, src ? src : "", dstSize - 1);
+        dst[dstSize - 1] = '\0';
+    }
+
+    void packTeam(SnapshotTeam& out, const TeamInfo& team) {
+        out.id = team.id;
+        copyStr(out.abbrev, sizeof(out.abbrev), team.abbrev);
+        copyStr(out.name, sizeof(out.name), team.name);
+        out.score = team.score;
+        out.sog = team.sog;
+    }
+
+    void unpackTeam(TeamInfo& out, const SnapshotTeam& team) {
+        out.id = team.id;
+        copyStr(out.abbrev, sizeof(out.abbrev), team.abbrev);
+        copyStr(out.name, sizeof(out.name), team.name);
+        out.score = team.score;
+        out.sog = team.sog;
+    }
+
+    template <size_t N>
+    void terminate(char (&s)[N]) {
+        s[N - 1] = '\0';
+    }
+}
+
+uint32_t snapshotCrc32(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; ++b) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+void snapshotPack(SnapshotRecord& out, const GameSnapshot& snap, int64_t nowEpoch) {
+    memset(&out, 0, sizeof(out));
+    out.gameId = snap.gameId;
+    out.savedAtEpoch = nowEpoch;
+    copyStr(out.gameState, sizeof(out.gameState), snap.gameState);
+    copyStr(out.startTimeUtc, sizeof(out.startTimeUtc), snap.startTimeUtc);
+    copyStr(out.utcOffset, sizeof(out.utcOffset), snap.utcOffset);
+    packTeam(out.away, snap.away);
+    packTeam(out.home, snap.home);
+    out.period = snap.period;
+    out.inIntermission = snap.inIntermission ? 1 : 0;
+    copyStr(out.timeRemaining, sizeof(out.timeRemaining), snap.timeRemaining);
+}
+
+void snapshotUnpack(GameSnapshot& out, const SnapshotRecord& rec) {
+    memset(&out, 0, sizeof(out));
+    out.gameId = rec.gameId;
+    copyStr(out.gameState, sizeof(out.gameState), rec.gameState);
+    copyStr(out.startTimeUtc, sizeof(out.startTimeUtc), rec.startTimeUtc);
+    copyStr(out.utcOffset, sizeof(out.utcOffset), rec.utcOffset);
+    unpackTeam(out.away, rec.away);
+    unpackTeam(out.home, rec.home);
+    out.period = rec.period;
+    out.inIntermission = rec.inIntermission != 0;
+    copyStr(out.timeRemaining, sizeof(out.timeRemaining), rec.timeRemaining);
+}
+
+void snapshotEncode(const SnapshotRecord& rec, uint8_t* out) {
+    SnapshotHeader header;
+    header.magic = kSnapshotMagic;
+    header.version = kSnapshotVersion;
+    header.size = sizeof(SnapshotRecord);
+    header.crc = snapshotCrc32((const uint8_t*)&rec, sizeof(rec));
+    memcpy(out, &header, sizeof(header));
+    memcpy(out + sizeof(header), &rec, sizeof(rec));
+}
+
+bool snapshotDecode(const uint8_t* data, size_t len, SnapshotRecord& out) {
+    if (!data || len != kSnapshotFileSize) return false;
+    SnapshotHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != kSnapshotMagic || header.version != kSnapshotVersion
+        || header.size != sizeof(SnapshotRecord)) {
+        return false;
+    }
+    memcpy(&out, data + sizeof(header), sizeof(out));
+    if (snapshotCrc32((const uint8_t*)&out, sizeof(out)) != header.crc) return false;
+    terminate(out.gameState);
+    terminate(out.startTimeUtc);
+    terminate(out.utcOffset);
+    terminate(out.away.abbrev);
+    terminate(out.away.name);
+    terminate(out.home.abbrev);
+    terminate(out.home.name);
+    terminate(out.timeRemaining);
+    return true;
+}
+
+bool snapshotSameContent(const SnapshotRecord& a, const SnapshotRecord& b) {
+    SnapshotRecord x = a;
+    SnapshotRecord y = b;
+    x.savedAtEpoch = 0;
+    y.savedAtEpoch = 0;
+    return memcmp(&x, &y, sizeof(x)) == 0;
+}
+
+bool snapshotIsStale(const SnapshotRecord& rec, int64_t nowEpoch) {
+    if (nowEpoch <= 0 || rec.savedAtEpoch <= 0) return false;
+    return nowEpoch - rec.savedAtEpoch > kSnapshotMaxAgeS;
+}
@@ -0,0 +1,191 @@
+#include "snapshot_store.h"
+
+#include <LittleFS.h>
+#include <time.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "api_server.h"
+#include "boot.h"
+#include "snapshot_record.h"
+#include "display/data_model.h"
+
+namespace {
+    constexpr const char* SNAPSHOT_PATH = "/snapshot.bin";
+    constexpr const char* SNAPSHOT_TMP_PATH = "/snapshot.tmp";
+
+    constexpr uint32_t SAVE_CHECK_MS = 1000;
+    constexpr uint32_t SAVE_DEBOUNCE_MS = 5000;   // quiet time before a write
+    constexpr uint32_t SAVE_MIN_GAP_MS = 30000;   // flash wear: one write per 30 s at most
+    constexpr uint32_t SAVE_STACK = 4096;
+
+    SnapshotRecord lastWritten = {};
+    bool hasLastWritten = false;
+    // Too big for the task stack; restore runs before the save task starts
+    GameSnapshot scratch{};
+
+    // Restored before NTP: its age is checked once the time is known
+    SnapshotRecord restored = {};
+    bool restoreAgeUnchecked = false;
+
+    int64_t wallEpoch() {
+        const time_t now = time(nullptr);
+        return now > 100000 ? (int64_t)now : 0;
+    }
+
+    bool writeRecord(const SnapshotRecord& rec) {
+        uint8_t buf[kSnapshotFileSize];
+        snapshotEncode(rec, buf);
+
+        File f = LittleFS.open(SNAPSHOT_TMP_PATH, "w");
+        if (!f) return false;
+        const bool ok = f.write(buf, sizeof(buf)) == sizeof(buf);
+        f.close();
+        if (!ok) {
+            LittleFS.remove(SNAPSHOT_TMP_PATH);
+            return false;
+        }
+        // Rename so a power cut mid-write leaves the previous record intact
+        LittleFS.remove(SNAPSHOT_PATH);
+        return LittleFS.rename(SNAPSHOT_TMP_PATH, SNAPSHOT_PATH);
+    }
+
+    bool readRecord(SnapshotRecord& out) {
+        if (!LittleFS.exists(SNAPSHOT_PATH)) return false;
+        File f = LittleFS.open(SNAPSHOT_PATH, "r");
+        if (!f) return false;
+        uint8_t buf[kSnapshotFileSize];
+        const size_t n = f.size() == sizeof(buf) ? f.read(buf, sizeof(buf)) : 0;
+        f.close();
+        if (!snapshotDecode(buf, n, out)) {
+            Serial.println("[snapshot] invalid record, ignored");
+            return false;
+        }
+        return true;
+    }
+
+    void clearRecord() {
+        if (LittleFS.exists(SNAPSHOT_PATH)) {
+            LittleFS.remove(SNAPSHOT_PATH);
+            Serial.println("[snapshot] cleared");
+        }
+        hasLastWritten = false;
+    }
+
+    // Something to write: content that differs from what is on flash, or
+    // a cleared selection whose record is still there.
+    bool needsWrite(const SnapshotRecord& rec) {
+        if (rec.gameId == 0) return hasLastWritten;
+        return !hasLastWritten || !snapshotSameContent(rec, lastWritten);
+    }
+
+    void save(const SnapshotRecord& rec) {
+        if (rec.gameId == 0) {
+            clearRecord();
+            return;
+        }
+        if (!needsWrite(rec)) return;
+        const uint32_t start = millis();
+        if (writeRecord(rec)) {
+            lastWritten = rec;
+            hasLastWritten = true;
+            Serial.printf("[snapshot] saved gameId=%u (%lums)\n",
+                (unsigned)rec.gameId, (unsigned long)(millis() - start));
+        } else {
+            Serial.println("[snapshot] write failed");
+        }
+    }
+
+    // A record restored before NTP may turn out to be from a game that
+    // ended long ago; drop it and its selection then, unless the user
+    // has moved on to another game in the meantime.
+    void checkRestoredAge() {
+        if (!snapshotIsStale(restored, wallEpoch())) return;
+        const uint32_t selected = apiServerGetSelectedGameId();
+        if (selected != 0 && selected != restored.gameId) return;
+        Serial.printf("[snapshot] restored gameId=%u is stale, cleared\n", (unsigned)restored.gameId);
+        apiServerSelectGame(0);
+        clearRecord();
+    }
+
+    void snapshotSaveTask(void*) {
+        GameSnapshot* snap = &scratch;
+        // The version only says the model may have changed. Debouncing
+        // runs on the packed record, so polls that rewrite the same score
+        // and clock do not keep a write pending forever.
+        uint32_t seenVersion = dataModelGetVersion() - 1;
+        SnapshotRecord latest = {};
+        bool haveLatest = false;
+        uint32_t changedAtMs = millis();
+        uint32_t lastSaveMs = millis() - SAVE_MIN_GAP_MS;
+
+        while (true) {
+            vTaskDelay(pdMS_TO_TICKS(SAVE_CHECK_MS));
+            const uint32_t now = millis();
+
+            if (restoreAgeUnchecked && bootIsDone(BootPhase::TimeSynced)) {
+                restoreAgeUnchecked = false;
+                checkRestoredAge();
+            }
+
+            const uint32_t v = dataModelGetVersion();
+            if (v != seenVersion) {
+                seenVersion = v;
+                // Fills snap even when no game is selected
+                dataModelGetSnapshot(*snap);
+                SnapshotRecord rec;
+                snapshotPack(rec, *snap, wallEpoch());
+                if (!haveLatest || !snapshotSameContent(rec, latest)) {
+                    // A new selection is written at once
+                    const bool selectionChanged = !haveLatest || rec.gameId != latest.gameId;
+                    latest = rec;
+                    haveLatest = true;
+                    changedAtMs = now;
+                    if (selectionChanged) {
+                        save(latest);
+                        lastSaveMs = now;
+                        continue;
+                    }
+                }
+            }
+
+            // Live updates wait for a quiet period and the minimum gap
+            if (!haveLatest || !needsWrite(latest)) continue;
+            if (now - changedAtMs < SAVE_DEBOUNCE_MS) continue;
+            if (now - lastSaveMs < SAVE_MIN_GAP_MS) continue;
+            latest.savedAtEpoch = wallEpoch();
+            save(latest);
+            lastSaveMs = now;
+        }
+    }
+}
+
+bool snapshotStoreRestore() {
+    SnapshotRecord rec;
+    if (!readRecord(rec) || rec.gameId == 0) return false;
+
+    const int64_t now = wallEpoch();
+    if (snapshotIsStale(rec, now)) {
+        Serial.println("[snapshot] stale, ignored");
+        return false;
+    }
+
+    GameSnapshot* snap = &scratch;
+    snapshotUnpack(*snap, rec);
+    dataModelRestore(*snap);
+
+    lastWritten = rec;
+    hasLastWritten = true;
+    restored = rec;
+    restoreAgeUnchecked = now == 0 && rec.savedAtEpoch > 0;
+    Serial.printf("[snapshot] restored gameId=%u %s %u-%u %s\n",
+        (unsigned)rec.gameId, rec.away.abbrev, (unsigned)rec.away.score,
+        (unsigned)rec.home.score, rec.home.abbrev);
+    return true;
+}
+
+void snapshotStoreStart() {
+    if (xTaskCreate(snapshotSaveTask, "snapshot", SAVE_STACK, NULL, 1, NULL) != pdPASS) {
+        Serial.println("Warn: snapshot task creation failed");
+    }
+}
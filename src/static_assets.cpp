@@ -0,0 +1,122 @@
+#include "static_assets.h"
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+#include "metrics.h"
+
+namespace {
+    struct StaticAsset {
+        const char* uri;
+        const char* path;         // as in data/; the .gz twin is preferred
+        const char* contentType;
+        uint32_t maxAgeS;         // 0 = revalidate every use (unversioned URL)
+    };
+
+    // One row per served URI. The page itself keeps max-age 0 so a new
+    // filesystem image shows up on the next load; its ETag turns that
+    // revalidation into a bodiless 304.
+    const StaticAsset ASSETS[] = {
+        {"/", "/index.html", "text/html", 0},
+        {"/index.html", "/index.html", "text/html", 0},
+    };
+    constexpr size_t ASSET_COUNT = sizeof(ASSETS) / sizeof(ASSETS[0]);
+
+    // Resolved on first request. The filesystem only changes by reflashing,
+    // which reboots, so this holds for the uptime.
+    struct AssetFile {
+        bool probed;
+        bool found;
+        char path[40];
+        char etag[12];
+        char cacheControl[40];
+    };
+    AssetFile files[ASSET_COUNT];
+
+    WebServer* assetServer = nullptr;
+
+    const uint32_t SERVE_US_BOUNDS[] = {500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000};
+    MetricLabeledCounter responses("scoreboard_static_responses_total",
+        "Static asset responses by HTTP status", "code");
+    MetricCounter bodyBytes("scoreboard_static_body_bytes_total",
+        "Static asset body bytes sent (compressed size when gzipped)");
+    MetricHistogram serveUs("scoreboard_static_serve_us",
+        "Time the server loop spends in one static asset request", SERVE_US_BOUNDS, 9);
+
+    uint32_t hashFile(File& f) {
+        // FNV-1a
+        uint32_t h = 2166136261u;
+        uint8_t buf[256];
+        size_t n;
+        while ((n = f.read(buf, sizeof(buf))) > 0) {
+            for (size_t i = 0; i < n; ++i) {
+                h ^= buf[i];
+                h *= 16777619u;
+            }
+        }
+        return h;
+    }
+
+    void probe(const StaticAsset& asset, AssetFile& file) {
+        file.probed = true;
+        snprintf(file.path, sizeof(file.path), "%s.gz", asset.path);
+        File f = LittleFS.open(file.path, "r");
+        if (!f) {
+            snprintf(file.path, sizeof(file.path), "%s", asset.path);
+            f = LittleFS.open(file.path, "r");
+        }
+        if (!f) return;
+        file.found = true;
+        snprintf(file.etag, sizeof(file.etag), "\"%08lx\"", (unsigned long)hashFile(f));
+        f.close();
+        if (asset.maxAgeS == 0) {
+            snprintf(file.cacheControl, sizeof(file.cacheControl), "no-cache");
+        } else {
+            snprintf(file.cacheControl, sizeof(file.cacheControl), "public, max-age=%lu",
+                (unsigned long)asset.maxAgeS);
+        }
+    }
+
+    int serve(size_t index) {
+        WebServer& server = *assetServer;
+        const StaticAsset& asset = ASSETS[index];
+        AssetFile& file = files[index];
+        if (!file.probed) probe(asset, file);
+        if (!file.found) {
+            server.send(404, "text/plain", "Fichier non trouvé");
+            return 404;
+        }
+
+        server.sendHeader("ETag", file.etag);
+        server.sendHeader("Cache-Control", file.cacheControl);
+        if (server.header("If-None-Match") == file.etag) {
+            server.send(304);
+            return 304;
+        }
+
+        File f = LittleFS.open(file.path, "r");
+        if (!f) {
+            server.send(500, "text/plain", "Erreur lecture");
+            return 500;
+        }
+        // streamFile() adds Content-Encoding: gzip itself for *.gz names
+        const size_t sent = server.streamFile(f, asset.contentType);
+        f.close();
+        bodyBytes.inc(sent);
+        return 200;
+    }
+
+    void handleAsset(size_t index) {
+        const uint32_t startUs = micros();
+        const int code = serve(index);
+        serveUs.observe(micros() - startUs);
+        responses.inc(code);
+    }
+}
+
+void staticAssetsInit(WebServer& server) {
+    assetServer = &server;
+    for (size_t i = 0; i < ASSET_COUNT; ++i) {
+        server.on(ASSETS[i].uri, HTTP_GET, [i]() { handleAsset(i); });
+    }
+}
@@ -0,0 +1,195 @@
+#include "sys_stats.h"
+
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "logger.h"
+#include "metrics.h"
+#include "display/display_manager.h"
+
+namespace {
+    constexpr uint32_t LOG_TASK_STACK = 4096;
+    constexpr uint32_t MIN_LOG_INTERVAL_MS = 5000;
+
+    SemaphoreHandle_t statsMutex = nullptr;
+    TaskHandle_t logTask = nullptr;
+    volatile uint32_t logIntervalMs = 0;
+
+    // Previous sample, to turn cumulative run-time counters into shares
+    struct PrevTask {
+        UBaseType_t number;
+        uint32_t runTime;
+    };
+    PrevTask prevTasks[kSysStatsMaxTasks];
+    size_t prevCount = 0;
+    uint32_t prevTotalRunTime = 0;
+    uint32_t prevSampleMs = 0;
+
+#if configUSE_TRACE_FACILITY
+    TaskStatus_t statusBuf[kSysStatsMaxTasks];
+#endif
+
+    // Sample buffer for the log task; too big for its stack
+    SysStats logSample;
+
+    int32_t readHeapFree() { return (int32_t)heap_caps_get_free_size(MALLOC_CAP_8BIT); }
+    int32_t readHeapMinFree() { return (int32_t)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT); }
+    int32_t readHeapLargest() { return (int32_t)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT); }
+
+    MetricGauge heapFree("scoreboard_heap_free_bytes", "Free 8-bit heap", readHeapFree);
+    MetricGauge heapMinFree("scoreboard_heap_min_free_bytes", "Low-water mark of the 8-bit heap", readHeapMinFree);
+    MetricGauge heapLargest("scoreboard_heap_largest_free_block_bytes", "Largest free 8-bit block", readHeapLargest);
+
+    uint32_t prevRunTimeFor(UBaseType_t number, bool& found) {
+        for (size_t i = 0; i < prevCount; ++i) {
+            if (prevTasks[i].number == number) {
+                found = true;
+                return prevTasks[i].runTime;
+            }
+        }
+        found = false;
+        return 0;
+    }
+
+    void sampleHeap(HeapStats& out) {
+        out.internalFree = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        out.internalLargest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        out.internalMinFree = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        out.dmaFree = heap_caps_get_free_size(MALLOC_CAP_DMA);
+        out.dmaLargest = heap_caps_get_largest_free_block(MALLOC_CAP_DMA);
+        out.psramTotal = heap_caps_get_total_size(MALLOC_CAP_SPIRAM);
+        out.psramFree = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+        out.psramLargest = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+        out.psramMinFree = heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM);
+    }
+
+    void sampleTasks(SysStats& out) {
+        out.taskCount = 0;
+        out.taskStats = false;
+        out.runtimeStats = false;
+#if configUSE_TRACE_FACILITY
+        uint32_t totalRunTime = 0;
+        const UBaseType_t n = uxTaskGetSystemState(statusBuf, kSysStatsMaxTasks, &totalRunTime);
+        if (n == 0) return;  // more tasks than slots
+        out.taskStats = true;
+#if configGENERATE_RUN_TIME_STATS
+        out.runtimeStats = true;
+        const uint32_t totalDelta = totalRunTime - prevTotalRunTime;
+#endif
+        for (UBaseType_t i = 0; i < n; ++i) {
+            const TaskStatus_t& status = statusBuf[i];
+            TaskStat& task = out.tasks[out.taskCount++];
+            strncpy(task.name, status.pcTaskName ? status.pcTaskName : "?", sizeof(task.name) - 1);
+            task.name[sizeof(task.name) - 1] = '\0';
+            task.state = (uint8_t)status.eCurrentState;
+            task.priority = (uint8_t)status.uxCurrentPriority;
+            // ESP-IDF stacks are byte-addressed, so this is already in bytes
+            task.stackFreeBytes = status.usStackHighWaterMark;
+            task.cpuPermille = -1;
+#if configGENERATE_RUN_TIME_STATS
+            bool found = false;
+            const uint32_t prev = prevRunTimeFor(status.xTaskNumber, found);
+            if (found && totalDelta > 0) {
+                // Two cores: the idle tasks together add up to ~2000
+                task.cpuPermille = (int16_t)((uint64_t)(status.ulRunTimeCounter - prev) * 1000 / totalDelta);
+            }
+#endif
+        }
+#if configGENERATE_RUN_TIME_STATS
+        prevCount = n;
+        for (UBaseType_t i = 0; i < n; ++i) {
+            prevTasks[i].number = statusBuf[i].xTaskNumber;
+            prevTasks[i].runTime = statusBuf[i].ulRunTimeCounter;
+        }
+        prevTotalRunTime = totalRunTime;
+#endif
+#endif
+    }
+
+    void logSnapshot(const SysStats& s) {
+        LOGI("sys", "heap free=%u largest=%u min=%u dma=%u/%u psram=%u/%u min=%u panelDma=%u",
+            (unsigned)s.heap.internalFree, (unsigned)s.heap.internalLargest,
+            (unsigned)s.heap.internalMinFree, (unsigned)s.heap.dmaFree,
+            (unsigned)s.heap.dmaLargest, (unsigned)s.heap.psramFree,
+            (unsigned)s.heap.psramTotal, (unsigned)s.heap.psramMinFree,
+            (unsigned)s.panelDmaBytes);
+        for (uint8_t i = 0; i < s.taskCount; ++i) {
+            const TaskStat& t = s.tasks[i];
+            if (t.cpuPermille < 0) {
+                LOGI("sys", "task %-12s %-9s prio=%u stackFree=%u",
+                    t.name, sysStatsTaskStateName(t.state), (unsigned)t.priority,
+                    (unsigned)t.stackFreeBytes);
+                continue;
+            }
+            LOGI("sys", "task %-12s %-9s prio=%u stackFree=%u cpu=%d.%d%%",
+                t.name, sysStatsTaskStateName(t.state), (unsigned)t.priority,
+                (unsigned)t.stackFreeBytes, t.cpuPermille / 10, t.cpuPermille % 10);
+        }
+    }
+
+    void sysStatsLogTask(void*) {
+        for (;;) {
+            const uint32_t interval = logIntervalMs;
+            if (interval == 0) {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                continue;
+            }
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(interval));
+            if (logIntervalMs == 0) continue;
+            sysStatsSample(logSample);
+            logSnapshot(logSample);
+        }
+    }
+}
+
+void sysStatsInit() {
+    if (!statsMutex) {
+        statsMutex = xSemaphoreCreateMutex();
+    }
+    prevSampleMs = millis();
+    if (!logTask && xTaskCreate(sysStatsLogTask, "sys_stats", LOG_TASK_STACK, NULL, 1, &logTask) != pdPASS) {
+        Serial.println("Warn: sys_stats task creation failed");
+        logTask = nullptr;
+    }
+}
+
+void sysStatsSample(SysStats& out) {
+    if (statsMutex) xSemaphoreTake(statsMutex, portMAX_DELAY);
+    const uint32_t now = millis();
+    out.uptimeMs = now;
+    out.windowMs = now - prevSampleMs;
+    prevSampleMs = now;
+    sampleTasks(out);
+    sampleHeap(out.heap);
+    out.panelDmaBytes = (uint32_t)displayDmaBytes();
+    if (statsMutex) xSemaphoreGive(statsMutex);
+}
+
+void sysStatsSetLogInterval(uint32_t intervalMs) {
+    if (intervalMs != 0 && intervalMs < MIN_LOG_INTERVAL_MS) intervalMs = MIN_LOG_INTERVAL_MS;
+    logIntervalMs = intervalMs;
+    if (logTask) xTaskNotifyGive(logTask);
+}
+
+uint32_t sysStatsLogInterval() {
+    return logIntervalMs;
+}
+
+const char* sysStatsTaskStateName(uint8_t state) {
+    switch (state) {
+        case eRunning:
+            return "running";
+        case eReady:
+            return "ready";
+        case eBlocked:
+            return "blocked";
+        case eSuspended:
+            return "suspended";
+        case eDeleted:
+            return "deleted";
+        default:
+            return "?";
+    }
+}
@@ -0,0 +1,92 @@
+#include "time_utils.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+    int parseDigits(const char* s, size_t count) {
+        int value = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (s[i] < '0' || s[i] > '9') return -1;
+            value = value * 10 + (s[i] - '0');
+        }
+        return value;
+    }
+}
+
+int64_t daysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2 ? 1 : 0;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = (unsigned)(year - era * 400);
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+void civilFromDays(int64_t days, int& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = (unsigned)(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = (int)(yoe + era * 400) + (month <= 2 ? 1 : 0);
+}
+
+bool parseIsoUtc(const char* iso, int64_t& epochOut) {
+    if (!iso || strlen(iso) < 16 || iso[4] != '-' || iso[7] != '-' || iso[10] != 'T' || iso[13] != ':') {
+        return false;
+    }
+    const int year = parseDigits(iso, 4);
+    const int month = parseDigits(iso + 5, 2);
+    const int day = parseDigits(iso + 8, 2);
+    const int hour = parseDigits(iso + 11, 2);
+    const int minute = parseDigits(iso + 14, 2);
+    int second = 0;
+    if (iso[16] == ':') {
+        second = parseDigits(iso + 17, 2);
+    }
+    if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60) {
+        return false;
+    }
+    epochOut = daysFromCivil(year, (unsigned)month, (unsigned)day) * kSecondsPerDay +
+        hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+int parseUtcOffsetMinutes(const char* offset) {
+    if (!offset || strlen(offset) < 6 || (offset[0] != '+' && offset[0] != '-') || offset[3] != ':') {
+        return 0;
+    }
+    const int hh = parseDigits(offset + 1, 2);
+    const int mm = parseDigits(offset + 4, 2);
+    if (hh < 0 || mm < 0) return 0;
+    const int minutes = hh * 60 + mm;
+    return offset[0] == '-' ? -minutes : minutes;
+}
+
+void localStartTime(int64_t startEpoch, int offsetMinutes, LocalStartTime& out) {
+    const int64_t offsetSec = (int64_t)offsetMinutes * 60;
+    const int64_t local = startEpoch + offsetSec;
+    int64_t localDay = local / kSecondsPerDay;
+    if (local % kSecondsPerDay < 0) localDay--;
+    const int64_t secOfDay = local - localDay * kSecondsPerDay;
+
+    out.dayEndEpoch = (localDay + 1) * kSecondsPerDay - offsetSec;
+
+    const int hh = (int)(secOfDay / 3600);
+    const int mm = (int)((secOfDay / 60) % 60);
+    if (mm == 0) {
+        snprintf(out.label, sizeof(out.label), "%02dH", hh);
+    } else {
+        snprintf(out.label, sizeof(out.label), "%02dH%02d", hh, mm);
+    }
+    int year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    civilFromDays(localDay, year, month, day);
+    snprintf(out.dateLabel, sizeof(out.dateLabel), "%02u-%02u", day, month);
+}
@@ -0,0 +1,76 @@
+#include "upstream_health.h"
+
+#include <esp_system.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "logger.h"
+
+namespace {
+    SemaphoreHandle_t healthMutex = nullptr;
+    UpstreamPolicy policy;
+
+    void lock() {
+        if (healthMutex) xSemaphoreTake(healthMutex, portMAX_DELAY);
+    }
+
+    void unlock() {
+        if (healthMutex) xSemaphoreGive(healthMutex);
+    }
+}
+
+void upstreamHealthInit() {
+    if (!healthMutex) {
+        healthMutex = xSemaphoreCreateMutex();
+    }
+}
+
+bool upstreamAllowRequest() {
+    lock();
+    const CircuitState before = policy.circuit();
+    const bool allowed = policy.allowRequest(millis());
+    const bool probing = before == CircuitState::Open && policy.circuit() == CircuitState::HalfOpen;
+    unlock();
+    if (probing) LOGI("upstream", "circuit half-open, probing");
+    return allowed;
+}
+
+uint32_t upstreamRequestTimeoutMs() {
+    lock();
+    const uint32_t timeout = policy.requestTimeoutMs();
+    unlock();
+    return timeout;
+}
+
+uint32_t upstreamRetryDelayMs(uint32_t baseMs, int attempt) {
+    return backoffDelayMs(baseMs, attempt, esp_random());
+}
+
+void upstreamRecordSuccess(uint32_t ttfbMs) {
+    lock();
+    const bool wasOpen = policy.circuit() != CircuitState::Closed;
+    policy.recordSuccess(ttfbMs, millis());
+    unlock();
+    if (wasOpen) LOGI("upstream", "circuit closed");
+}
+
+RetryStep upstreamRecordAttemptFailure(UpstreamRetryLoop& loop, bool deadlineMissed) {
+    lock();
+    const bool wasOpen = policy.circuit() == CircuitState::Open;
+    const RetryStep step = policy.recordAttemptFailure(loop, deadlineMissed, millis(), esp_random());
+    const bool opened = !wasOpen && policy.circuit() == CircuitState::Open;
+    UpstreamHealthStats stats;
+    if (opened) policy.getStats(stats, millis());
+    unlock();
+    if (opened) {
+        LOGW("upstream", "circuit open for %lums (failures=%u)",
+            (unsigned long)stats.retryInMs, (unsigned)stats.consecutiveFailures);
+    }
+    return step;
+}
+
+void upstreamGetStats(UpstreamHealthStats& out) {
+    lock();
+    policy.getStats(out, millis());
+    unlock();
+}
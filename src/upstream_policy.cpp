@@ -0,0 +1,150 @@
+#include "upstream_policy.h"
+
+bool UpstreamRetryLoop::next() {
+    reissuing_ = reissuePending_;
+    reissuePending_ = false;
+    if (reissuing_) return true;
+    attempt_++;
+    return attempt_ < maxAttempts_;
+}
+
+RetryStep UpstreamRetryLoop::fail(bool deadlineMissed) {
+    if (deadlineMissed && !reissueUsed_) {
+        reissueUsed_ = true;
+        reissuePending_ = true;
+        return RetryStep::Reissue;
+    }
+    return attempt_ < maxAttempts_ - 1 ? RetryStep::Backoff : RetryStep::GiveUp;
+}
+
+bool UpstreamPolicy::allowRequest(uint32_t nowMs) {
+    bool allowed = true;
+    if (circuitState == CircuitState::Open) {
+        if (nowMs - openedAtMs >= openWindowMs) {
+            circuitState = CircuitState::HalfOpen;
+            probeInFlight = false;
+        } else {
+            allowed = false;
+        }
+    }
+    if (circuitState == CircuitState::HalfOpen) {
+        if (probeInFlight) {
+            allowed = false;
+        } else {
+            probeInFlight = true;
+        }
+    }
+    return allowed;
+}
+
+uint32_t UpstreamPolicy::requestTimeoutMs() const {
+    if (ttfbCount < kTtfbMinSamples) return kDefaultTimeoutMs;
+    uint32_t timeout = p95TtfbMs * 2;
+    if (timeout < kMinTimeoutMs) timeout = kMinTimeoutMs;
+    if (timeout > kMaxTimeoutMs) timeout = kMaxTimeoutMs;
+    return timeout;
+}
+
+void UpstreamPolicy::recordSuccess(uint32_t ttfbMs, uint32_t nowMs) {
+    totalRequests++;
+    if (lastSuccessMs != 0) successIntervalMs = nowMs - lastSuccessMs;
+    lastSuccessMs = nowMs;
+    ttfbSamples[ttfbNext] = (uint16_t)(ttfbMs > 0xFFFF ? 0xFFFF : ttfbMs);
+    ttfbNext = (ttfbNext + 1) % kTtfbSamples;
+    if (ttfbCount < kTtfbSamples) ttfbCount++;
+    recomputeP95();
+    circuitState = CircuitState::Closed;
+    consecutiveFailures = 0;
+    openStreak = 0;
+    probeInFlight = false;
+}
+
+bool UpstreamPolicy::recordFailure(bool afterReissue, uint32_t nowMs, uint32_t random) {
+    const uint16_t failures = afterReissue ? 2 : 1;
+    totalRequests++;
+    totalFailures += failures;
+    const uint32_t streak = (uint32_t)consecutiveFailures + failures;
+    consecutiveFailures = streak > 0xFFFF ? 0xFFFF : (uint16_t)streak;
+    if (circuitState == CircuitState::HalfOpen
+        || (circuitState == CircuitState::Closed && consecutiveFailures >= kFailuresToOpen)) {
+        openCircuit(nowMs, random);
+        return true;
+    }
+    return false;
+}
+
+void UpstreamPolicy::recordReissue() {
+    totalRequests++;
+    reissues++;
+}
+
+RetryStep UpstreamPolicy::recordAttemptFailure(UpstreamRetryLoop& loop, bool deadlineMissed,
+    uint32_t nowMs, uint32_t random) {
+    const RetryStep step = loop.fail(deadlineMissed);
+    if (step == RetryStep::Reissue) {
+        recordReissue();
+    } else {
+        recordFailure(loop.reissuing(), nowMs, random);
+    }
+    return step;
+}
+
+void UpstreamPolicy::getStats(UpstreamHealthStats& out, uint32_t nowMs) const {
+    out.circuit = circuitState;
+    out.p95TtfbMs = p95TtfbMs;
+    out.requestTimeoutMs = requestTimeoutMs();
+    out.retryInMs = 0;
+    if (circuitState == CircuitState::Open) {
+        const uint32_t elapsed = nowMs - openedAtMs;
+        out.retryInMs = elapsed < openWindowMs ? openWindowMs - elapsed : 0;
+    }
+    out.consecutiveFailures = consecutiveFailures;
+    out.totalRequests = totalRequests;
+    out.totalFailures = totalFailures;
+    out.reissues = reissues;
+    out.circuitOpens = circuitOpens;
+    out.lastSuccessMs = lastSuccessMs;
+    out.successIntervalMs = successIntervalMs;
+}
+
+void UpstreamPolicy::recomputeP95() {
+    uint16_t sorted[kTtfbSamples];
+    for (size_t i = 0; i < ttfbCount; ++i) {
+        sorted[i] = ttfbSamples[i];
+    }
+    for (size_t i = 1; i < ttfbCount; ++i) {
+        uint16_t v = sorted[i];
+        size_t j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            --j;
+        }
+        sorted[j] = v;
+    }
+    size_t idx = (ttfbCount * 95 + 99) / 100;
+    if (idx > 0) idx--;
+    p95TtfbMs = sorted[idx];
+}
+
+void UpstreamPolicy::openCircuit(uint32_t nowMs, uint32_t random) {
+    uint32_t window = kOpenBaseMs << (openStreak < 5 ? openStreak : 5);
+    if (window > kOpenMaxMs) window = kOpenMaxMs;
+    if (openStreak < 255) openStreak++;
+    circuitState = CircuitState::Open;
+    openedAtMs = nowMs;
+    openWindowMs = backoffJitterMs(window, random);
+    probeInFlight = false;
+    circuitOpens++;
+}
+
+const char* upstreamCircuitName(CircuitState state) {
+    switch (state) {
+        case CircuitState::Closed:
+            return "closed";
+        case CircuitState::Open:
+            return "open";
+        case CircuitState::HalfOpen:
+            return "half-open";
+    }
+    return "?";
+}
@@ -0,0 +1,335 @@
+#include "wifi_link.h"
+
+#include <WiFi.h>
+#include <Preferences.h>
+#include <esp_netif.h>
+#include <lwip/dhcp.h>
+#include <time.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "backoff.h"
+#include "secrets.h"
+
+const uint32_t kWifiReconnectBucketMs[kWifiReconnectBuckets] = {
+    500, 1000, 2000, 5000, 15000, 0xFFFFFFFFu
+};
+
+namespace {
+    constexpr const char* PREFS_NAMESPACE = "wifilink";
+    constexpr uint32_t FAST_CONNECT_TIMEOUT_MS = 3000;
+    constexpr uint32_t FULL_CONNECT_TIMEOUT_MS = 15000;
+    constexpr uint32_t BACKOFF_BASE_MS = 1000;
+    constexpr uint32_t BACKOFF_MAX_MS = 30000;
+    constexpr uint32_t LINK_TASK_STACK = 4096;
+    // Used when the DHCP server's lease time cannot be read
+    constexpr uint32_t DEFAULT_LEASE_S = 2 * 3600;
+    constexpr uint32_t LEASE_CHECK_MS = 60000;
+
+    constexpr EventBits_t LINK_UP_BIT = 1 << 0;
+    constexpr EventBits_t LINK_DOWN_BIT = 1 << 1;
+
+    // What the last DHCP connect gave us. The lease is reused as a static
+    // config on the fast path. Nothing checks a static address against the
+    // router: association succeeds and GOT_IP fires even if the lease has
+    // expired and the address went to another host. So the cache is only
+    // trusted until the lease's renewal time (T1, half the lease), and a
+    // link still running on it then is reconnected over DHCP.
+    struct LinkCache {
+        uint8_t bssid[6];
+        uint8_t channel;
+        uint32_t ip;
+        uint32_t gateway;
+        uint32_t subnet;
+        uint32_t dns;
+        uint32_t leaseEpoch;    // wall time of the grant, 0 if NTP had not synced
+        uint32_t leaseSeconds;
+    };
+
+    EventGroupHandle_t linkEvents = nullptr;
+    SemaphoreHandle_t statsMutex = nullptr;
+    TaskHandle_t linkTask = nullptr;
+
+    LinkCache cache = {};
+    bool cacheValid = false;
+    // The current session runs on the cached lease (static config)
+    bool onCachedLease = false;
+    uint32_t leaseAtMs = 0;
+
+    WifiLinkState linkState = WifiLinkState::Connecting;
+    uint32_t connects = 0;
+    uint32_t reconnects = 0;
+    uint32_t fastConnects = 0;
+    uint32_t dhcpFallbacks = 0;
+    uint32_t lastReconnectMs = 0;
+    uint32_t downSinceMs = 0;
+    uint32_t reconnectHist[kWifiReconnectBuckets] = {0};
+
+    void lock() {
+        if (statsMutex) xSemaphoreTake(statsMutex, portMAX_DELAY);
+    }
+
+    void unlock() {
+        if (statsMutex) xSemaphoreGive(statsMutex);
+    }
+
+    void loadCache() {
+        Preferences prefs;
+        if (!prefs.begin(PREFS_NAMESPACE, true)) return;
+        cacheValid = prefs.getBytes("cache", &cache, sizeof(cache)) == sizeof(cache)
+            && cache.channel != 0 && cache.ip != 0;
+        prefs.end();
+    }
+
+    uint32_t wallEpoch() {
+        const time_t now = time(nullptr);
+        return now > 100000 ? (uint32_t)now : 0;
+    }
+
+    // Lease time the DHCP server offered on this connect
+    uint32_t offeredLeaseSeconds() {
+        esp_netif_t* sta = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+        struct netif* lwipNetif = sta ? (struct netif*)esp_netif_get_netif_impl(sta) : nullptr;
+        const struct dhcp* dhcp = lwipNetif ? netif_dhcp_data(lwipNetif) : nullptr;
+        if (!dhcp || dhcp->offered_t0_lease == 0 || dhcp->offered_t0_lease == 0xFFFFFFFFu) {
+            return DEFAULT_LEASE_S;
+        }
+        return dhcp->offered_t0_lease;
+    }
+
+    // Seconds the cached lease can still be used as a static config; 0
+    // when it is past T1 or its age is unknown (no wall time yet, or the
+    // grant was never stamped).
+    uint32_t cacheTrustLeftS() {
+        if (!cacheValid || cache.leaseEpoch == 0) return 0;
+        const uint32_t now = wallEpoch();
+        if (now == 0 || now < cache.leaseEpoch) return 0;
+        const uint32_t age = now - cache.leaseEpoch;
+        const uint32_t trust = cache.leaseSeconds / 2;
+        return age < trust ? trust - age : 0;
+    }
+
+    void persistCache() {
+        Preferences prefs;
+        if (!prefs.begin(PREFS_NAMESPACE, false)) return;
+        prefs.putBytes("cache", &cache, sizeof(cache));
+        prefs.end();
+    }
+
+    void saveCache() {
+        // Never persist a link that has no address yet
+        const IPAddress ip = WiFi.localIP();
+        if (ip == INADDR_NONE || (uint32_t)ip == 0) return;
+        LinkCache fresh = {};
+        const uint8_t* bssid = WiFi.BSSID();
+        if (bssid) memcpy(fresh.bssid, bssid, sizeof(fresh.bssid));
+        fresh.channel = (uint8_t)WiFi.channel();
+        fresh.ip = (uint32_t)ip;
+        fresh.gateway = (uint32_t)WiFi.gatewayIP();
+        fresh.subnet = (uint32_t)WiFi.subnetMask();
+        fresh.dns = (uint32_t)WiFi.dnsIP(0);
+        fresh.leaseEpoch = wallEpoch();
+        fresh.leaseSeconds = offeredLeaseSeconds();
+        leaseAtMs = millis();
+
+        cache = fresh;
+        cacheValid = fresh.channel != 0 && fresh.ip != 0;
+        persistCache();
+    }
+
+    // A lease granted before NTP synced gets its wall time once it is known,
+    // counted back from when it was granted.
+    void stampLease() {
+        if (!cacheValid || onCachedLease || cache.leaseEpoch != 0) return;
+        const uint32_t now = wallEpoch();
+        if (now == 0) return;
+        cache.leaseEpoch = now - (millis() - leaseAtMs) / 1000;
+        persistCache();
+    }
+
+    // Called before each WiFi.begin: a LINK_UP_BIT left from the previous
+    // session would let waitConnected return before this one has an IP.
+    void clearLinkBits() {
+        xEventGroupClearBits(linkEvents, LINK_UP_BIT | LINK_DOWN_BIT);
+    }
+
+    bool waitConnected(uint32_t timeoutMs) {
+        const EventBits_t bits = xEventGroupWaitBits(linkEvents, LINK_UP_BIT,
+            pdFALSE, pdTRUE, pdMS_TO_TICKS(timeoutMs));
+        return (bits & LINK_UP_BIT) != 0;
+    }
+
+    bool connectFast() {
+        if (cacheTrustLeftS() == 0) return false;
+        WiFi.config(IPAddress(cache.ip), IPAddress(cache.gateway),
+            IPAddress(cache.subnet), IPAddress(cache.dns));
+        clearLinkBits();
+        WiFi.begin(WIFI_SSID_SECRET, WIFI_PASS_SECRET, cache.channel, cache.bssid, true);
+        if (waitConnected(FAST_CONNECT_TIMEOUT_MS)) return true;
+        WiFi.disconnect(false, false);
+        return false;
+    }
+
+    bool connectFull() {
+        // Back to DHCP and a full scan
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+        clearLinkBits();
+        WiFi.begin(WIFI_SSID_SECRET, WIFI_PASS_SECRET);
+        if (waitConnected(FULL_CONNECT_TIMEOUT_MS)) {
+            saveCache();
+            return true;
+        }
+        WiFi.disconnect(false, false);
+        return false;
+    }
+
+    void recordConnected(uint32_t startMs, bool fast, bool fellBack, bool isReconnect) {
+        const uint32_t tookMs = millis() - startMs;
+        lock();
+        linkState = WifiLinkState::Up;
+        connects++;
+        if (fast) fastConnects++;
+        if (fellBack) dhcpFallbacks++;
+        if (isReconnect) {
+            reconnects++;
+            lastReconnectMs = tookMs;
+            for (size_t i = 0; i < kWifiReconnectBuckets; ++i) {
+                if (tookMs <= kWifiReconnectBucketMs[i]) {
+                    reconnectHist[i]++;
+                    break;
+                }
+            }
+        }
+        unlock();
+        Serial.printf("[wifi] up in %lums (%s) IP: %s ch=%d rssi=%d\n",
+            (unsigned long)tookMs, fast ? "cached" : "scan",
+            WiFi.localIP().toString().c_str(), (int)WiFi.channel(), (int)WiFi.RSSI());
+    }
+
+    void onWifiEvent(arduino_event_id_t event, arduino_event_info_t) {
+        if (!linkEvents) return;
+        if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+            xEventGroupClearBits(linkEvents, LINK_DOWN_BIT);
+            xEventGroupSetBits(linkEvents, LINK_UP_BIT);
+        } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+            xEventGroupClearBits(linkEvents, LINK_UP_BIT);
+            xEventGroupSetBits(linkEvents, LINK_DOWN_BIT);
+        }
+    }
+
+    void wifiLinkTask(void*) {
+        WiFi.mode(WIFI_STA);
+        // The supervisor owns reconnects; the driver's own retry loop would race it
+        WiFi.setAutoReconnect(false);
+        loadCache();
+
+        bool isReconnect = false;
+        for (;;) {
+            const uint32_t startMs = millis();
+            int attempt = 0;
+            for (;;) {
+                const bool hadCache = cacheTrustLeftS() > 0;
+                if (connectFast()) {
+                    onCachedLease = true;
+                    recordConnected(startMs, true, false, isReconnect);
+                    break;
+                }
+                if (connectFull()) {
+                    onCachedLease = false;
+                    recordConnected(startMs, false, hadCache, isReconnect);
+                    break;
+                }
+                uint32_t delayMs = backoffDelayMs(BACKOFF_BASE_MS, attempt++, esp_random());
+                if (delayMs > BACKOFF_MAX_MS) delayMs = BACKOFF_MAX_MS;
+                Serial.printf("[wifi] connect failed, retry in %lums\n", (unsigned long)delayMs);
+                vTaskDelay(pdMS_TO_TICKS(delayMs));
+            }
+
+            // While up: stamp a lease granted before NTP, and leave the cached
+            // lease before the router may hand its address to someone else.
+            // The driver's DHCP client renews a DHCP session on its own.
+            bool renew = false;
+            for (;;) {
+                const EventBits_t bits = xEventGroupWaitBits(linkEvents, LINK_DOWN_BIT,
+                    pdTRUE, pdTRUE, pdMS_TO_TICKS(LEASE_CHECK_MS));
+                if (bits & LINK_DOWN_BIT) break;
+                stampLease();
+                if (onCachedLease && cacheTrustLeftS() == 0) {
+                    renew = true;
+                    break;
+                }
+            }
+            if (renew) {
+                Serial.println("[wifi] cached lease due for renewal, reconnecting over DHCP");
+                lock();
+                linkState = WifiLinkState::Connecting;
+                unlock();
+                WiFi.disconnect(false, false);
+                isReconnect = false;
+                continue;
+            }
+
+            lock();
+            linkState = WifiLinkState::Down;
+            downSinceMs = millis();
+            unlock();
+            Serial.println("[wifi] link down, reconnecting");
+            WiFi.disconnect(false, false);
+            isReconnect = true;
+        }
+    }
+}
+
+void wifiLinkStart() {
+    if (linkTask) return;
+    if (!linkEvents) linkEvents = xEventGroupCreate();
+    if (!statsMutex) statsMutex = xSemaphoreCreateMutex();
+    WiFi.onEvent(onWifiEvent);
+    if (xTaskCreate(wifiLinkTask, "wifi_link", LINK_TASK_STACK, NULL, 2, &linkTask) != pdPASS) {
+        Serial.println("Warn: wifi_link task creation failed");
+        linkTask = nullptr;
+    }
+}
+
+bool wifiLinkIsUp() {
+    return linkEvents && (xEventGroupGetBits(linkEvents) & LINK_UP_BIT) != 0;
+}
+
+bool wifiLinkWaitUp(uint32_t timeoutMs) {
+    if (!linkEvents) return false;
+    const TickType_t ticks = timeoutMs == portMAX_DELAY ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs);
+    const EventBits_t bits = xEventGroupWaitBits(linkEvents, LINK_UP_BIT, pdFALSE, pdTRUE, ticks);
+    return (bits & LINK_UP_BIT) != 0;
+}
+
+void wifiLinkGetStats(WifiLinkStats& out) {
+    const bool up = wifiLinkIsUp();
+    lock();
+    out.state = linkState;
+    out.connects = connects;
+    out.reconnects = reconnects;
+    out.fastConnects = fastConnects;
+    out.dhcpFallbacks = dhcpFallbacks;
+    out.lastReconnectMs = lastReconnectMs;
+    out.downForMs = linkState == WifiLinkState::Down ? millis() - downSinceMs : 0;
+    for (size_t i = 0; i < kWifiReconnectBuckets; ++i) {
+        out.reconnectHist[i] = reconnectHist[i];
+    }
+    unlock();
+    out.rssi = up ? (int8_t)WiFi.RSSI() : 0;
+    out.channel = up ? (uint8_t)WiFi.channel() : 0;
+}
+
+const char* wifiLinkStateName(WifiLinkState state) {
+    switch (state) {
+        case WifiLinkState::Connecting:
+            return "connecting";
+        case WifiLinkState::Up:
+            return "up";
+        case WifiLinkState::Down:
+            return "down";
+    }
+    return "?";
+}
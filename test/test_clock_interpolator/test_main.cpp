@@ -0,0 +1,258 @@
+#include <unity.h>
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "display/clock_interpolator.h"
+
+// Replays a period of play against the interpolator: an arena clock that
+// stops and starts, a poll every 10 s whose sample reaches the device
+// after a response delay and a parse delay, and a frame every 33 ms (the
+// display task's interval). The
+// error is measured against the arena clock while it runs, once the
+// device has applied a given number of samples taken since the clock
+// last started.
+
+namespace {
+    constexpr uint32_t STEP_MS = 33;
+    constexpr uint32_t POLL_MS = 10000;
+    constexpr uint32_t REQUEST_MIN_MS = 40;     // poll start -> server sample
+    constexpr uint32_t REQUEST_MAX_MS = 200;
+    constexpr uint32_t RESPONSE_MIN_MS = 60;    // server sample -> headers
+    constexpr uint32_t RESPONSE_MAX_MS = 300;
+    constexpr uint32_t PARSE_MIN_MS = 300;      // headers -> data model
+    constexpr uint32_t PARSE_MAX_MS = 1500;
+    constexpr int32_t PERIOD_MS = 20 * 60 * 1000;
+
+    uint32_t rngState = 1;
+    uint32_t nextRand(uint32_t range) {
+        rngState = rngState * 1664525u + 1013904223u;
+        return (rngState >> 8) % range;
+    }
+
+    // Uniform in [lo, hi], on the frame grid
+    uint32_t between(uint32_t lo, uint32_t hi) {
+        return (lo + nextRand(hi - lo + 1)) / STEP_MS * STEP_MS;
+    }
+
+    bool reached(uint32_t now, uint32_t at) {
+        return (int32_t)(now - at) >= 0;
+    }
+
+    enum class Stamp { ResponseHeaders, Ingest };
+
+    struct ReplayResult {
+        int32_t maxOverMs;     // display shows more time than the arena
+        int32_t maxUnderMs;    // display shows less (negative)
+        int64_t sumErrorMs;
+        uint32_t frames;
+        uint32_t countedUp;    // running frames where the display rose
+    };
+
+    ReplayResult replay(Stamp stamp, uint32_t seed, uint32_t startMs, int settleSamples = 3) {
+        rngState = seed;
+        ClockInterpolator clock;
+        ReplayResult r = {INT32_MIN, INT32_MAX, 0, 0, 0};
+
+        int32_t arenaMs = PERIOD_MS;
+        bool arenaRunning = true;
+        uint32_t lastToggle = startMs;
+        uint32_t nextToggle = startMs + between(20000, 60000);
+
+        uint32_t pollAt = startMs;
+        bool inFlight = false;
+        uint32_t sampleAt = 0;
+        uint32_t headersAt = 0;
+        uint32_t ingestAt = 0;
+        bool sampled = false;
+        uint16_t sampleTenths = 0;
+        bool sampleRunning = false;
+        uint32_t sampleTakenMs = 0;
+
+        int samplesSinceStart = 0;  // running samples applied since the last toggle
+        int32_t lastShown = -1;
+
+        for (uint32_t now = startMs; arenaMs > 0; now += STEP_MS) {
+            if (reached(now, nextToggle)) {
+                arenaRunning = !arenaRunning;
+                lastToggle = now;
+                samplesSinceStart = 0;
+                nextToggle = now + (arenaRunning ? between(20000, 60000) : between(10000, 40000));
+            }
+
+            if (!inFlight && reached(now, pollAt)) {
+                inFlight = true;
+                sampled = false;
+                sampleAt = now + between(REQUEST_MIN_MS, REQUEST_MAX_MS);
+                headersAt = sampleAt + between(RESPONSE_MIN_MS, RESPONSE_MAX_MS);
+                ingestAt = headersAt + between(PARSE_MIN_MS, PARSE_MAX_MS);
+                pollAt += POLL_MS;
+            }
+            if (inFlight && !sampled && reached(now, sampleAt)) {
+                // The feed reports whole seconds
+                sampleTenths = (uint16_t)(arenaMs / 1000 * 10);
+                sampleRunning = arenaRunning;
+                sampleTakenMs = now;
+                sampled = true;
+            }
+            if (inFlight && reached(now, ingestAt)) {
+                const uint32_t stampMs = stamp == Stamp::ResponseHeaders ? headersAt : now;
+                clock.sync(sampleTenths, sampleRunning, stampMs, now);
+                if (sampleRunning && (int32_t)(sampleTakenMs - lastToggle) >= 0) samplesSinceStart++;
+                inFlight = false;
+                if (!sampleRunning || abs(clock.lastCorrectionMs()) > 3000) lastShown = -1;
+            }
+
+            const int32_t shown = (int32_t)clock.displayTenths(now) * 100;
+            const bool settled = arenaRunning && samplesSinceStart >= settleSamples;
+            if (settled) {
+                const int32_t err = shown - arenaMs;
+                if (err > r.maxOverMs) r.maxOverMs = err;
+                if (err < r.maxUnderMs) r.maxUnderMs = err;
+                r.sumErrorMs += err;
+                r.frames++;
+                if (lastShown >= 0 && shown > lastShown) r.countedUp++;
+                lastShown = shown;
+            } else {
+                lastShown = -1;
+            }
+
+            if (arenaRunning) arenaMs -= STEP_MS;
+        }
+        return r;
+    }
+
+    void tick(ClockInterpolator& clock, uint32_t fromMs, uint32_t toMs) {
+        for (uint32_t t = fromMs; t < toMs; t += 10) clock.displayTenths(t);
+    }
+
+    void report(const char* label, const ReplayResult& r) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%s: %u frames, error %ld..%ld ms, mean %ld ms", label,
+            (unsigned)r.frames, (long)r.maxUnderMs, (long)r.maxOverMs,
+            (long)(r.frames ? r.sumErrorMs / r.frames : 0));
+        TEST_MESSAGE(msg);
+    }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// ============================================================================
+// REPLAY
+// ============================================================================
+
+void test_response_stamp_bounds_error_by_latency_and_rounding() {
+    for (uint32_t seed = 1; seed <= 8; ++seed) {
+        const ReplayResult r = replay(Stamp::ResponseHeaders, seed, 1000);
+        if (seed == 1) report("response headers", r);
+        TEST_ASSERT_GREATER_THAN(1000, r.frames);
+        // Over: the sample is at most RESPONSE_MAX_MS old at the stamp.
+        // Under: whole-second samples, plus tenths truncation on display.
+        TEST_ASSERT_LESS_OR_EQUAL(RESPONSE_MAX_MS + STEP_MS, r.maxOverMs);
+        TEST_ASSERT_GREATER_OR_EQUAL(-(1000 + 100 + (int32_t)STEP_MS), r.maxUnderMs);
+    }
+}
+
+void test_restart_stays_inside_snap_threshold() {
+    // From the first running sample after a stoppage the display slews in
+    // from the frozen value; it may be off by up to the snap threshold but
+    // never by more.
+    for (uint32_t seed = 1; seed <= 8; ++seed) {
+        const ReplayResult r = replay(Stamp::ResponseHeaders, seed, 1000, 1);
+        if (seed == 1) report("restart", r);
+        TEST_ASSERT_LESS_OR_EQUAL(3000 + RESPONSE_MAX_MS + STEP_MS, r.maxOverMs);
+        TEST_ASSERT_GREATER_OR_EQUAL(-(3000 + 1000 + 100 + (int32_t)STEP_MS), r.maxUnderMs);
+    }
+}
+
+void test_ingest_stamp_lags_by_parse_time() {
+    // Why the stamp moved: counting down from the ingest time shows the
+    // parse time as extra clock.
+    const ReplayResult headers = replay(Stamp::ResponseHeaders, 3, 1000);
+    const ReplayResult ingest = replay(Stamp::Ingest, 3, 1000);
+    report("ingest", ingest);
+    TEST_ASSERT_GREATER_THAN(RESPONSE_MAX_MS + PARSE_MIN_MS, ingest.maxOverMs);
+    const int64_t headersMean = headers.sumErrorMs / headers.frames;
+    const int64_t ingestMean = ingest.sumErrorMs / ingest.frames;
+    TEST_ASSERT_GREATER_THAN((int32_t)PARSE_MIN_MS, (int32_t)(ingestMean - headersMean));
+}
+
+void test_display_never_counts_up_while_running() {
+    for (uint32_t seed = 1; seed <= 8; ++seed) {
+        const ReplayResult r = replay(Stamp::ResponseHeaders, seed, 1000);
+        TEST_ASSERT_EQUAL_UINT32(0, r.countedUp);
+    }
+}
+
+void test_millis_rollover_mid_period() {
+    const ReplayResult base = replay(Stamp::ResponseHeaders, 5, 1000);
+    const ReplayResult wrapped = replay(Stamp::ResponseHeaders, 5, 0xFFFFFFFFu - 300000u + 1u);
+    TEST_ASSERT_EQUAL_UINT32(base.frames, wrapped.frames);
+    TEST_ASSERT_EQUAL_INT32(base.maxOverMs, wrapped.maxOverMs);
+    TEST_ASSERT_EQUAL_INT32(base.maxUnderMs, wrapped.maxUnderMs);
+}
+
+// ============================================================================
+// SYNC
+// ============================================================================
+
+void test_stopped_sample_snaps() {
+    ClockInterpolator clock;
+    clock.sync(6000, true, 1000, 1500);
+    TEST_ASSERT_EQUAL_UINT16(5995, clock.displayTenths(1500));
+    clock.sync(5000, false, 11000, 11800);
+    TEST_ASSERT_EQUAL_UINT16(5000, clock.displayTenths(12000));
+    TEST_ASSERT_EQUAL_UINT16(5000, clock.displayTenths(20000));
+}
+
+void test_large_error_snaps_small_error_slews() {
+    // Scenes tick every frame, so sync() always lands right after a tick
+    ClockInterpolator clock;
+    clock.sync(6000, true, 0, 0);
+    tick(clock, 0, 10000);
+    TEST_ASSERT_EQUAL_UINT16(5900, clock.displayTenths(10000));
+    // 1 s disagreement: absorbed at no more than 25% of the elapsed time
+    clock.sync(5890, true, 10000, 10000);
+    TEST_ASSERT_EQUAL_INT32(1000, clock.lastCorrectionMs());
+    TEST_ASSERT_EQUAL_UINT16(5900, clock.displayTenths(10000));
+    tick(clock, 10000, 10400);
+    TEST_ASSERT_EQUAL_UINT16(5895, clock.displayTenths(10400));
+    // 5 s disagreement: snap
+    tick(clock, 10400, 20000);
+    clock.sync(5000, true, 20000, 20000);
+    TEST_ASSERT_EQUAL_UINT16(5000, clock.displayTenths(20000));
+}
+
+// ============================================================================
+// TEXT
+// ============================================================================
+
+void test_parse_and_format_clock() {
+    TEST_ASSERT_EQUAL_UINT16(12050, parseClockTenths("20:05"));
+    TEST_ASSERT_EQUAL_UINT16(0, parseClockTenths(""));
+    TEST_ASSERT_EQUAL_UINT16(0, parseClockTenths("12:75"));
+    TEST_ASSERT_EQUAL_UINT16(0, parseClockTenths(nullptr));
+    char out[8];
+    formatClockTenths(7545, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("12:35", out);
+    formatClockTenths(7540, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("12:34", out);
+    formatClockTenths(0, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("00:00", out);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_response_stamp_bounds_error_by_latency_and_rounding);
+    RUN_TEST(test_restart_stays_inside_snap_threshold);
+    RUN_TEST(test_ingest_stamp_lags_by_parse_time);
+    RUN_TEST(test_display_never_counts_up_while_running);
+    RUN_TEST(test_millis_rollover_mid_period);
+    RUN_TEST(test_stopped_sample_snaps);
+    RUN_TEST(test_large_error_snaps_small_error_slews);
+    RUN_TEST(test_parse_and_format_clock);
+    return UNITY_END();
+}
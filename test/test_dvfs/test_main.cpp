@@ -0,0 +1,126 @@
+#include <unity.h>
+
+#include "dvfs_policy.h"
+
+// The governor's policy over every input combination, and which input
+// changes apply at once (raises) vs. after the downshift hold.
+
+namespace {
+    DvfsInputs in(uint8_t holds, bool animating, bool standby) {
+        DvfsInputs i;
+        i.networkHolds = holds;
+        i.animating = animating;
+        i.standby = standby;
+        return i;
+    }
+
+    void expect(uint16_t mhz, DvfsPs ps, const DvfsInputs& inputs) {
+        const DvfsTarget t = dvfsPolicy(inputs);
+        TEST_ASSERT_EQUAL_UINT16(mhz, t.cpuMhz);
+        TEST_ASSERT_EQUAL_STRING(dvfsPsName(ps), dvfsPsName(t.ps));
+    }
+
+    bool isLevel(uint16_t mhz) {
+        for (size_t i = 0; i < kDvfsLevels; ++i) {
+            if (kDvfsLevelMhz[i] == mhz) return true;
+        }
+        return false;
+    }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// ============================================================================
+// POLICY
+// ============================================================================
+
+void test_idle_static_scene() {
+    expect(80, DvfsPs::MinModem, in(0, false, false));
+}
+
+void test_fetch_runs_fast_with_modem_awake() {
+    expect(240, DvfsPs::None, in(1, false, false));
+    // Both pollers at once, and a fetch during a goal animation
+    expect(240, DvfsPs::None, in(2, false, false));
+    expect(240, DvfsPs::None, in(1, true, false));
+    expect(240, DvfsPs::None, in(255, true, false));
+}
+
+void test_animation_runs_fast_with_light_sleep() {
+    expect(240, DvfsPs::MinModem, in(0, true, false));
+}
+
+void test_standby_overrides_everything() {
+    expect(80, DvfsPs::MaxModem, in(0, false, true));
+    expect(80, DvfsPs::MaxModem, in(0, true, true));
+    // The heartbeat fetch stays at the idle clock but keeps the modem
+    // reachable for it
+    expect(80, DvfsPs::MinModem, in(1, false, true));
+    expect(80, DvfsPs::MinModem, in(3, true, true));
+}
+
+void test_every_target_is_a_known_level() {
+    for (int holds = 0; holds <= 2; ++holds) {
+        for (int flags = 0; flags < 4; ++flags) {
+            const DvfsTarget t = dvfsPolicy(in((uint8_t)holds, flags & 1, flags & 2));
+            TEST_ASSERT_TRUE(isLevel(t.cpuMhz));
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT16(kDvfsBusyMhz, kDvfsLevelMhz[kDvfsLevels - 1]);
+    TEST_ASSERT_EQUAL_UINT16(kDvfsIdleMhz, kDvfsLevelMhz[0]);
+}
+
+// ============================================================================
+// RAISE VS HOLD
+// ============================================================================
+
+void test_starting_a_fetch_is_always_a_raise() {
+    // From any non-standby state, a fetch must not wait for the hold
+    for (int animating = 0; animating <= 1; ++animating) {
+        const DvfsTarget before = dvfsPolicy(in(0, animating, false));
+        const DvfsTarget during = dvfsPolicy(in(1, animating, false));
+        TEST_ASSERT_TRUE(dvfsIsRaise(before, during));
+        // ...and finishing it waits, so back-to-back polls do not flap
+        TEST_ASSERT_FALSE(dvfsIsRaise(during, before));
+    }
+}
+
+void test_animation_start_raises_end_holds() {
+    const DvfsTarget idle = dvfsPolicy(in(0, false, false));
+    const DvfsTarget anim = dvfsPolicy(in(0, true, false));
+    TEST_ASSERT_TRUE(dvfsIsRaise(idle, anim));
+    TEST_ASSERT_FALSE(dvfsIsRaise(anim, idle));
+}
+
+void test_modem_only_changes_count() {
+    // Same clock, more awake modem: a raise
+    const DvfsTarget standby = dvfsPolicy(in(0, false, true));
+    const DvfsTarget heartbeat = dvfsPolicy(in(1, false, true));
+    TEST_ASSERT_TRUE(dvfsIsRaise(standby, heartbeat));
+    TEST_ASSERT_FALSE(dvfsIsRaise(heartbeat, standby));
+    // No change is not a raise
+    TEST_ASSERT_FALSE(dvfsIsRaise(heartbeat, heartbeat));
+}
+
+void test_ps_names() {
+    TEST_ASSERT_EQUAL_STRING("none", dvfsPsName(DvfsPs::None));
+    TEST_ASSERT_EQUAL_STRING("min-modem", dvfsPsName(DvfsPs::MinModem));
+    TEST_ASSERT_EQUAL_STRING("max-modem", dvfsPsName(DvfsPs::MaxModem));
+    TEST_ASSERT_EQUAL_STRING("?", dvfsPsName((DvfsPs)7));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_idle_static_scene);
+    RUN_TEST(test_fetch_runs_fast_with_modem_awake);
+    RUN_TEST(test_animation_runs_fast_with_light_sleep);
+    RUN_TEST(test_standby_overrides_everything);
+    RUN_TEST(test_every_target_is_a_known_level);
+    RUN_TEST(test_starting_a_fetch_is_always_a_raise);
+    RUN_TEST(test_animation_start_raises_end_holds);
+    RUN_TEST(test_modem_only_changes_count);
+    RUN_TEST(test_ps_names);
+    return UNITY_END();
+}
@@ -0,0 +1,274 @@
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "goal_watch.h"
+
+// Replays goals whose assists reach the feed late. The poller is modelled
+// the way playbyplay_service drives the watch: a 5 s base interval, the
+// follow-up burst from goalWatchNextPollDelayMs(), goalWatchAdd() on the
+// poll that announces the goal and goalWatchSetNames() on every later
+// poll. A goal animation plays for 17 s from the announcing poll; the
+// replays check which names it ends up showing and what the burst costs in
+// requests.
+
+namespace {
+    constexpr uint32_t BASE_POLL_MS = 5000;
+    constexpr uint32_t ANIMATION_MS = 17000;
+
+    // One state of a goal's details in the feed, from atMs after the goal
+    struct FeedState {
+        uint32_t atMs;
+        const char* scorer;
+        const char* assist1;
+        const char* assist2;
+    };
+
+    struct Script {
+        const char* name;
+        const FeedState* states;
+        size_t count;
+    };
+
+    // Assists on the next feed update
+    const FeedState QUICK[] = {
+        {0, "M. Marner", "", ""},
+        {3000, "M. Marner", "A. Matthews", "M. Rielly"},
+    };
+    // One assist at a time, the second well into the animation
+    const FeedState SLOW[] = {
+        {0, "C. Caufield", "", ""},
+        {6000, "C. Caufield", "N. Suzuki", ""},
+        {11000, "C. Caufield", "N. Suzuki", "L. Hutson"},
+    };
+    // Shown unassisted, then the scorer changes after a review
+    const FeedState REVIEWED[] = {
+        {0, "J. Tavares", "", ""},
+        {9000, "W. Nylander", "J. Tavares", ""},
+    };
+    // Scoring change long after the animation, inside the watch window
+    const FeedState LATE_CHANGE[] = {
+        {0, "K. Dach", "J. Slafkovsky", ""},
+        {240000, "K. Dach", "J. Slafkovsky", "M. Matheson"},
+    };
+
+    const Script SCRIPTS[] = {
+        {"quick", QUICK, 2},
+        {"slow", SLOW, 3},
+        {"reviewed", REVIEWED, 2},
+        {"late change", LATE_CHANGE, 2},
+    };
+
+    const FeedState& feedAt(const Script& s, uint32_t sinceGoalMs) {
+        size_t idx = 0;
+        for (size_t i = 0; i < s.count; ++i) {
+            if (s.states[i].atMs <= sinceGoalMs) idx = i;
+        }
+        return s.states[idx];
+    }
+
+    struct Replay {
+        uint32_t announceMs;        // poll that showed the goal
+        uint32_t finalNamesMs;      // poll that delivered the last feed state
+        uint32_t pollsIn60s;        // polls in the minute after the goal
+        char animationEnd[3][32];   // names on screen when the animation ends
+    };
+
+    // The goal is scored at goalMs; the first poll after it announces it.
+    // burst=false replays the watch without the faster polls.
+    Replay replay(const Script& s, uint32_t goalMs, bool burst, uint32_t untilMs) {
+        GoalWatch watch;
+        goalWatchClear(watch);
+        Replay r = {};
+        const uint32_t eventId = 151;
+        const FeedState& last = s.states[s.count - 1];
+        bool announced = false;
+        bool animationDone = false;
+
+        for (uint32_t now = 0; now < untilMs;) {
+            if (announced && !animationDone && now >= r.announceMs + ANIMATION_MS) {
+                // What the animation showed in its last frame
+                animationDone = true;
+            }
+            if (now >= goalMs) {
+                const FeedState& feed = feedAt(s, now - goalMs);
+                if (!announced) {
+                    announced = true;
+                    r.announceMs = now;
+                    goalWatchAdd(watch, eventId, feed.scorer, feed.assist1, feed.assist2, now);
+                    if (!burst) watch.followUpPolls = 0;
+                } else if (goalWatchExpire(watch, now) > 0) {
+                    WatchedGoal* w = goalWatchFind(watch, eventId);
+                    if (w) goalWatchSetNames(*w, feed.scorer, feed.assist1, feed.assist2);
+                }
+                const WatchedGoal* w = goalWatchFind(watch, eventId);
+                if (w && r.finalNamesMs == 0 && strcmp(w->scorer, last.scorer) == 0
+                    && strcmp(w->assist1, last.assist1) == 0 && strcmp(w->assist2, last.assist2) == 0) {
+                    r.finalNamesMs = now;
+                }
+                if (w && !animationDone) {
+                    strcpy(r.animationEnd[0], w->scorer);
+                    strcpy(r.animationEnd[1], w->assist1);
+                    strcpy(r.animationEnd[2], w->assist2);
+                }
+                if (now < goalMs + 60000) r.pollsIn60s++;
+            }
+            now += goalWatchNextPollDelayMs(watch, BASE_POLL_MS);
+        }
+        return r;
+    }
+
+    bool animationShowsFinal(const Script& s, const Replay& r) {
+        const FeedState& last = s.states[s.count - 1];
+        return strcmp(r.animationEnd[0], last.scorer) == 0 && strcmp(r.animationEnd[1], last.assist1) == 0
+            && strcmp(r.animationEnd[2], last.assist2) == 0;
+    }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// ============================================================================
+// WATCH TABLE
+// ============================================================================
+
+void test_add_find_and_set_names() {
+    GoalWatch watch;
+    goalWatchClear(watch);
+    TEST_ASSERT_NULL(goalWatchFind(watch, 10));
+    TEST_ASSERT_NULL(goalWatchFind(watch, 0));
+
+    goalWatchAdd(watch, 10, "A. Scorer", "", "", 1000);
+    TEST_ASSERT_EQUAL_UINT8(kGoalFollowUpPolls, watch.followUpPolls);
+    WatchedGoal* w = goalWatchFind(watch, 10);
+    TEST_ASSERT_NOT_NULL(w);
+    TEST_ASSERT_FALSE(goalWatchSetNames(*w, "A. Scorer", "", ""));
+    TEST_ASSERT_FALSE(goalWatchSetNames(*w, "A. Scorer", nullptr, nullptr));
+    TEST_ASSERT_TRUE(goalWatchSetNames(*w, "A. Scorer", "B. Helper", ""));
+    TEST_ASSERT_EQUAL_STRING("B. Helper", w->assist1);
+
+    // Re-announcing the same goal reuses its slot
+    goalWatchAdd(watch, 10, "A. Scorer", "B. Helper", "", 2000);
+    size_t used = 0;
+    for (const WatchedGoal& g : watch.goals) used += g.eventId != 0;
+    TEST_ASSERT_EQUAL_UINT32(1, used);
+}
+
+void test_full_table_evicts_oldest() {
+    GoalWatch watch;
+    goalWatchClear(watch);
+    for (uint32_t i = 0; i < kGoalWatchMax; ++i) {
+        goalWatchAdd(watch, 100 + i, "S", "", "", 1000 + i * 1000);
+    }
+    goalWatchAdd(watch, 200, "S", "", "", 9000);
+    TEST_ASSERT_NULL(goalWatchFind(watch, 100));
+    TEST_ASSERT_NOT_NULL(goalWatchFind(watch, 101));
+    TEST_ASSERT_NOT_NULL(goalWatchFind(watch, 200));
+}
+
+void test_watch_expires_after_five_minutes() {
+    GoalWatch watch;
+    goalWatchClear(watch);
+    goalWatchAdd(watch, 7, "S", "", "", 5000);
+    goalWatchAdd(watch, 8, "S", "", "", 65000);
+    TEST_ASSERT_EQUAL_UINT32(2, goalWatchExpire(watch, 5000 + kGoalWatchMs));
+    TEST_ASSERT_EQUAL_UINT32(1, goalWatchExpire(watch, 5000 + kGoalWatchMs + 1));
+    TEST_ASSERT_NULL(goalWatchFind(watch, 7));
+    TEST_ASSERT_EQUAL_UINT32(0, goalWatchExpire(watch, 65000 + kGoalWatchMs + 1));
+}
+
+void test_burst_then_base_interval() {
+    GoalWatch watch;
+    goalWatchClear(watch);
+    TEST_ASSERT_EQUAL_UINT32(BASE_POLL_MS, goalWatchNextPollDelayMs(watch, BASE_POLL_MS));
+    goalWatchAdd(watch, 1, "S", "", "", 0);
+    for (uint8_t i = 0; i < kGoalFollowUpPolls; ++i) {
+        TEST_ASSERT_EQUAL_UINT32(kGoalFollowUpIntervalMs, goalWatchNextPollDelayMs(watch, BASE_POLL_MS));
+    }
+    TEST_ASSERT_EQUAL_UINT32(BASE_POLL_MS, goalWatchNextPollDelayMs(watch, BASE_POLL_MS));
+}
+
+// ============================================================================
+// LATE-ASSIST REPLAYS
+// ============================================================================
+
+void test_late_assists_reach_the_animation() {
+    // Every phase of the goal against the poll schedule, 250 ms steps
+    for (size_t si = 0; si < 3; ++si) {
+        const Script& s = SCRIPTS[si];
+        uint32_t worstMs = 0;
+        uint32_t plainWorstMs = 0;
+        for (uint32_t phase = 0; phase < BASE_POLL_MS; phase += 250) {
+            const Replay burst = replay(s, 20000 + phase, true, 120000);
+            const Replay plain = replay(s, 20000 + phase, false, 120000);
+            TEST_ASSERT_TRUE(animationShowsFinal(s, burst));
+            const uint32_t tookMs = burst.finalNamesMs - burst.announceMs;
+            if (tookMs > worstMs) worstMs = tookMs;
+            TEST_ASSERT_TRUE(animationShowsFinal(s, plain));
+            if (plain.finalNamesMs - plain.announceMs > plainWorstMs) {
+                plainWorstMs = plain.finalNamesMs - plain.announceMs;
+            }
+            // The burst picks up a change within one follow-up interval of
+            // the feed showing it, the base interval within one base poll
+            const uint32_t shownAtMs = 20000 + phase + s.states[s.count - 1].atMs;
+            TEST_ASSERT_TRUE(burst.finalNamesMs - shownAtMs < kGoalFollowUpIntervalMs);
+            TEST_ASSERT_TRUE(plain.finalNamesMs - shownAtMs < BASE_POLL_MS);
+        }
+        char msg[120];
+        snprintf(msg, sizeof(msg), "%s: final names %u ms after the announce at worst, %u ms on 5 s polls alone",
+            s.name, (unsigned)worstMs, (unsigned)plainWorstMs);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_TRUE(worstMs < ANIMATION_MS);
+    }
+}
+
+void test_scoring_change_inside_watch_window_is_applied() {
+    const Script& s = SCRIPTS[3];
+    const Replay r = replay(s, 20000, true, 20000 + 300000);
+    TEST_ASSERT_FALSE(animationShowsFinal(s, r));
+    TEST_ASSERT_TRUE(r.finalNamesMs > 20000 + 240000);
+    TEST_ASSERT_TRUE(r.finalNamesMs <= 20000 + 240000 + BASE_POLL_MS);
+}
+
+void test_scoring_change_after_watch_window_is_left_to_final_reconcile() {
+    const FeedState veryLate[] = {
+        {0, "K. Dach", "", ""},
+        {kGoalWatchMs + 60000, "K. Dach", "M. Matheson", ""},
+    };
+    const Script s = {"very late", veryLate, 2};
+    const Replay r = replay(s, 20000, true, 20000 + kGoalWatchMs + 120000);
+    TEST_ASSERT_EQUAL_UINT32(0, r.finalNamesMs);
+}
+
+void test_request_cost_per_goal() {
+    // Polls in the minute after a goal, averaged over the goal's phase
+    uint32_t burstPolls = 0;
+    uint32_t plainPolls = 0;
+    for (uint32_t phase = 0; phase < BASE_POLL_MS; phase += 250) {
+        burstPolls += replay(SCRIPTS[0], 20000 + phase, true, 120000).pollsIn60s;
+        plainPolls += replay(SCRIPTS[0], 20000 + phase, false, 120000).pollsIn60s;
+    }
+    const uint32_t extraTenths = (burstPolls - plainPolls) * 10 / 20;
+    char msg[100];
+    snprintf(msg, sizeof(msg), "extra requests per goal: %u.%u (%u vs %u polls/min)",
+        (unsigned)(extraTenths / 10), (unsigned)(extraTenths % 10),
+        (unsigned)(burstPolls / 20), (unsigned)(plainPolls / 20));
+    TEST_MESSAGE(msg);
+    // Six 2 s polls replace about 2.4 base polls
+    TEST_ASSERT_TRUE(extraTenths >= 30 && extraTenths <= 40);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_add_find_and_set_names);
+    RUN_TEST(test_full_table_evicts_oldest);
+    RUN_TEST(test_watch_expires_after_five_minutes);
+    RUN_TEST(test_burst_then_base_interval);
+    RUN_TEST(test_late_assists_reach_the_animation);
+    RUN_TEST(test_scoring_change_inside_watch_window_is_applied);
+    RUN_TEST(test_scoring_change_after_watch_window_is_left_to_final_reconcile);
+    RUN_TEST(test_request_cost_per_goal);
+    return UNITY_END();
+}
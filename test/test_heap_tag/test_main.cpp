@@ -0,0 +1,262 @@
+#include <unity.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "heap_tag_table.h"
+
+// Leak tests for the heap attribution table. Scripted subsystems allocate
+// and free real host blocks through the same calls the malloc wrappers
+// make on the device; a leak has to show up in its own subsystem's live
+// bytes and nowhere else.
+
+namespace {
+    HeapTagTable table;
+
+    void* tagMalloc(size_t size, HeapTag tag) {
+        void* p = malloc(size);
+        if (p) table.recordAlloc(p, size, tag);
+        return p;
+    }
+
+    void tagFree(void* p) {
+        if (p) table.recordFree(p);
+        free(p);
+    }
+
+    void* tagRealloc(void* p, size_t size, HeapTag tag) {
+        // Only the old address is used after realloc, as in the wrapper;
+        // volatile keeps the use-after-free warning quiet
+        volatile uintptr_t old = (uintptr_t)p;
+        void* q = realloc(p, size);
+        table.recordRealloc((void*)old, q, size, tag);
+        return q;
+    }
+
+    HeapTagCounters counters(HeapTag tag) {
+        HeapTagStats stats;
+        table.getStats(stats);
+        return stats.tags[(size_t)tag];
+    }
+
+    uint32_t tracked() {
+        HeapTagStats stats;
+        table.getStats(stats);
+        return stats.tracked;
+    }
+
+    uint32_t rngState = 1;
+    uint32_t nextRand(uint32_t range) {
+        rngState = rngState * 1664525u + 1013904223u;
+        return (rngState >> 8) % range;
+    }
+
+    // One pbp poll: a response buffer and a burst of short strings, all
+    // released before the next poll
+    void pbpPoll() {
+        void* body = tagMalloc(6000, HeapTag::Pbp);
+        void* names[12];
+        for (void*& n : names) n = tagMalloc(24 + nextRand(40), HeapTag::Pbp);
+        for (void* n : names) tagFree(n);
+        tagFree(body);
+    }
+
+    // An API request whose body String grows while it is read
+    void apiRequest() {
+        void* body = tagMalloc(64, HeapTag::Api);
+        body = tagRealloc(body, 256, HeapTag::Api);
+        body = tagRealloc(body, 1024, HeapTag::Api);
+        tagFree(body);
+    }
+
+    // A logo load whose failed-decode path forgets the buffer
+    void* logoLoad(bool decodeFails, void*& cached) {
+        void* buf = tagMalloc(2048, HeapTag::Logos);
+        if (decodeFails) return buf;
+        tagFree(cached);
+        cached = buf;
+        return nullptr;
+    }
+}
+
+void setUp() {
+    table.clear();
+    rngState = 1;
+}
+
+void tearDown() {}
+
+// ============================================================================
+// COUNTERS
+// ============================================================================
+
+void test_live_peak_and_count_per_tag() {
+    void* a = tagMalloc(100, HeapTag::Pbp);
+    void* b = tagMalloc(300, HeapTag::Pbp);
+    void* c = tagMalloc(50, HeapTag::Display);
+    HeapTagCounters pbp = counters(HeapTag::Pbp);
+    TEST_ASSERT_EQUAL_UINT32(400, pbp.liveBytes);
+    TEST_ASSERT_EQUAL_UINT32(2, pbp.liveCount);
+    TEST_ASSERT_EQUAL_UINT32(2, pbp.allocs);
+
+    tagFree(b);
+    tagFree(a);
+    pbp = counters(HeapTag::Pbp);
+    TEST_ASSERT_EQUAL_UINT32(0, pbp.liveBytes);
+    TEST_ASSERT_EQUAL_UINT32(400, pbp.peakBytes);
+    TEST_ASSERT_EQUAL_UINT32(0, pbp.liveCount);
+    TEST_ASSERT_EQUAL_UINT32(2, pbp.allocs);
+    TEST_ASSERT_EQUAL_UINT32(50, counters(HeapTag::Display).liveBytes);
+    tagFree(c);
+    TEST_ASSERT_EQUAL_UINT32(0, tracked());
+}
+
+void test_untagged_blocks_are_only_histogrammed() {
+    void* p = tagMalloc(40, HeapTag::None);
+    HeapTagStats stats;
+    table.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.tracked);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.tags[(size_t)HeapTag::None].allocs);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.sizeHist[2]);
+    tagFree(p);
+}
+
+void test_free_elsewhere_credits_the_allocating_tag() {
+    // Allocated by the poller, freed by the display after a handoff
+    void* p = tagMalloc(512, HeapTag::Schedule);
+    TEST_ASSERT_EQUAL_UINT32(512, counters(HeapTag::Schedule).liveBytes);
+    tagFree(p);
+    TEST_ASSERT_EQUAL_UINT32(0, counters(HeapTag::Schedule).liveBytes);
+    TEST_ASSERT_EQUAL_UINT32(0, counters(HeapTag::Display).liveBytes);
+}
+
+void test_realloc_moves_the_charge() {
+    void* p = tagMalloc(64, HeapTag::Api);
+    p = tagRealloc(p, 4096, HeapTag::Api);
+    HeapTagCounters api = counters(HeapTag::Api);
+    TEST_ASSERT_EQUAL_UINT32(4096, api.liveBytes);
+    TEST_ASSERT_EQUAL_UINT32(1, api.liveCount);
+
+    // A failed realloc leaves the old block charged
+    table.recordRealloc(p, nullptr, 1u << 30, HeapTag::Api);
+    TEST_ASSERT_EQUAL_UINT32(4096, counters(HeapTag::Api).liveBytes);
+
+    // realloc(p, 0) frees
+    table.recordRealloc(p, nullptr, 0, HeapTag::Api);
+    free(p);
+    TEST_ASSERT_EQUAL_UINT32(0, counters(HeapTag::Api).liveBytes);
+    TEST_ASSERT_EQUAL_UINT32(0, tracked());
+}
+
+void test_size_histogram_classes() {
+    const size_t sizes[] = {1, 16, 17, 32, 1000, 8192, 16384, 16385, 100000};
+    for (size_t s : sizes) table.recordAlloc((void*)(uintptr_t)(0x1000 + s * 8), s, HeapTag::None);
+    HeapTagStats stats;
+    table.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.sizeHist[0]);  // <= 16
+    TEST_ASSERT_EQUAL_UINT32(2, stats.sizeHist[1]);  // <= 32
+    TEST_ASSERT_EQUAL_UINT32(1, stats.sizeHist[6]);  // <= 1024
+    TEST_ASSERT_EQUAL_UINT32(1, stats.sizeHist[9]);  // <= 8192
+    TEST_ASSERT_EQUAL_UINT32(3, stats.sizeHist[10]); // open-ended, above 8192
+    TEST_ASSERT_EQUAL_UINT32(16, heapSizeBucketLimit(0));
+    TEST_ASSERT_EQUAL_UINT32(8192, heapSizeBucketLimit(9));
+    TEST_ASSERT_EQUAL_UINT32(0, heapSizeBucketLimit(kHeapSizeBuckets - 1));
+    TEST_ASSERT_EQUAL_STRING("logos", heapTagName(HeapTag::Logos));
+}
+
+// ============================================================================
+// POINTER TABLE
+// ============================================================================
+
+void test_table_survives_churn_at_full_load() {
+    // Fake addresses: the table never dereferences them. Fill to the
+    // limit, then free and re-add in random order so probe chains wrap
+    // and shift; every block must still be found and credited.
+    static void* live[kHeapTableLimit];
+    for (size_t i = 0; i < kHeapTableLimit; ++i) {
+        live[i] = (void*)(uintptr_t)(0x3FC80000u + i * 16);
+        table.recordAlloc(live[i], 16, HeapTag::Display);
+    }
+    TEST_ASSERT_EQUAL_UINT32(kHeapTableLimit, tracked());
+    uint32_t next = 0x3FD00000u;
+    for (int round = 0; round < 20000; ++round) {
+        const size_t i = nextRand(kHeapTableLimit);
+        table.recordFree(live[i]);
+        live[i] = (void*)(uintptr_t)next;
+        next += 8 * (1 + nextRand(64));
+        table.recordAlloc(live[i], 16, HeapTag::Display);
+    }
+    TEST_ASSERT_EQUAL_UINT32(kHeapTableLimit * 16, counters(HeapTag::Display).liveBytes);
+    for (size_t i = 0; i < kHeapTableLimit; ++i) table.recordFree(live[i]);
+    TEST_ASSERT_EQUAL_UINT32(0, counters(HeapTag::Display).liveBytes);
+    TEST_ASSERT_EQUAL_UINT32(0, counters(HeapTag::Display).liveCount);
+    TEST_ASSERT_EQUAL_UINT32(0, tracked());
+}
+
+void test_full_table_counts_untracked() {
+    for (size_t i = 0; i < kHeapTableLimit + 5; ++i) {
+        table.recordAlloc((void*)(uintptr_t)(0x3FC80000u + i * 16), 32, HeapTag::Pbp);
+    }
+    HeapTagStats stats;
+    table.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(kHeapTableLimit, stats.tracked);
+    TEST_ASSERT_EQUAL_UINT32(5, stats.untracked);
+    TEST_ASSERT_EQUAL_UINT32(kHeapTableLimit * 32, stats.tags[(size_t)HeapTag::Pbp].liveBytes);
+    // Freeing a block that was never tracked changes nothing
+    table.recordFree((void*)(uintptr_t)(0x3FC80000u + (kHeapTableLimit + 2) * 16));
+    TEST_ASSERT_EQUAL_UINT32(kHeapTableLimit * 32, counters(HeapTag::Pbp).liveBytes);
+}
+
+// ============================================================================
+// LEAKS
+// ============================================================================
+
+void test_leak_is_pinned_on_its_subsystem() {
+    // 600 polls (50 min at 5 s), an API request every 4th, a logo load
+    // every 10th of which every 3rd fails to decode and leaks
+    void* cachedLogo = nullptr;
+    void* leaked[64];
+    size_t leakCount = 0;
+    for (int poll = 0; poll < 600; ++poll) {
+        pbpPoll();
+        if (poll % 4 == 0) apiRequest();
+        if (poll % 10 == 0) {
+            void* lost = logoLoad((poll / 10) % 3 == 2, cachedLogo);
+            if (lost) leaked[leakCount++] = lost;
+        }
+    }
+    char msg[120];
+    snprintf(msg, sizeof(msg), "after 600 polls: pbp %u B, api %u B, logos %u B live (%u leaked loads)",
+        (unsigned)counters(HeapTag::Pbp).liveBytes, (unsigned)counters(HeapTag::Api).liveBytes,
+        (unsigned)counters(HeapTag::Logos).liveBytes, (unsigned)leakCount);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL_UINT32(0, counters(HeapTag::Pbp).liveBytes);
+    TEST_ASSERT_EQUAL_UINT32(0, counters(HeapTag::Api).liveBytes);
+    TEST_ASSERT_TRUE(counters(HeapTag::Pbp).peakBytes >= 6000);
+    TEST_ASSERT_EQUAL_UINT32(20, leakCount);
+    // The cached logo plus every forgotten buffer
+    const HeapTagCounters logos = counters(HeapTag::Logos);
+    TEST_ASSERT_EQUAL_UINT32((leakCount + 1) * 2048, logos.liveBytes);
+    TEST_ASSERT_EQUAL_UINT32(leakCount + 1, logos.liveCount);
+    TEST_ASSERT_EQUAL_UINT32(60, logos.allocs);
+
+    for (size_t i = 0; i < leakCount; ++i) tagFree(leaked[i]);
+    tagFree(cachedLogo);
+    TEST_ASSERT_EQUAL_UINT32(0, counters(HeapTag::Logos).liveBytes);
+    TEST_ASSERT_EQUAL_UINT32(0, tracked());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_live_peak_and_count_per_tag);
+    RUN_TEST(test_untagged_blocks_are_only_histogrammed);
+    RUN_TEST(test_free_elsewhere_credits_the_allocating_tag);
+    RUN_TEST(test_realloc_moves_the_charge);
+    RUN_TEST(test_size_histogram_classes);
+    RUN_TEST(test_table_survives_churn_at_full_load);
+    RUN_TEST(test_full_table_counts_untracked);
+    RUN_TEST(test_leak_is_pinned_on_its_subsystem);
+    return UNITY_END();
+}
@@ -0,0 +1,373 @@
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define NET_TRACE_LOOPBACK 1
+#include <chrono>
+#include <thread>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#else
+#define NET_TRACE_LOOPBACK 0
+#endif
+
+#include "net_trace_record.h"
+
+// Phase accounting against a stand-in server with scripted delays: DNS,
+// connect, time to headers and body bytes arriving in chunks with gaps,
+// read by a parser with a per-byte cost. Requests go through the same
+// mark sequence as the pollers' fetch loops on a virtual clock, and the
+// trace has to hand back the delays that were injected. One more request
+// goes to a real loopback socket that holds back its accept and its first
+// response byte.
+
+namespace {
+    struct BodyChunk {
+        uint32_t gapMs;   // wait before these bytes arrive
+        uint32_t bytes;
+    };
+
+    struct StandIn {
+        uint32_t dnsMs;
+        uint32_t connectMs;   // TCP + TLS
+        uint32_t ttfbMs;
+        int httpCode;         // status the headers carry, or a client error
+        const BodyChunk* chunks;
+        size_t chunkCount;
+        uint32_t parseUsPerByte;
+    };
+
+    const BodyChunk STEADY_BODY[] = {{20, 1400}, {15, 1400}, {15, 1400}, {10, 900}};
+    const BodyChunk STALLED_BODY[] = {{20, 1400}, {2400, 1400}, {10, 900}};
+
+    // The poller's sequence: begin, preconnect (DNS, connect), GET (TTFB),
+    // then the timed parse split into body and parse
+    NetTrace fetch(const StandIn& server, uint32_t& nowMs, int attempt = 0) {
+        NetTrace trace;
+        netTraceStartAt(trace, "pbp", attempt, nowMs);
+        nowMs += server.dnsMs;
+        netTraceMarkAt(trace, NetPhase::Dns, nowMs);
+        nowMs += server.connectMs;
+        netTraceMarkAt(trace, NetPhase::Connect, nowMs);
+        nowMs += server.ttfbMs;
+        netTraceMarkAt(trace, NetPhase::Ttfb, nowMs);
+        if (server.httpCode != 200) {
+            netTraceFinish(trace, server.httpCode, false, 0);
+            return trace;
+        }
+        uint32_t parseUs = 0;
+        uint32_t bytes = 0;
+        for (size_t i = 0; i < server.chunkCount; ++i) {
+            nowMs += server.chunks[i].gapMs;
+            const uint32_t costUs = server.chunks[i].bytes * server.parseUsPerByte;
+            parseUs += costUs;
+            nowMs += costUs / 1000;
+            bytes += server.chunks[i].bytes;
+        }
+        netTraceMarkBodyAt(trace, parseUs, nowMs);
+        netTraceFinish(trace, server.httpCode, true, bytes);
+        return trace;
+    }
+
+    uint32_t bodyWaitMs(const StandIn& server) {
+        uint32_t ms = 0;
+        for (size_t i = 0; i < server.chunkCount; ++i) ms += server.chunks[i].gapMs;
+        return ms;
+    }
+
+    uint32_t parseMs(const StandIn& server) {
+        uint32_t ms = 0;
+        for (size_t i = 0; i < server.chunkCount; ++i) {
+            ms += server.chunks[i].bytes * server.parseUsPerByte / 1000;
+        }
+        return ms;
+    }
+
+    NetPhase slowestPhase(const NetTrace& trace) {
+        size_t worst = 0;
+        for (size_t p = 1; p < kNetPhaseCount; ++p) {
+            if (trace.phaseMs[p] > trace.phaseMs[worst]) worst = p;
+        }
+        return (NetPhase)worst;
+    }
+
+    uint32_t totalMs(const NetTrace& trace) {
+        uint32_t sum = 0;
+        for (size_t p = 0; p < kNetPhaseCount; ++p) sum += trace.phaseMs[p];
+        return sum;
+    }
+
+#if NET_TRACE_LOOPBACK
+    // ========================================================================
+    // LOOPBACK STAND-IN
+    // ========================================================================
+    // The kernel completes the TCP handshake from the listen backlog, so the
+    // connect phase waits for one byte the server sends after accept(), the
+    // way a TLS handshake needs the server to answer.
+
+    constexpr uint32_t ACCEPT_DELAY_MS = 150;
+    constexpr uint32_t FIRST_BYTE_DELAY_MS = 200;
+    constexpr uint32_t SLACK_MS = 1000;
+    const char LOOPBACK_BODY[] = "{\"plays\":[]}";
+
+    uint32_t monotonicMs() {
+        using namespace std::chrono;
+        return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    void sleepMs(uint32_t ms) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+
+    void serveOnce(int listener) {
+        // The delay runs from the connection showing up in the backlog, so
+        // it falls inside the client's connect phase
+        pollfd pending = {listener, POLLIN, 0};
+        if (poll(&pending, 1, 5000) != 1) return;
+        sleepMs(ACCEPT_DELAY_MS);
+        const int conn = accept(listener, nullptr, nullptr);
+        if (conn < 0) return;
+        const char hello = 'H';
+        send(conn, &hello, 1, 0);
+        char request[256];
+        recv(conn, request, sizeof(request), 0);
+        sleepMs(FIRST_BYTE_DELAY_MS);
+        char response[128];
+        const int n = snprintf(response, sizeof(response),
+            "HTTP/1.1 200 OK\r\nContent-Length: %u\r\n\r\n%s",
+            (unsigned)strlen(LOOPBACK_BODY), LOOPBACK_BODY);
+        send(conn, response, (size_t)n, 0);
+        close(conn);
+    }
+
+    // The poller's mark sequence on a real socket and the monotonic clock
+    NetTrace fetchLoopback(uint16_t port) {
+        NetTrace trace;
+        netTraceStartAt(trace, "loopback", 0, monotonicMs());
+
+        addrinfo hints = {};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addr = nullptr;
+        char service[8];
+        snprintf(service, sizeof(service), "%u", (unsigned)port);
+        if (getaddrinfo("localhost", service, &hints, &addr) != 0) {
+            netTraceFinish(trace, -1, false, 0);
+            return trace;
+        }
+        netTraceMarkAt(trace, NetPhase::Dns, monotonicMs());
+
+        const int sock = socket(AF_INET, SOCK_STREAM, 0);
+        char hello = 0;
+        const bool connected = sock >= 0 && connect(sock, addr->ai_addr, addr->ai_addrlen) == 0 &&
+            recv(sock, &hello, 1, 0) == 1;
+        freeaddrinfo(addr);
+        if (!connected) {
+            if (sock >= 0) close(sock);
+            netTraceFinish(trace, -1, false, 0);
+            return trace;
+        }
+        netTraceMarkAt(trace, NetPhase::Connect, monotonicMs());
+
+        const char request[] = "GET /pbp HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        send(sock, request, sizeof(request) - 1, 0);
+        char response[256];
+        size_t got = 0;
+        ssize_t n = recv(sock, response, sizeof(response) - 1, 0);
+        netTraceMarkAt(trace, NetPhase::Ttfb, monotonicMs());
+        while (n > 0) {
+            got += (size_t)n;
+            n = recv(sock, response + got, sizeof(response) - 1 - got, 0);
+        }
+        close(sock);
+        response[got] = '\0';
+        const char* body = strstr(response, "\r\n\r\n");
+        const uint32_t bytes = body ? (uint32_t)strlen(body + 4) : 0;
+        netTraceMarkBodyAt(trace, 0, monotonicMs());
+        netTraceFinish(trace, strncmp(response, "HTTP/1.1 200", 12) == 0 ? 200 : -1, body != nullptr, bytes);
+        return trace;
+    }
+#endif
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// ============================================================================
+// PHASES
+// ============================================================================
+
+void test_phases_match_injected_delays() {
+    const StandIn server = {35, 480, 220, 200, STEADY_BODY, 4, 40};
+    uint32_t now = 100000;
+    const NetTrace t = fetch(server, now);
+    TEST_ASSERT_EQUAL_UINT32(100000, t.startMs);
+    TEST_ASSERT_EQUAL_UINT32(35, t.phaseMs[(size_t)NetPhase::Dns]);
+    TEST_ASSERT_EQUAL_UINT32(480, t.phaseMs[(size_t)NetPhase::Connect]);
+    TEST_ASSERT_EQUAL_UINT32(220, t.phaseMs[(size_t)NetPhase::Ttfb]);
+    TEST_ASSERT_EQUAL_UINT32(bodyWaitMs(server), t.phaseMs[(size_t)NetPhase::Body]);
+    TEST_ASSERT_EQUAL_UINT32(parseMs(server), t.phaseMs[(size_t)NetPhase::Parse]);
+    // Phases add up to the whole attempt
+    TEST_ASSERT_EQUAL_UINT32(now - t.startMs, totalMs(t));
+    TEST_ASSERT_EQUAL_UINT8(0x1F, t.reached);
+    TEST_ASSERT_EQUAL_UINT32(5100, t.bytes);
+    TEST_ASSERT_TRUE(t.ok);
+}
+
+void test_slowest_phase_names_the_injected_stall() {
+    struct Case {
+        StandIn server;
+        NetPhase expected;
+    };
+    const Case cases[] = {
+        {{3100, 450, 200, 200, STEADY_BODY, 4, 40}, NetPhase::Dns},
+        {{30, 4200, 200, 200, STEADY_BODY, 4, 40}, NetPhase::Connect},
+        {{30, 450, 6500, 200, STEADY_BODY, 4, 40}, NetPhase::Ttfb},
+        {{30, 450, 200, 200, STALLED_BODY, 3, 40}, NetPhase::Body},
+        {{30, 450, 200, 200, STEADY_BODY, 4, 900}, NetPhase::Parse},
+    };
+    uint32_t now = 0;
+    for (const Case& c : cases) {
+        const NetTrace t = fetch(c.server, now);
+        char msg[120];
+        snprintf(msg, sizeof(msg), "%s stall: dns %u connect %u ttfb %u body %u parse %u ms",
+            netPhaseName(c.expected), (unsigned)t.phaseMs[0], (unsigned)t.phaseMs[1],
+            (unsigned)t.phaseMs[2], (unsigned)t.phaseMs[3], (unsigned)t.phaseMs[4]);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_EQUAL_UINT8((uint8_t)c.expected, (uint8_t)slowestPhase(t));
+    }
+}
+
+void test_failed_request_leaves_later_phases_unreached() {
+    // Headers never arrive: no body or parse, and the pollers keep those
+    // out of the histograms
+    const StandIn server = {30, 450, 5000, -11, nullptr, 0, 0};
+    uint32_t now = 0;
+    const NetTrace t = fetch(server, now, 1);
+    TEST_ASSERT_TRUE(netTraceReached(t, NetPhase::Ttfb));
+    TEST_ASSERT_FALSE(netTraceReached(t, NetPhase::Body));
+    TEST_ASSERT_FALSE(netTraceReached(t, NetPhase::Parse));
+    TEST_ASSERT_EQUAL_INT(-11, t.httpCode);
+    TEST_ASSERT_FALSE(t.ok);
+    TEST_ASSERT_EQUAL_UINT8(1, t.attempt);
+}
+
+void test_parse_time_is_capped_by_elapsed_time() {
+    NetTrace t;
+    netTraceStartAt(t, "schedule", -1, 1000);
+    TEST_ASSERT_EQUAL_UINT8(0, t.attempt);
+    // The parser claims more than the wall time since the last mark
+    netTraceMarkBodyAt(t, 90000, 1040);
+    TEST_ASSERT_EQUAL_UINT32(40, t.phaseMs[(size_t)NetPhase::Parse]);
+    TEST_ASSERT_EQUAL_UINT32(0, t.phaseMs[(size_t)NetPhase::Body]);
+}
+
+void test_marks_survive_millis_wrap() {
+    NetTrace t;
+    netTraceStartAt(t, "pbp", 0, 0xFFFFFF00u);
+    netTraceMarkAt(t, NetPhase::Dns, 0xFFFFFF80u);
+    netTraceMarkAt(t, NetPhase::Connect, 0x00000100u);
+    TEST_ASSERT_EQUAL_UINT32(0x80, t.phaseMs[(size_t)NetPhase::Dns]);
+    TEST_ASSERT_EQUAL_UINT32(0x180, t.phaseMs[(size_t)NetPhase::Connect]);
+}
+
+// ============================================================================
+// RING
+// ============================================================================
+
+void test_loopback_server_delays_show_in_connect_and_ttfb() {
+#if NET_TRACE_LOOPBACK
+    const int listener = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT_TRUE(listener >= 0);
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    local.sin_port = 0;
+    TEST_ASSERT_EQUAL_INT(0, bind(listener, (sockaddr*)&local, sizeof(local)));
+    TEST_ASSERT_EQUAL_INT(0, listen(listener, 1));
+    socklen_t len = sizeof(local);
+    TEST_ASSERT_EQUAL_INT(0, getsockname(listener, (sockaddr*)&local, &len));
+
+    std::thread server(serveOnce, listener);
+    const NetTrace t = fetchLoopback(ntohs(local.sin_port));
+    server.join();
+    close(listener);
+
+    TEST_ASSERT_TRUE(t.ok);
+    TEST_ASSERT_EQUAL_INT(200, t.httpCode);
+    TEST_ASSERT_EQUAL_UINT32(strlen(LOOPBACK_BODY), t.bytes);
+    TEST_ASSERT_EQUAL_UINT8(0x1F, t.reached);
+    const uint32_t connectMs = t.phaseMs[(size_t)NetPhase::Connect];
+    const uint32_t ttfbMs = t.phaseMs[(size_t)NetPhase::Ttfb];
+    TEST_ASSERT_TRUE(connectMs >= ACCEPT_DELAY_MS && connectMs < ACCEPT_DELAY_MS + SLACK_MS);
+    TEST_ASSERT_TRUE(ttfbMs >= FIRST_BYTE_DELAY_MS && ttfbMs < FIRST_BYTE_DELAY_MS + SLACK_MS);
+    // Nothing else was held back
+    TEST_ASSERT_TRUE(t.phaseMs[(size_t)NetPhase::Dns] < ACCEPT_DELAY_MS);
+    TEST_ASSERT_TRUE(t.phaseMs[(size_t)NetPhase::Body] < FIRST_BYTE_DELAY_MS);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "loopback: dns %u ms, connect %u ms, ttfb %u ms, body %u ms",
+        (unsigned)t.phaseMs[(size_t)NetPhase::Dns], (unsigned)connectMs, (unsigned)ttfbMs,
+        (unsigned)t.phaseMs[(size_t)NetPhase::Body]);
+    TEST_MESSAGE(msg);
+#else
+    TEST_IGNORE_MESSAGE("loopback sockets need a POSIX host");
+#endif
+}
+
+void test_ring_returns_newest_first_and_wraps() {
+    static NetTraceRing ring;
+    static NetTrace out[kNetTraceSlots];
+    TEST_ASSERT_EQUAL_UINT32(0, ring.recent(out, kNetTraceSlots));
+
+    const StandIn server = {30, 450, 200, 200, STEADY_BODY, 4, 40};
+    uint32_t now = 0;
+    for (int i = 0; i < 3; ++i) ring.push(fetch(server, now, i));
+    TEST_ASSERT_EQUAL_UINT32(3, ring.recent(out, kNetTraceSlots));
+    TEST_ASSERT_EQUAL_UINT8(2, out[0].attempt);
+    TEST_ASSERT_EQUAL_UINT8(0, out[2].attempt);
+    TEST_ASSERT_TRUE(out[0].startMs > out[1].startMs);
+
+    // Forty more: only the last kNetTraceSlots remain, still newest first
+    uint32_t lastStart = 0;
+    for (int i = 0; i < 40; ++i) {
+        const NetTrace t = fetch(server, now);
+        lastStart = t.startMs;
+        ring.push(t);
+    }
+    TEST_ASSERT_EQUAL_UINT32(kNetTraceSlots, ring.recent(out, kNetTraceSlots));
+    TEST_ASSERT_EQUAL_UINT32(lastStart, out[0].startMs);
+    for (size_t i = 1; i < kNetTraceSlots; ++i) {
+        TEST_ASSERT_TRUE(out[i - 1].startMs > out[i].startMs);
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, ring.recent(out, 4));
+    TEST_ASSERT_EQUAL_UINT32(lastStart, out[0].startMs);
+}
+
+void test_phase_names() {
+    TEST_ASSERT_EQUAL_STRING("dns", netPhaseName(NetPhase::Dns));
+    TEST_ASSERT_EQUAL_STRING("connect", netPhaseName(NetPhase::Connect));
+    TEST_ASSERT_EQUAL_STRING("ttfb", netPhaseName(NetPhase::Ttfb));
+    TEST_ASSERT_EQUAL_STRING("body", netPhaseName(NetPhase::Body));
+    TEST_ASSERT_EQUAL_STRING("parse", netPhaseName(NetPhase::Parse));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_phases_match_injected_delays);
+    RUN_TEST(test_slowest_phase_names_the_injected_stall);
+    RUN_TEST(test_failed_request_leaves_later_phases_unreached);
+    RUN_TEST(test_parse_time_is_capped_by_elapsed_time);
+    RUN_TEST(test_marks_survive_millis_wrap);
+    RUN_TEST(test_loopback_server_delays_show_in_connect_and_ttfb);
+    RUN_TEST(test_ring_returns_newest_first_and_wraps);
+    RUN_TEST(test_phase_names);
+    return UNITY_END();
+}
@@ -0,0 +1,146 @@
+#include <unity.h>
+
+#include "off_hours_plan.h"
+
+// Sleep planning against synthetic schedules, with the policy the device
+// runs: wake 30 min before a game, 3.5 h games, gaps under 2 h stay
+// awake, re-check the schedule at least daily.
+
+namespace {
+    constexpr int64_t HOUR = 3600;
+    // 2025-01-18 09:00 Eastern
+    constexpr int64_t MORNING = 1737208800;
+
+    const OffHoursPolicy& POLICY = kOffHoursPolicy;
+
+    OffHoursPlan plan(const int64_t* starts, size_t count, bool live = false, int64_t now = MORNING) {
+        return offHoursPlan(starts, count, live, now, POLICY);
+    }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// ============================================================================
+// PLAN
+// ============================================================================
+
+void test_policy_values() {
+    // The expectations below are written against these
+    TEST_ASSERT_EQUAL_UINT32(30 * 60, POLICY.preGameLeadS);
+    TEST_ASSERT_EQUAL_UINT32(3 * HOUR + 30 * 60, POLICY.gameLengthS);
+    TEST_ASSERT_EQUAL_UINT32(2 * HOUR, POLICY.minSleepS);
+    TEST_ASSERT_EQUAL_UINT32(24 * HOUR, POLICY.maxSleepS);
+}
+
+void test_sleeps_until_lead_time_before_evening_game() {
+    const int64_t starts[] = {MORNING + 10 * HOUR, MORNING + 11 * HOUR};
+    const OffHoursPlan p = plan(starts, 2);
+    TEST_ASSERT_TRUE(p.sleep);
+    TEST_ASSERT_EQUAL_INT64(MORNING + 10 * HOUR - 30 * 60, p.wakeEpoch);
+    TEST_ASSERT_EQUAL_UINT32(9 * HOUR + 30 * 60, p.sleepS);
+}
+
+void test_unsorted_schedule_wakes_for_earliest_game() {
+    const int64_t starts[] = {MORNING + 34 * HOUR, MORNING + 10 * HOUR, MORNING + 12 * HOUR};
+    const OffHoursPlan p = plan(starts, 3);
+    TEST_ASSERT_TRUE(p.sleep);
+    TEST_ASSERT_EQUAL_INT64(MORNING + 10 * HOUR - 30 * 60, p.wakeEpoch);
+}
+
+void test_empty_schedule_sleeps_max_then_rechecks() {
+    const OffHoursPlan p = plan(nullptr, 0);
+    TEST_ASSERT_TRUE(p.sleep);
+    TEST_ASSERT_EQUAL_UINT32(24 * HOUR, p.sleepS);
+    TEST_ASSERT_EQUAL_INT64(MORNING + 24 * HOUR, p.wakeEpoch);
+
+    // All-star break: next game three days out is capped the same way
+    const int64_t starts[] = {MORNING + 72 * HOUR};
+    TEST_ASSERT_EQUAL_UINT32(24 * HOUR, plan(starts, 1).sleepS);
+}
+
+void test_stays_awake_when_live_or_time_unknown() {
+    const int64_t starts[] = {MORNING + 10 * HOUR};
+    TEST_ASSERT_FALSE(plan(starts, 1, true).sleep);
+    TEST_ASSERT_FALSE(plan(starts, 1, false, 0).sleep);
+    TEST_ASSERT_FALSE(plan(starts, 1, false, -5).sleep);
+}
+
+void test_stays_awake_near_or_past_a_start() {
+    // Inside the lead time
+    const int64_t soon[] = {MORNING + 20 * 60};
+    TEST_ASSERT_FALSE(plan(soon, 1).sleep);
+    // Exactly at the lead time
+    const int64_t atLead[] = {MORNING + 30 * 60};
+    TEST_ASSERT_FALSE(plan(atLead, 1).sleep);
+    // Started but not final (delay, or a stale schedule), later games too
+    const int64_t overdue[] = {MORNING - HOUR, MORNING + 10 * HOUR};
+    TEST_ASSERT_FALSE(plan(overdue, 2).sleep);
+}
+
+void test_short_gaps_are_not_worth_a_reboot() {
+    const int64_t justUnder[] = {MORNING + 2 * HOUR + 30 * 60 - 1};
+    TEST_ASSERT_FALSE(plan(justUnder, 1).sleep);
+
+    const int64_t exactly[] = {MORNING + 2 * HOUR + 30 * 60};
+    const OffHoursPlan p = plan(exactly, 1);
+    TEST_ASSERT_TRUE(p.sleep);
+    TEST_ASSERT_EQUAL_UINT32(2 * HOUR, p.sleepS);
+}
+
+// ============================================================================
+// SLEEP FRACTION
+// ============================================================================
+
+void test_permille_for_overlapping_and_separate_days() {
+    // Two games three hours apart overlap: one 9.5 h sleep in a 16.5 h window
+    const int64_t sameNight[] = {MORNING + 13 * HOUR, MORNING + 10 * HOUR};
+    TEST_ASSERT_EQUAL_UINT16(575, offHoursSleepPermille(sameNight, 2, MORNING, POLICY));
+
+    // Tonight and tomorrow night: 9.5 h + 20 h asleep in 37.5 h
+    const int64_t twoNights[] = {MORNING + 10 * HOUR, MORNING + 34 * HOUR};
+    TEST_ASSERT_EQUAL_UINT16(786, offHoursSleepPermille(twoNights, 2, MORNING, POLICY));
+}
+
+void test_permille_edge_cases() {
+    TEST_ASSERT_EQUAL_UINT16(0, offHoursSleepPermille(nullptr, 0, MORNING, POLICY));
+    const int64_t starts[] = {MORNING + 10 * HOUR};
+    TEST_ASSERT_EQUAL_UINT16(0, offHoursSleepPermille(starts, 1, 0, POLICY));
+    // A game on now: nothing to sleep through
+    const int64_t now[] = {MORNING};
+    TEST_ASSERT_EQUAL_UINT16(0, offHoursSleepPermille(now, 1, MORNING, POLICY));
+    // Long finished games leave no window
+    const int64_t past[] = {MORNING - 10 * HOUR};
+    TEST_ASSERT_EQUAL_UINT16(0, offHoursSleepPermille(past, 1, MORNING, POLICY));
+}
+
+void test_permille_for_a_season_week_stays_bounded() {
+    // One 7 PM game a day for more entries than the planner keeps
+    int64_t starts[kOffHoursMaxStarts + 10];
+    for (size_t i = 0; i < kOffHoursMaxStarts + 10; ++i) {
+        starts[i] = MORNING + 10 * HOUR + (int64_t)i * 24 * HOUR;
+    }
+    const uint16_t week = offHoursSleepPermille(starts, 7, MORNING, POLICY);
+    // 9.5 h the first morning, then 20 h between games: 129.5 h of 157.5 h
+    TEST_ASSERT_EQUAL_UINT16(822, week);
+    const uint16_t capped = offHoursSleepPermille(starts, kOffHoursMaxStarts + 10, MORNING, POLICY);
+    TEST_ASSERT_EQUAL_UINT16(
+        offHoursSleepPermille(starts, kOffHoursMaxStarts, MORNING, POLICY), capped);
+    TEST_ASSERT_TRUE(capped <= 1000);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_policy_values);
+    RUN_TEST(test_sleeps_until_lead_time_before_evening_game);
+    RUN_TEST(test_unsorted_schedule_wakes_for_earliest_game);
+    RUN_TEST(test_empty_schedule_sleeps_max_then_rechecks);
+    RUN_TEST(test_stays_awake_when_live_or_time_unknown);
+    RUN_TEST(test_stays_awake_near_or_past_a_start);
+    RUN_TEST(test_short_gaps_are_not_worth_a_reboot);
+    RUN_TEST(test_permille_for_overlapping_and_separate_days);
+    RUN_TEST(test_permille_edge_cases);
+    RUN_TEST(test_permille_for_a_season_week_stays_bounded);
+    return UNITY_END();
+}
@@ -0,0 +1,317 @@
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display/panel_mirror_codec.h"
+
+// Round trip of the mirror's frame messages through a decoder written
+// from the format comment (the browser's, in C), and the bytes per second
+// the mirror sends at its default 10 fps. The scenes draw through the
+// HUB75 library, which the host cannot build, so the frames come from
+// models of them: the scoreboard with two logos, the score and a clock
+// ticking every second, and the goal animation's phases (bouncing GOAL
+// with flashing sirens, logo zoom, then the name card with rising bands
+// and confetti), each redrawn in full every frame as the scenes do.
+
+namespace {
+    constexpr int W = 64;
+    constexpr int H = 32;
+    constexpr size_t MAX_MESSAGE = 4 + H * (1 + 3 * W);
+    constexpr uint32_t MIRROR_FPS = 10;
+    constexpr uint32_t GOAL_MS = 17000;
+
+    typedef uint16_t Frame[W * H];
+
+    uint16_t rgb(uint8_t r, uint8_t g, uint8_t b) {
+        return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+    }
+
+    void fillRect(Frame f, int x, int y, int w, int h, uint16_t c) {
+        for (int yy = y; yy < y + h; ++yy) {
+            for (int xx = x; xx < x + w; ++xx) {
+                if (xx >= 0 && xx < W && yy >= 0 && yy < H) f[yy * W + xx] = c;
+            }
+        }
+    }
+
+    // 3x5 digits, as the scoreboard's mini font
+    const uint8_t DIGITS[10][5] = {
+        {7, 5, 5, 5, 7}, {2, 6, 2, 2, 7}, {7, 1, 7, 4, 7}, {7, 1, 7, 1, 7}, {5, 5, 7, 1, 1},
+        {7, 4, 7, 1, 7}, {7, 4, 7, 5, 7}, {7, 1, 2, 2, 2}, {7, 5, 7, 5, 7}, {7, 5, 7, 1, 7},
+    };
+
+    void drawGlyph(Frame f, int x, int y, const uint8_t rows[5], uint16_t c) {
+        for (int r = 0; r < 5; ++r) {
+            for (int col = 0; col < 3; ++col) {
+                if (rows[r] & (4 >> col)) fillRect(f, x + col, y + r, 1, 1, c);
+            }
+        }
+    }
+
+    void drawNumber(Frame f, int x, int y, int value, int digits, uint16_t c) {
+        for (int i = digits - 1; i >= 0; --i) {
+            drawGlyph(f, x + i * 4, y, DIGITS[value % 10], c);
+            value /= 10;
+        }
+    }
+
+    // A team logo: flat colour regions with a one-pixel blended edge, the
+    // way the 20 px cached logos look after downscaling
+    void drawLogo(Frame f, int x, int y, int size, uint32_t seed) {
+        const uint16_t main = rgb(0, 32 + seed % 64, 160);
+        const uint16_t accent = rgb(230, 230, 230);
+        const int c = size / 2;
+        for (int yy = 0; yy < size; ++yy) {
+            for (int xx = 0; xx < size; ++xx) {
+                const int dx = xx - c;
+                const int dy = yy - c;
+                const int d2 = dx * dx + dy * dy;
+                const int r2 = c * c;
+                uint16_t col = 0;
+                if (d2 < r2 * 9 / 16) {
+                    col = ((xx + yy + (int)seed) % 7 < 3) ? accent : main;
+                } else if (d2 < r2) {
+                    col = main;
+                } else if (d2 < r2 + size) {
+                    col = rgb(0, (uint8_t)(16 + (xx * 7 + yy * 3) % 32), 80);
+                }
+                if (col) fillRect(f, x + xx, y + yy, 1, 1, col);
+            }
+        }
+    }
+
+    void scoreboardFrame(Frame f, uint32_t ms) {
+        memset(f, 0, sizeof(Frame));
+        drawLogo(f, 0, 2, 20, 3);
+        drawLogo(f, 44, 2, 20, 11);
+        const uint16_t white = rgb(255, 255, 255);
+        drawNumber(f, 25, 6, 2, 1, white);
+        fillRect(f, 30, 8, 3, 1, white);
+        drawNumber(f, 35, 6, 3, 1, white);
+        // Clock counting down from 12:34, redrawn every second
+        const int left = 12 * 60 + 34 - (int)(ms / 1000);
+        drawNumber(f, 22, 24, left / 60, 2, rgb(255, 200, 0));
+        fillRect(f, 30, 25, 1, 1, rgb(255, 200, 0));
+        fillRect(f, 30, 27, 1, 1, rgb(255, 200, 0));
+        drawNumber(f, 32, 24, left % 60, 2, rgb(255, 200, 0));
+        drawNumber(f, 30, 16, 2, 1, rgb(120, 120, 120));
+    }
+
+    void drawSiren(Frame f, int x, int y, uint32_t t) {
+        fillRect(f, x, y + 9, 9, 2, rgb(140, 140, 140));
+        fillRect(f, x, y, 9, 9, ((t / 120) % 2) == 0 ? rgb(255, 0, 0) : rgb(140, 0, 0));
+        if ((t / 80) % 2 == 0) {
+            const int stripe = x + 4 + (((t / 160) % 2) == 0 ? -1 : 1);
+            fillRect(f, stripe, y, 1, 9, rgb(255, 80, 80));
+        }
+    }
+
+    void goalFrame(Frame f, uint32_t t) {
+        memset(f, 0, sizeof(Frame));
+        if (t < 5000) {
+            // GOAL, letter by letter with a bounce, pulsing after the reveal
+            const uint16_t text = t >= 1600 && ((t / 300) % 2) ? rgb(120, 120, 120) : rgb(255, 255, 255);
+            for (int i = 0; i < 4; ++i) {
+                const uint32_t start = (uint32_t)i * 400;
+                if (t < start) continue;
+                const uint32_t lt = t - start;
+                const int bounce = lt < 100 ? -4 + (int)(lt * 4 / 100) : lt < 200 ? (int)((lt - 100) * 2 / 100) : 0;
+                fillRect(f, 20 + i * 6, 12 + bounce, 5, 7, text);
+                fillRect(f, 21 + i * 6, 14 + bounce, 3, 3, 0);
+            }
+            drawSiren(f, 4, 10, t);
+            drawSiren(f, 51, 10, t);
+            return;
+        }
+        if (t < 5900) {
+            // Logo flashing between corners
+            if (((t / 220) % 2) == 0) drawLogo(f, 44, 0, 20, 11);
+            else drawLogo(f, 0, 12, 20, 11);
+            return;
+        }
+        if (t < 7800) {
+            // Zoom from 4 to 20 px, hold, then the abbreviation
+            int size = 4 + (int)(16 * (t - 5900) / 600);
+            if (size > 20) size = 20;
+            drawLogo(f, (W - size) / 2, (H - size) / 2, size, 11);
+            if (t >= 6800) {
+                const int shown = (int)((t - 6800) / 200) + 1;
+                for (int i = 0; i < shown && i < 3; ++i) drawGlyph(f, 26 + i * 4, 27, DIGITS[8], rgb(255, 255, 255));
+            }
+            return;
+        }
+        // Name card: bands rising and falling every 140 ms, confetti
+        drawLogo(f, 2, 6, 20, 11);
+        for (int i = 0; i < 9; ++i) {
+            const int x = 1 + i * 7;
+            if (x < 22) continue;
+            const int phase = (int)(((t / 140) * (3 + i % 5) + i * 5) % 20);
+            const int h = 1 + (phase <= 10 ? phase : 20 - phase);
+            fillRect(f, x, 31 - h, 5, h, i % 2 ? rgb(0, 64, 160) : rgb(230, 230, 230));
+        }
+        for (int i = 0; i < 3; ++i) drawGlyph(f, 26 + i * 4, 4, DIGITS[1 + i], rgb(255, 255, 255));
+        uint32_t rng = 0xDEADBEEFu;
+        for (int i = 0; i < 18; ++i) {
+            rng = rng * 1664525u + 1013904223u + (uint32_t)(i * 73);
+            const int baseX = (int)(rng % W);
+            rng = rng * 1664525u + 1013904223u;
+            const int speed = 8 + (int)(rng % 15);
+            const int y = (int)((t * speed / 1000) % (H + 12)) - 2;
+            if (y < 0 || y >= H) continue;
+            const int x = (baseX + (int)((t / 200 + i * 37) % 5) - 2 + W) % W;
+            fillRect(f, x, y, i % 3 == 0 ? 2 : 1, 1, i % 2 ? rgb(0, 64, 160) : rgb(230, 230, 230));
+        }
+    }
+
+    // The browser's decoder: applies a message to the frame it holds
+    bool decode(const uint8_t* msg, size_t len, Frame f) {
+        if (len < 4 || msg[1] != W || msg[2] != H) return false;
+        if (msg[0] == 1) memset(f, 0, sizeof(Frame));
+        size_t n = 4;
+        for (uint8_t r = 0; r < msg[3]; ++r) {
+            if (n >= len) return false;
+            const int y = msg[n++];
+            if (y >= H) return false;
+            int x = 0;
+            while (x < W) {
+                if (n + 3 > len) return false;
+                const int run = msg[n];
+                const uint16_t color = (uint16_t)(msg[n + 1] | (msg[n + 2] << 8));
+                n += 3;
+                if (run == 0 || x + run > W) return false;
+                for (int i = 0; i < run; ++i) f[y * W + x + i] = color;
+                x += run;
+            }
+        }
+        return n == len;
+    }
+
+    struct Rate {
+        uint32_t bytes;
+        uint32_t frames;     // messages sent (unchanged frames are not)
+        uint32_t keyBytes;
+        uint32_t maxDelta;
+    };
+
+    // Samples the scene at the mirror rate from t0 for durationMs, sends
+    // what panel_mirror would and checks the browser ends up in sync
+    Rate mirror(void (*scene)(Frame, uint32_t), uint32_t t0, uint32_t durationMs) {
+        static Frame prev, cur, shown;
+        static uint8_t msg[MAX_MESSAGE];
+        Rate r = {};
+        const uint32_t step = 1000 / MIRROR_FPS;
+        scene(prev, t0);
+        r.keyBytes = (uint32_t)panelMirrorEncode(nullptr, prev, W, H, msg, sizeof(msg));
+        TEST_ASSERT_TRUE(decode(msg, r.keyBytes, shown));
+        TEST_ASSERT_EQUAL_MEMORY(prev, shown, sizeof(Frame));
+        for (uint32_t t = t0 + step; t < t0 + durationMs; t += step) {
+            scene(cur, t);
+            const size_t len = panelMirrorEncode(prev, cur, W, H, msg, sizeof(msg));
+            TEST_ASSERT_TRUE(len >= 4);
+            if (len > 4) {
+                TEST_ASSERT_TRUE(decode(msg, len, shown));
+                r.bytes += (uint32_t)len;
+                r.frames++;
+                if (len > r.maxDelta) r.maxDelta = (uint32_t)len;
+            }
+            TEST_ASSERT_EQUAL_MEMORY(cur, shown, sizeof(Frame));
+            memcpy(prev, cur, sizeof(Frame));
+        }
+        return r;
+    }
+
+    uint32_t perSecond(const Rate& r, uint32_t durationMs) {
+        return (uint32_t)((uint64_t)r.bytes * 1000 / durationMs);
+    }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// ============================================================================
+// FORMAT
+// ============================================================================
+
+void test_header_and_runs() {
+    static Frame f;
+    memset(f, 0, sizeof(f));
+    fillRect(f, 10, 3, 5, 1, 0xF800);
+    static uint8_t msg[MAX_MESSAGE];
+    const size_t key = panelMirrorEncode(nullptr, f, W, H, msg, sizeof(msg));
+    // Header, then 32 rows: 31 of one run, row 3 of three runs
+    TEST_ASSERT_EQUAL_UINT32(4 + 32 * 4 + 6, key);
+    TEST_ASSERT_EQUAL_UINT8(1, msg[0]);
+    TEST_ASSERT_EQUAL_UINT8(W, msg[1]);
+    TEST_ASSERT_EQUAL_UINT8(H, msg[2]);
+    TEST_ASSERT_EQUAL_UINT8(H, msg[3]);
+
+    static Frame g;
+    memcpy(g, f, sizeof(g));
+    fillRect(g, 0, 20, 64, 1, 0x07E0);
+    const size_t delta = panelMirrorEncode(f, g, W, H, msg, sizeof(msg));
+    TEST_ASSERT_EQUAL_UINT32(4 + 1 + 3, delta);
+    const uint8_t expected[8] = {0, W, H, 1, 20, 64, 0xE0, 0x07};
+    TEST_ASSERT_EQUAL_MEMORY(expected, msg, 8);
+
+    // Nothing changed: header only
+    TEST_ASSERT_EQUAL_UINT32(4, panelMirrorEncode(g, g, W, H, msg, sizeof(msg)));
+}
+
+void test_worst_case_fits_and_short_buffers_fail() {
+    static Frame noise;
+    for (int i = 0; i < W * H; ++i) noise[i] = (uint16_t)(i & 1 ? 0xFFFF : i);
+    static uint8_t msg[MAX_MESSAGE];
+    TEST_ASSERT_EQUAL_UINT32(MAX_MESSAGE, panelMirrorEncode(nullptr, noise, W, H, msg, sizeof(msg)));
+    TEST_ASSERT_EQUAL_UINT32(0, panelMirrorEncode(nullptr, noise, W, H, msg, sizeof(msg) - 1));
+    TEST_ASSERT_EQUAL_UINT32(0, panelMirrorEncode(nullptr, noise, W, H, msg, 3));
+    TEST_ASSERT_EQUAL_UINT32(0, panelMirrorEncode(nullptr, noise, 256, 1, msg, sizeof(msg)));
+}
+
+// ============================================================================
+// BYTES PER SECOND
+// ============================================================================
+
+void test_static_scoreboard_rate() {
+    const uint32_t duration = 60000;
+    const Rate r = mirror(scoreboardFrame, 0, duration);
+    char msg[140];
+    snprintf(msg, sizeof(msg), "scoreboard: keyframe %u B, %u deltas/min, %u B/s (raw %u B/s)",
+        (unsigned)r.keyBytes, (unsigned)r.frames, (unsigned)perSecond(r, duration),
+        (unsigned)(W * H * 2 * MIRROR_FPS));
+    TEST_MESSAGE(msg);
+    // Only the clock ticks: one small delta a second
+    TEST_ASSERT_TRUE(r.frames <= 60);
+    TEST_ASSERT_TRUE(r.maxDelta < 200);
+    TEST_ASSERT_TRUE(perSecond(r, duration) < 200);
+}
+
+void test_goal_animation_rate() {
+    const Rate r = mirror(goalFrame, 0, GOAL_MS);
+    char msg[140];
+    snprintf(msg, sizeof(msg), "goal: keyframe %u B, %u deltas, largest %u B, %u B/s (raw %u B/s)",
+        (unsigned)r.keyBytes, (unsigned)r.frames, (unsigned)r.maxDelta, (unsigned)perSecond(r, GOAL_MS),
+        (unsigned)(W * H * 2 * MIRROR_FPS));
+    TEST_MESSAGE(msg);
+    // Nearly every frame changes, yet RLE keeps it well under raw pixels
+    TEST_ASSERT_TRUE(r.frames >= GOAL_MS / 1000 * MIRROR_FPS * 9 / 10);
+    TEST_ASSERT_TRUE(r.maxDelta < MAX_MESSAGE / 2);
+    TEST_ASSERT_TRUE(perSecond(r, GOAL_MS) < W * H * 2 * MIRROR_FPS / 4);
+}
+
+void test_goal_costs_more_than_scoreboard() {
+    const Rate board = mirror(scoreboardFrame, 0, GOAL_MS);
+    const Rate goal = mirror(goalFrame, 0, GOAL_MS);
+    TEST_ASSERT_TRUE(perSecond(goal, GOAL_MS) > 10 * perSecond(board, GOAL_MS));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_header_and_runs);
+    RUN_TEST(test_worst_case_fits_and_short_buffers_fail);
+    RUN_TEST(test_static_scoreboard_rate);
+    RUN_TEST(test_goal_animation_rate);
+    RUN_TEST(test_goal_costs_more_than_scoreboard);
+    return UNITY_END();
+}
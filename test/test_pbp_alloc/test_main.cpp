@@ -0,0 +1,367 @@
+#include <unity.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <ArduinoJson.h>
+
+#include "arena_allocator.h"
+#include "pbp_reducer.h"
+
+// Runs the poll hot path (filtered parse into the arena, then the reducer)
+// over feed-shaped payloads and counts heap calls while it does. After the
+// first poll has sized everything, a poll must not touch the heap.
+
+// ============================================================================
+// HEAP COUNTING
+// ============================================================================
+// glibc lets a program replace malloc and friends and still reach the real
+// ones through __libc_*. operator new goes through malloc, so C++
+// allocations are counted too.
+
+#if defined(__GLIBC__)
+#define PBP_ALLOC_HOOK 1
+
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+    void __libc_free(void* ptr);
+}
+
+static volatile bool countingHeap = false;
+static volatile uint32_t heapCalls = 0;
+
+extern "C" void* malloc(size_t size) {
+    if (countingHeap) heapCalls++;
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    if (countingHeap) heapCalls++;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    if (countingHeap) heapCalls++;
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void* ptr) {
+    if (countingHeap && ptr) heapCalls++;
+    __libc_free(ptr);
+}
+#else
+#define PBP_ALLOC_HOOK 0
+#endif
+
+// ============================================================================
+// FEED
+// ============================================================================
+
+namespace {
+    constexpr uint32_t GAME_ID = 2024020345;
+    constexpr uint32_t AWAY_ID = 10;
+    constexpr uint32_t HOME_ID = 8;
+    constexpr int PLAYERS_PER_TEAM = 20;
+    constexpr size_t ARENA_SIZE = 192 * 1024;  // PBP_ARENA_SIZE
+
+    uint32_t rngState = 1;
+    uint32_t nextRand(uint32_t range) {
+        rngState = rngState * 1664525u + 1013904223u;
+        return (rngState >> 8) % range;
+    }
+
+    uint32_t playerId(uint32_t teamId, int slot) {
+        return 8470000 + teamId * 100 + (uint32_t)slot;
+    }
+
+    void addTeam(JsonObject t, uint32_t id, const char* abbrev, const char* name, const char* place) {
+        t["id"] = id;
+        t["commonName"]["default"] = name;
+        t["commonName"]["fr"] = name;
+        t["abbrev"] = abbrev;
+        t["score"] = 2;
+        t["sog"] = 27;
+        t["logo"] = "https://assets.nhle.com/logos/nhl/svg/TEAM_light.svg";
+        t["darkLogo"] = "https://assets.nhle.com/logos/nhl/svg/TEAM_dark.svg";
+        t["placeName"]["default"] = place;
+        t["placeNameWithPreposition"]["default"] = place;
+    }
+
+    // A late-game play-by-play response in the feed's shape, including the
+    // fields the filter drops, with the first playCount plays.
+    std::string buildFeed(size_t playCount) {
+        JsonDocument doc;
+        doc["id"] = GAME_ID;
+        doc["season"] = 20242025;
+        doc["gameType"] = 2;
+        doc["limitedScoring"] = false;
+        doc["gameDate"] = "2025-01-18";
+        doc["venue"]["default"] = "Bell Centre";
+        doc["venueLocation"]["default"] = "Montreal";
+        doc["startTimeUTC"] = "2025-01-19T00:00:00Z";
+        doc["easternUTCOffset"] = "-05:00";
+        doc["venueUTCOffset"] = "-05:00";
+        JsonArray tv = doc["tvBroadcasts"].to<JsonArray>();
+        for (int i = 0; i < 4; ++i) {
+            JsonObject b = tv.add<JsonObject>();
+            b["id"] = 280 + i;
+            b["market"] = i ? "A" : "H";
+            b["countryCode"] = "CA";
+            b["network"] = "SN";
+            b["sequenceNumber"] = 40 + i;
+        }
+        doc["gameState"] = "LIVE";
+        doc["gameScheduleState"] = "OK";
+        doc["periodDescriptor"]["number"] = 3;
+        doc["periodDescriptor"]["periodType"] = "REG";
+        doc["periodDescriptor"]["maxRegulationPeriods"] = 3;
+        addTeam(doc["awayTeam"].to<JsonObject>(), AWAY_ID, "TOR", "Maple Leafs", "Toronto");
+        addTeam(doc["homeTeam"].to<JsonObject>(), HOME_ID, "MTL", "Canadiens", "Montreal");
+        doc["shootoutInUse"] = true;
+        doc["otInUse"] = true;
+        doc["clock"]["timeRemaining"] = "04:12";
+        doc["clock"]["secondsRemaining"] = 252;
+        doc["clock"]["running"] = true;
+        doc["clock"]["inIntermission"] = false;
+        doc["displayPeriod"] = 3;
+        doc["maxPeriods"] = 5;
+        doc["situation"]["homeTeam"]["abbrev"] = "MTL";
+        doc["situation"]["homeTeam"]["situationDescriptions"][0] = "PP";
+        doc["situation"]["homeTeam"]["strength"] = 5;
+        doc["situation"]["awayTeam"]["abbrev"] = "TOR";
+        doc["situation"]["awayTeam"]["strength"] = 4;
+        doc["situation"]["situationCode"] = "1451";
+        doc["situation"]["timeRemaining"] = "01:34";
+        doc["situation"]["secondsRemaining"] = 94;
+
+        rngState = 7;
+        JsonArray plays = doc["plays"].to<JsonArray>();
+        int sortOrder = 8;
+        for (size_t i = 0; i < playCount; ++i) {
+            const int period = 1 + (int)(i * 3 / (playCount ? playCount : 1));
+            const unsigned remaining = 1199 - (unsigned)nextRand(1190);
+            char clock[8];
+            char elapsed[8];
+            snprintf(clock, sizeof(clock), "%02u:%02u", remaining / 60, remaining % 60);
+            snprintf(elapsed, sizeof(elapsed), "%02u:%02u", (1200 - remaining) / 60, (1200 - remaining) % 60);
+
+            JsonObject p = plays.add<JsonObject>();
+            p["eventId"] = 100 + (int)i;
+            p["periodDescriptor"]["number"] = period;
+            p["periodDescriptor"]["periodType"] = "REG";
+            p["periodDescriptor"]["maxRegulationPeriods"] = 3;
+            p["timeInPeriod"] = elapsed;
+            p["timeRemaining"] = clock;
+            p["situationCode"] = "1551";
+            p["homeTeamDefendingSide"] = period == 2 ? "right" : "left";
+            p["sortOrder"] = sortOrder;
+            sortOrder += 1 + (int)nextRand(4);
+            const uint32_t team = nextRand(2) ? HOME_ID : AWAY_ID;
+            JsonObject d = p["details"].to<JsonObject>();
+            d["eventOwnerTeamId"] = team;
+            d["xCoord"] = (int)nextRand(180) - 90;
+            d["yCoord"] = (int)nextRand(80) - 40;
+            d["zoneCode"] = nextRand(2) ? "O" : "D";
+
+            const uint32_t kind = nextRand(100);
+            if (kind < 4) {
+                p["typeCode"] = 505;
+                p["typeDescKey"] = "goal";
+                d["shotType"] = "wrist";
+                d["scoringPlayerId"] = playerId(team, (int)nextRand(PLAYERS_PER_TEAM));
+                d["scoringPlayerTotal"] = 1 + (int)nextRand(30);
+                d["assist1PlayerId"] = playerId(team, (int)nextRand(PLAYERS_PER_TEAM));
+                d["assist1PlayerTotal"] = 1 + (int)nextRand(30);
+                d["goalieInNetId"] = playerId(team == HOME_ID ? AWAY_ID : HOME_ID, 0);
+                d["awayScore"] = 1;
+                d["homeScore"] = 1;
+                d["highlightClipSharingUrl"] = "https://nhl.com/video/clip-6367466339112";
+                d["highlightClip"] = 6367466339112ULL;
+            } else if (kind < 9) {
+                p["typeCode"] = 509;
+                p["typeDescKey"] = "penalty";
+                d["typeCode"] = "MIN";
+                d["descKey"] = "hooking";
+                d["duration"] = 2;
+                d["committedByPlayerId"] = playerId(team, (int)nextRand(PLAYERS_PER_TEAM));
+                d["drawnByPlayerId"] = playerId(team == HOME_ID ? AWAY_ID : HOME_ID, 3);
+            } else if (kind < 40) {
+                p["typeCode"] = 506;
+                p["typeDescKey"] = "shot-on-goal";
+                d["shotType"] = "snap";
+                d["shootingPlayerId"] = playerId(team, (int)nextRand(PLAYERS_PER_TEAM));
+                d["goalieInNetId"] = playerId(team == HOME_ID ? AWAY_ID : HOME_ID, 0);
+                d["awaySOG"] = 12;
+                d["homeSOG"] = 15;
+            } else if (kind < 60) {
+                p["typeCode"] = 503;
+                p["typeDescKey"] = "hit";
+                d["hittingPlayerId"] = playerId(team, (int)nextRand(PLAYERS_PER_TEAM));
+                d["hitteePlayerId"] = playerId(team == HOME_ID ? AWAY_ID : HOME_ID, 5);
+            } else {
+                p["typeCode"] = 502;
+                p["typeDescKey"] = "faceoff";
+                d["losingPlayerId"] = playerId(team, 1);
+                d["winningPlayerId"] = playerId(team == HOME_ID ? AWAY_ID : HOME_ID, 1);
+            }
+        }
+
+        JsonArray spots = doc["rosterSpots"].to<JsonArray>();
+        const uint32_t teams[2] = {AWAY_ID, HOME_ID};
+        char last[16];
+        for (uint32_t team : teams) {
+            for (int i = 0; i < PLAYERS_PER_TEAM; ++i) {
+                JsonObject s = spots.add<JsonObject>();
+                s["teamId"] = team;
+                s["playerId"] = playerId(team, i);
+                s["firstName"]["default"] = "Player";
+                snprintf(last, sizeof(last), "T%uN%d", (unsigned)team, i);
+                s["lastName"]["default"] = last;
+                s["sweaterNumber"] = i + 2;
+                s["positionCode"] = i ? "C" : "G";
+                s["headshot"] = "https://assets.nhle.com/mugs/nhl/20242025/TEAM/PLAYER.png";
+            }
+        }
+
+        std::string out;
+        serializeJson(doc, out);
+        return out;
+    }
+
+    void noShot(bool, int, int, bool, bool) {}
+    void noReset() {}
+
+    uint8_t* arenaBlock = nullptr;
+    ArenaAllocator arena;
+    JsonDocument filterDoc;
+    JsonDocument filterNoRosterDoc;
+    RosterCache roster;
+    GameReducer reducer;
+
+    // One poll the way pollPlayByPlay runs it, minus the network
+    bool poll(JsonDocument& doc, const std::string& feed, bool needRoster) {
+        doc.clear();
+        arena.reset();
+        DeserializationError err = deserializeJson(doc, feed.data(), feed.size(),
+            DeserializationOption::Filter(needRoster ? filterDoc : filterNoRosterDoc),
+            DeserializationOption::NestingLimit(16));
+        if (err) return false;
+        if (needRoster) buildRosterCache(roster, doc["rosterSpots"].as<JsonArray>(), GAME_ID);
+        TeamContext ctx = {GAME_ID, AWAY_ID, HOME_ID,
+            doc["awayTeam"]["abbrev"] | "", doc["homeTeam"]["abbrev"] | "",
+            &roster, {noShot, noReset}};
+        reducerConsume(reducer, doc["plays"].as<JsonArray>(), ctx);
+
+        StatLeader leaders[kMaxLeaders];
+        PenaltyEntry active[kMaxPenalties];
+        reducerLeaders(reducer, leaders, kMaxLeaders);
+        reducerActivePenalties(reducer, 3, 2520, active, kMaxPenalties);
+        return true;
+    }
+}
+
+void setUp() {
+    arenaBlock = (uint8_t*)malloc(ARENA_SIZE);
+    arena.attach(arenaBlock, ARENA_SIZE);
+    filterDoc.clear();
+    filterNoRosterDoc.clear();
+    buildPlayByPlayFilter(filterDoc, true);
+    buildPlayByPlayFilter(filterNoRosterDoc, false);
+    roster.clear();
+    reducerReset(reducer, GAME_ID);
+}
+
+void tearDown() {
+    arena.attach(nullptr, 0);
+    free(arenaBlock);
+    arenaBlock = nullptr;
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+void test_steady_state_poll_does_not_touch_the_heap() {
+#if PBP_ALLOC_HOOK
+    // Built up front: the feed strings are the network's job, not the poll's
+    std::vector<std::string> feeds;
+    for (size_t plays = 300; plays <= 330; plays += 3) feeds.push_back(buildFeed(plays));
+
+    JsonDocument doc(&arena);
+    heapCalls = 0;
+    countingHeap = true;
+    const bool first = poll(doc, feeds[0], true);
+    countingHeap = false;
+    const uint32_t firstCalls = heapCalls;
+    TEST_ASSERT_TRUE(first);
+    TEST_ASSERT_GREATER_THAN(0, (int)roster.count);
+
+    for (size_t i = 1; i < feeds.size(); ++i) {
+        heapCalls = 0;
+        countingHeap = true;
+        const bool ok = poll(doc, feeds[i], false);
+        countingHeap = false;
+        TEST_ASSERT_TRUE(ok);
+        TEST_ASSERT_EQUAL_UINT32(0, heapCalls);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, arena.fallbacks());
+    TEST_ASSERT_EQUAL_UINT32(330, reducer.playsReduced);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "feed %u bytes: first poll %u heap calls, then 0; arena peak %u of %u",
+        (unsigned)feeds.back().size(), (unsigned)firstCalls, (unsigned)arena.peak(), (unsigned)arena.capacity());
+    TEST_MESSAGE(msg);
+    doc.clear();
+#else
+    TEST_IGNORE_MESSAGE("heap counting needs glibc");
+#endif
+}
+
+void test_roster_poll_stays_in_the_arena() {
+#if PBP_ALLOC_HOOK
+    const std::string feed = buildFeed(320);
+    JsonDocument doc(&arena);
+    TEST_ASSERT_TRUE(poll(doc, feed, true));
+
+    heapCalls = 0;
+    countingHeap = true;
+    const bool ok = poll(doc, feed, true);
+    countingHeap = false;
+    TEST_ASSERT_TRUE(ok);
+    TEST_ASSERT_EQUAL_UINT32(0, heapCalls);
+    TEST_ASSERT_EQUAL_UINT32(0, arena.fallbacks());
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "roster poll: feed %u bytes, arena peak %u of %u",
+        (unsigned)feed.size(), (unsigned)arena.peak(), (unsigned)arena.capacity());
+    TEST_MESSAGE(msg);
+    doc.clear();
+#else
+    TEST_IGNORE_MESSAGE("heap counting needs glibc");
+#endif
+}
+
+void test_undersized_arena_is_counted() {
+    // A tiny arena forces the fallback path; the poll still works and the
+    // overflow shows up in fallbacks() rather than failing silently.
+    static uint8_t small[2048];
+    arena.attach(small, sizeof(small));
+    const std::string feed = buildFeed(60);
+    JsonDocument doc(&arena);
+    TEST_ASSERT_TRUE(poll(doc, feed, true));
+    TEST_ASSERT_GREATER_THAN(0, (int)arena.fallbacks());
+    TEST_ASSERT_EQUAL_UINT32(60, reducer.playsReduced);
+    doc.clear();
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_steady_state_poll_does_not_touch_the_heap);
+    RUN_TEST(test_roster_poll_stays_in_the_arena);
+    RUN_TEST(test_undersized_arena_is_counted);
+    return UNITY_END();
+}
@@ -0,0 +1,382 @@
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <ArduinoJson.h>
+
+#include "pbp_reducer.h"
+
+// Replays a generated game through the reducer a few plays at a time, the
+// way polls see it, and checks the aggregates against a full rescan of
+// the same prefix after every poll.
+
+namespace {
+    constexpr uint32_t GAME_ID = 2024020345;  // regular season
+    constexpr uint32_t AWAY_ID = 10;
+    constexpr uint32_t HOME_ID = 8;
+    constexpr int PLAYERS_PER_TEAM = 12;
+
+    uint32_t rngState = 1;
+    uint32_t nextRand(uint32_t range) {
+        rngState = rngState * 1664525u + 1013904223u;
+        return (rngState >> 8) % range;
+    }
+
+    uint32_t playerId(uint32_t teamId, int slot) {
+        return 8470000 + teamId * 100 + (uint32_t)slot;
+    }
+
+    uint32_t shotsAdded = 0;
+    uint32_t shotResets = 0;
+    void countShot(bool, int, int, bool, bool) { shotsAdded++; }
+    void countReset() { shotResets++; }
+
+    RosterCache roster;
+
+    TeamContext context() {
+        return {GAME_ID, AWAY_ID, HOME_ID, "TOR", "MTL", &roster, {countShot, countReset}};
+    }
+
+    void buildRoster(JsonDocument& doc) {
+        JsonArray spots = doc["rosterSpots"].to<JsonArray>();
+        const uint32_t teams[2] = {AWAY_ID, HOME_ID};
+        char last[16];
+        for (uint32_t team : teams) {
+            for (int i = 0; i < PLAYERS_PER_TEAM; ++i) {
+                JsonObject p = spots.add<JsonObject>();
+                p["playerId"] = playerId(team, i);
+                p["firstName"]["default"] = "Player";
+                snprintf(last, sizeof(last), "T%uN%d", (unsigned)team, i);
+                p["lastName"]["default"] = last;
+            }
+        }
+    }
+
+    // Roughly the mix of a real feed: mostly faceoffs, shots and hits, a
+    // goal or penalty every few dozen plays, some with API names and some
+    // that have to come from the roster.
+    void buildGame(JsonDocument& doc, size_t playCount, uint32_t seed) {
+        rngState = seed;
+        buildRoster(doc);
+        JsonArray plays = doc["plays"].to<JsonArray>();
+        int sortOrder = 8;
+        for (size_t i = 0; i < playCount; ++i) {
+            const int period = 1 + (int)(i * 3 / playCount);
+            const size_t perPeriod = playCount / 3;
+            const size_t inPeriod = i % (perPeriod ? perPeriod : 1);
+            const unsigned remaining = 1199 - (unsigned)(inPeriod * 1190 / (perPeriod ? perPeriod : 1));
+            char clock[8];
+            snprintf(clock, sizeof(clock), "%02u:%02u", remaining / 60, remaining % 60);
+
+            JsonObject p = plays.add<JsonObject>();
+            p["eventId"] = 100 + (int)i;
+            p["sortOrder"] = sortOrder;
+            sortOrder += 1 + (int)nextRand(4);
+            p["periodDescriptor"]["number"] = period;
+            p["timeRemaining"] = clock;
+            p["homeTeamDefendingSide"] = period == 2 ? "right" : "left";
+            const uint32_t team = nextRand(2) ? HOME_ID : AWAY_ID;
+            JsonObject d = p["details"].to<JsonObject>();
+            d["eventOwnerTeamId"] = team;
+
+            const uint32_t kind = nextRand(100);
+            if (kind < 4) {
+                p["typeDescKey"] = "goal";
+                d["xCoord"] = (int)nextRand(180) - 90;
+                d["yCoord"] = (int)nextRand(80) - 40;
+                d["scoringPlayerId"] = playerId(team, (int)nextRand(PLAYERS_PER_TEAM));
+                if (nextRand(2)) d["scoringPlayerName"]["default"] = "A. Sniper";
+                if (nextRand(4)) d["assist1PlayerId"] = playerId(team, (int)nextRand(PLAYERS_PER_TEAM));
+                if (nextRand(2)) d["assist2PlayerId"] = playerId(team, (int)nextRand(PLAYERS_PER_TEAM));
+            } else if (kind < 9) {
+                p["typeDescKey"] = "penalty";
+                const uint32_t type = nextRand(10);
+                d["typeCode"] = type < 7 ? "MIN" : (type < 8 ? "MAJ" : (type < 9 ? "BEN" : "MIS"));
+                d["duration"] = type < 7 ? (nextRand(5) ? 2 : 4) : (type < 8 ? 5 : (type < 9 ? 2 : 10));
+                d["descKey"] = "hooking";
+                d["committedByPlayerId"] = playerId(team, (int)nextRand(PLAYERS_PER_TEAM));
+            } else if (kind < 40) {
+                p["typeDescKey"] = "shot-on-goal";
+                if (nextRand(8)) {
+                    d["xCoord"] = (int)nextRand(180) - 90;
+                    d["yCoord"] = (int)nextRand(80) - 40;
+                }
+            } else if (kind < 60) {
+                p["typeDescKey"] = "hit";
+            } else if (kind < 85) {
+                p["typeDescKey"] = "faceoff";
+            } else {
+                p["typeDescKey"] = "blocked-shot";
+            }
+        }
+    }
+
+    // The first n plays, as a poll taken at that point would return them
+    void copyPrefix(JsonArray all, size_t n, JsonDocument& out) {
+        out.clear();
+        JsonArray plays = out["plays"].to<JsonArray>();
+        for (size_t i = 0; i < n && i < all.size(); ++i) {
+            plays.add(all[i]);
+        }
+    }
+
+    // Unity rejects zero-length memory compares
+    void assertSameBytes(const void* expected, const void* actual, size_t len) {
+        if (len > 0) TEST_ASSERT_EQUAL_MEMORY(expected, actual, len);
+    }
+
+    void assertSameAggregates(const GameReducer& expected, const GameReducer& actual) {
+        TEST_ASSERT_EQUAL(expected.watermark, actual.watermark);
+        TEST_ASSERT_EQUAL_MEMORY(&expected.stats.away, &actual.stats.away, sizeof(TeamGameStats));
+        TEST_ASSERT_EQUAL_MEMORY(&expected.stats.home, &actual.stats.home, sizeof(TeamGameStats));
+        TEST_ASSERT_EQUAL(expected.goalCount, actual.goalCount);
+        assertSameBytes(expected.goals, actual.goals, sizeof(RecapGoal) * expected.goalCount);
+        TEST_ASSERT_EQUAL(expected.scorerCount, actual.scorerCount);
+        assertSameBytes(expected.scorers, actual.scorers, sizeof(ScorerTally) * expected.scorerCount);
+        TEST_ASSERT_EQUAL(expected.penaltyCount, actual.penaltyCount);
+        assertSameBytes(expected.penalties, actual.penalties, sizeof(PenaltyWork) * expected.penaltyCount);
+
+        StatLeader a[kMaxLeaders] = {};
+        StatLeader b[kMaxLeaders] = {};
+        const uint8_t na = reducerLeaders(expected, a, kMaxLeaders);
+        const uint8_t nb = reducerLeaders(actual, b, kMaxLeaders);
+        TEST_ASSERT_EQUAL(na, nb);
+        TEST_ASSERT_EQUAL_MEMORY(a, b, sizeof(a));
+    }
+
+    // Large; kept off the stack
+    GameReducer incremental;
+    GameReducer rescan;
+    GameReducer saved;
+}
+
+void setUp() {
+    memset(&roster, 0, sizeof(roster));
+    shotsAdded = 0;
+    shotResets = 0;
+}
+
+void tearDown() {}
+
+void test_incremental_matches_rescan_after_every_poll() {
+    JsonDocument game;
+    buildGame(game, 330, 42);
+    buildRosterCache(roster, game["rosterSpots"], GAME_ID);
+    JsonArray all = game["plays"];
+    const TeamContext ctx = context();
+
+    reducerReset(incremental, GAME_ID);
+    JsonDocument poll;
+    size_t seen = 0;
+    uint32_t polls = 0;
+    rngState = 7;
+    while (seen < all.size()) {
+        seen += 1 + nextRand(8);
+        if (seen > all.size()) seen = all.size();
+        copyPrefix(all, seen, poll);
+        reducerConsume(incremental, poll["plays"], ctx);
+
+        reducerReset(rescan, GAME_ID);
+        reducerConsume(rescan, poll["plays"], ctx);
+        assertSameAggregates(rescan, incremental);
+        polls++;
+    }
+    TEST_ASSERT_EQUAL(all.size(), incremental.playsReduced);
+    TEST_ASSERT_GREATER_THAN(40, polls);
+    TEST_ASSERT_GREATER_THAN(0, incremental.goalCount);
+    TEST_ASSERT_GREATER_THAN(0, incremental.penaltyCount);
+}
+
+void test_repeated_poll_applies_nothing() {
+    JsonDocument game;
+    buildGame(game, 60, 3);
+    const TeamContext ctx = context();
+    reducerReset(incremental, GAME_ID);
+    TEST_ASSERT_EQUAL(60, reducerConsume(incremental, game["plays"], ctx));
+    const uint32_t shots = shotsAdded;
+    TEST_ASSERT_EQUAL(0, reducerConsume(incremental, game["plays"], ctx));
+    TEST_ASSERT_EQUAL(shots, shotsAdded);
+}
+
+void test_rewound_feed_rebuilds_from_scratch() {
+    JsonDocument game;
+    buildGame(game, 200, 11);
+    JsonArray all = game["plays"];
+    const TeamContext ctx = context();
+
+    reducerReset(incremental, GAME_ID);
+    reducerConsume(incremental, all, ctx);
+    const uint32_t resetsBefore = shotResets;
+
+    // A later poll returns fewer plays (an event was withdrawn)
+    JsonDocument shorter;
+    copyPrefix(all, 150, shorter);
+    reducerConsume(incremental, shorter["plays"], ctx);
+    TEST_ASSERT_EQUAL(1, incremental.rebuilds);
+    TEST_ASSERT_EQUAL(resetsBefore + 1, shotResets);
+
+    reducerReset(rescan, GAME_ID);
+    reducerConsume(rescan, shorter["plays"], ctx);
+    assertSameAggregates(rescan, incremental);
+}
+
+void test_reconcile_picks_up_amended_assists() {
+    JsonDocument game;
+    buildGame(game, 240, 5);
+    buildRosterCache(roster, game["rosterSpots"], GAME_ID);
+    JsonArray all = game["plays"];
+    const TeamContext ctx = context();
+
+    reducerReset(incremental, GAME_ID);
+    reducerConsume(incremental, all, ctx);
+
+    // Credit a different first assist on the first goal after the fact
+    JsonObject amended;
+    for (JsonObject p : all) {
+        if (strcmp(p["typeDescKey"] | "", "goal") == 0) {
+            amended = p;
+            break;
+        }
+    }
+    TEST_ASSERT_FALSE(amended.isNull());
+    amended["details"]["assist1PlayerId"] = playerId(amended["details"]["eventOwnerTeamId"] | 0, 11);
+
+    // Nothing new above the watermark: the incremental pass cannot see it
+    TEST_ASSERT_EQUAL(0, reducerConsume(incremental, all, ctx));
+    reducerReconcileFinal(incremental, all, ctx);
+    TEST_ASSERT_TRUE(incremental.reconciled);
+
+    reducerReset(rescan, GAME_ID);
+    reducerConsume(rescan, all, ctx);
+    assertSameAggregates(rescan, incremental);
+    TEST_ASSERT_EQUAL_STRING(rescan.goals[0].assist1, incremental.goals[0].assist1);
+}
+
+void test_power_play_goal_ends_minor() {
+    JsonDocument doc;
+    JsonArray plays = doc["plays"].to<JsonArray>();
+    JsonObject pen = plays.add<JsonObject>();
+    pen["eventId"] = 1;
+    pen["sortOrder"] = 10;
+    pen["typeDescKey"] = "penalty";
+    pen["periodDescriptor"]["number"] = 1;
+    pen["timeRemaining"] = "10:00";
+    pen["details"]["eventOwnerTeamId"] = AWAY_ID;
+    pen["details"]["typeCode"] = "MIN";
+    pen["details"]["duration"] = 2;
+    pen["details"]["descKey"] = "tripping";
+    const TeamContext ctx = context();
+
+    reducerReset(incremental, GAME_ID);
+    reducerConsume(incremental, plays, ctx);
+    PenaltyEntry active[kMaxPenalties];
+    // 30 s into the minor
+    TEST_ASSERT_EQUAL(1, reducerActivePenalties(incremental, 1, 5700, active, kMaxPenalties));
+    TEST_ASSERT_EQUAL(900, active[0].remainingTenths);
+    TEST_ASSERT_EQUAL_STRING("TRIPPING", active[0].infraction);
+    TEST_ASSERT_EQUAL_STRING("BENCH", active[0].player);
+
+    JsonObject goal = plays.add<JsonObject>();
+    goal["eventId"] = 2;
+    goal["sortOrder"] = 11;
+    goal["typeDescKey"] = "goal";
+    goal["periodDescriptor"]["number"] = 1;
+    goal["timeRemaining"] = "09:20";
+    goal["details"]["eventOwnerTeamId"] = HOME_ID;
+    goal["details"]["scoringPlayerId"] = playerId(HOME_ID, 1);
+    goal["details"]["scoringPlayerName"]["default"] = "C. Caufield";
+    TEST_ASSERT_EQUAL(1, reducerConsume(incremental, plays, ctx));
+    TEST_ASSERT_EQUAL(0, reducerActivePenalties(incremental, 1, 5500, active, kMaxPenalties));
+    TEST_ASSERT_EQUAL_STRING("CAUFIELD", incremental.goals[0].scorer);
+    TEST_ASSERT_EQUAL(1, incremental.stats.home.goals[0]);
+
+    // Coincidental minors, then a 4-on-4 goal: both minors run on
+    plays.add(pen);
+    JsonObject homePen = plays[plays.size() - 1];
+    homePen["eventId"] = 3;
+    homePen["sortOrder"] = 12;
+    homePen["timeRemaining"] = "08:00";
+    homePen["details"]["eventOwnerTeamId"] = HOME_ID;
+    plays.add(pen);
+    JsonObject awayPen = plays[plays.size() - 1];
+    awayPen["eventId"] = 4;
+    awayPen["sortOrder"] = 13;
+    awayPen["timeRemaining"] = "08:00";
+    plays.add(goal);
+    JsonObject evenGoal = plays[plays.size() - 1];
+    evenGoal["eventId"] = 5;
+    evenGoal["sortOrder"] = 14;
+    evenGoal["timeRemaining"] = "07:30";
+    TEST_ASSERT_EQUAL(3, reducerConsume(incremental, plays, ctx));
+    TEST_ASSERT_EQUAL(2, reducerActivePenalties(incremental, 1, 4400, active, kMaxPenalties));
+
+    // Short-handed goal, per its situationCode: the scorer's own minor runs on
+    plays.add(pen);
+    JsonObject shPen = plays[plays.size() - 1];
+    shPen["eventId"] = 6;
+    shPen["sortOrder"] = 15;
+    shPen["timeRemaining"] = "05:00";
+    plays.add(goal);
+    JsonObject shGoal = plays[plays.size() - 1];
+    shGoal["eventId"] = 7;
+    shGoal["sortOrder"] = 16;
+    shGoal["timeRemaining"] = "04:30";
+    shGoal["situationCode"] = "1451";
+    shGoal["details"]["eventOwnerTeamId"] = AWAY_ID;
+    TEST_ASSERT_EQUAL(2, reducerConsume(incremental, plays, ctx));
+    TEST_ASSERT_EQUAL(1, reducerActivePenalties(incremental, 1, 2600, active, kMaxPenalties));
+    TEST_ASSERT_EQUAL(800, active[0].remainingTenths);
+    TEST_ASSERT_EQUAL(1, incremental.stats.away.goals[0]);
+}
+
+// Late in a game a poll brings one or two new plays; the incremental pass
+// should cost the same regardless of how many plays came before.
+void test_late_game_poll_cost() {
+    JsonDocument game;
+    buildGame(game, 420, 99);
+    buildRosterCache(roster, game["rosterSpots"], GAME_ID);
+    JsonArray all = game["plays"];
+    const TeamContext ctx = context();
+
+    JsonDocument before;
+    copyPrefix(all, all.size() - 1, before);
+    reducerReset(saved, GAME_ID);
+    reducerConsume(saved, before["plays"], ctx);
+
+    constexpr int ROUNDS = 200;
+    using Clock = std::chrono::steady_clock;
+    uint32_t applied = 0;
+    const auto incStart = Clock::now();
+    for (int i = 0; i < ROUNDS; ++i) {
+        incremental = saved;
+        applied += reducerConsume(incremental, all, ctx);
+    }
+    const auto incEnd = Clock::now();
+    for (int i = 0; i < ROUNDS; ++i) {
+        reducerReset(rescan, GAME_ID);
+        reducerConsume(rescan, all, ctx);
+    }
+    const auto scanEnd = Clock::now();
+
+    TEST_ASSERT_EQUAL(ROUNDS, applied);
+    assertSameAggregates(rescan, incremental);
+
+    const double incUs = std::chrono::duration<double, std::micro>(incEnd - incStart).count() / ROUNDS;
+    const double scanUs = std::chrono::duration<double, std::micro>(scanEnd - incEnd).count() / ROUNDS;
+    char msg[96];
+    snprintf(msg, sizeof(msg), "420 plays: incremental %.1f us/poll, full rescan %.1f us/poll", incUs, scanUs);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(incUs < scanUs);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_incremental_matches_rescan_after_every_poll);
+    RUN_TEST(test_repeated_poll_applies_nothing);
+    RUN_TEST(test_rewound_feed_rebuilds_from_scratch);
+    RUN_TEST(test_reconcile_picks_up_amended_assists);
+    RUN_TEST(test_power_play_goal_ends_minor);
+    RUN_TEST(test_late_game_poll_cost);
+    return UNITY_END();
+}
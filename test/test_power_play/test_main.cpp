@@ -0,0 +1,276 @@
+#include <unity.h>
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "display/clock_interpolator.h"
+
+// Replays scripted power plays the way the penalty scene sees them: the
+// feed's whole-second game clock and situation time, polled at a fixed
+// interval with network and parse delays, then counted down locally on
+// 33 ms frames. Each sequence runs at the current 10 s poll interval and
+// at 20 s.
+
+namespace {
+    constexpr uint32_t FRAME_MS = 33;
+    constexpr uint32_t REQUEST_MAX_MS = 200;    // poll start -> server sample
+    constexpr uint32_t RESPONSE_MAX_MS = 300;   // server sample -> headers
+    constexpr uint32_t PARSE_MAX_MS = 1500;     // headers -> data model
+    constexpr uint32_t SLEW_SETTLE_MS = 15000;  // a 3 s slew at 25% plus its tail
+
+    struct Segment {
+        uint32_t untilMs;   // wall time this clock state lasts until
+        bool running;
+    };
+
+    struct Sequence {
+        const char* name;
+        uint16_t clockStartTenths;   // game clock when the replay starts
+        uint16_t ppLengthTenths;     // PP time left when the replay starts
+        const Segment* segments;
+        size_t segmentCount;
+    };
+
+    // Minor called at 14:32, faceoff, two whistles, then killed off
+    const Segment MINOR_KILLED[] = {
+        {15000, false}, {40000, true}, {70000, false}, {115000, true},
+        {140000, false}, {260000, true},
+    };
+    // Double minor with a long video review in the middle
+    const Segment DOUBLE_MINOR_REVIEW[] = {
+        {8000, false}, {95000, true}, {185000, false}, {300000, true},
+        {330000, false}, {420000, true},
+    };
+    // Minor called with 1:10 left in the period; the period ends first
+    const Segment MINOR_PERIOD_END[] = {
+        {12000, false}, {90000, true},
+    };
+
+    const Sequence SEQUENCES[] = {
+        {"minor killed", 8720, 1200, MINOR_KILLED, sizeof(MINOR_KILLED) / sizeof(MINOR_KILLED[0])},
+        {"double minor with review", 5110, 2400, DOUBLE_MINOR_REVIEW,
+            sizeof(DOUBLE_MINOR_REVIEW) / sizeof(DOUBLE_MINOR_REVIEW[0])},
+        {"minor at period end", 700, 1200, MINOR_PERIOD_END,
+            sizeof(MINOR_PERIOD_END) / sizeof(MINOR_PERIOD_END[0])},
+    };
+
+    uint32_t rngState = 1;
+    uint32_t nextRand(uint32_t range) {
+        rngState = rngState * 1664525u + 1013904223u;
+        return (rngState >> 8) % range;
+    }
+
+    bool runningAt(const Sequence& seq, uint32_t wallMs) {
+        for (size_t i = 0; i < seq.segmentCount; ++i) {
+            if (wallMs < seq.segments[i].untilMs) return seq.segments[i].running;
+        }
+        return false;
+    }
+
+    uint32_t lengthMs(const Sequence& seq) {
+        return seq.segments[seq.segmentCount - 1].untilMs;
+    }
+
+    struct ReplayResult {
+        int32_t settledOverMs;    // countdown shows more than the truth
+        int32_t settledUnderMs;   // countdown shows less (negative)
+        int32_t worstOverMs;      // any frame, including whistles and faceoffs
+        int32_t worstUnderMs;
+        int32_t expiryErrorMs;    // when 0:00 first showed minus when the PP ended
+        uint32_t settledFrames;
+        uint32_t countedUp;
+        uint32_t polls;
+    };
+
+    ReplayResult replay(const Sequence& seq, uint32_t pollMs, uint32_t seed) {
+        rngState = seed;
+        ClockInterpolator clock;
+        ReplayResult r = {INT32_MIN, INT32_MAX, INT32_MIN, INT32_MAX, 0, 0, 0, 0};
+
+        const int32_t ppEndMs = (int32_t)seq.clockStartTenths * 100 - (int32_t)seq.ppLengthTenths * 100;
+        int32_t clockMs = (int32_t)seq.clockStartTenths * 100;
+        bool wasRunning = runningAt(seq, 0);
+        uint32_t lastToggle = 0;
+
+        uint32_t pollAt = nextRand(pollMs) / FRAME_MS * FRAME_MS;
+        bool inFlight = false;
+        bool sampled = false;
+        uint32_t sampleAt = 0, headersAt = 0, ingestAt = 0;
+        uint16_t clockSample = 0, ppSample = 0;
+        bool runningSample = false;
+        uint32_t sampleTakenMs = 0;
+
+        // What the scene holds
+        uint16_t sceneClock = 0;
+        uint16_t scenePp = 0;
+        bool haveSample = false;
+
+        int samplesSinceStart = 0;
+        uint32_t firstRunningSyncMs = 0;
+        int32_t lastShown = -1;
+        bool expired = false;
+        uint32_t shownZeroAt = 0;
+        uint32_t trueEndAt = 0;
+
+        const uint32_t end = lengthMs(seq);
+        for (uint32_t now = 0; now < end; now += FRAME_MS) {
+            const bool running = runningAt(seq, now) && clockMs > 0;
+            if (running != wasRunning) {
+                wasRunning = running;
+                lastToggle = now;
+                samplesSinceStart = 0;
+            }
+
+            if (!inFlight && now >= pollAt) {
+                inFlight = true;
+                sampled = false;
+                sampleAt = now + nextRand(REQUEST_MAX_MS);
+                headersAt = sampleAt + nextRand(RESPONSE_MAX_MS);
+                ingestAt = headersAt + nextRand(PARSE_MAX_MS);
+                pollAt += pollMs;
+                r.polls++;
+            }
+            if (inFlight && !sampled && now >= sampleAt) {
+                // Both read off the same whole-second game clock
+                const int32_t shownSec = clockMs / 1000;
+                const int32_t ppSec = shownSec - ppEndMs / 1000;
+                clockSample = (uint16_t)(shownSec * 10);
+                ppSample = (uint16_t)(ppSec > 0 ? ppSec * 10 : 0);
+                runningSample = running;
+                sampleTakenMs = now;
+                sampled = true;
+            }
+            if (inFlight && now >= ingestAt) {
+                clock.sync(clockSample, runningSample, headersAt, now);
+                sceneClock = clockSample;
+                scenePp = ppSample;
+                haveSample = true;
+                if (runningSample && sampleTakenMs >= lastToggle) {
+                    if (samplesSinceStart++ == 0) firstRunningSyncMs = now;
+                }
+                inFlight = false;
+            }
+
+            const int32_t truthMs = clockMs - ppEndMs;
+            if (haveSample && truthMs > 0) {
+                const int32_t shown = (int32_t)countdownTenths(scenePp, sceneClock, clock.displayTenths(now)) * 100;
+                const int32_t err = shown - truthMs;
+                if (err > r.worstOverMs) r.worstOverMs = err;
+                if (err < r.worstUnderMs) r.worstUnderMs = err;
+
+                const bool settled = running && samplesSinceStart >= 2
+                    && now - firstRunningSyncMs >= SLEW_SETTLE_MS;
+                if (settled) {
+                    if (err > r.settledOverMs) r.settledOverMs = err;
+                    if (err < r.settledUnderMs) r.settledUnderMs = err;
+                    r.settledFrames++;
+                    if (lastShown >= 0 && shown > lastShown) r.countedUp++;
+                    lastShown = shown;
+                } else {
+                    lastShown = -1;
+                }
+                if (shown == 0 && !expired) {
+                    expired = true;
+                    shownZeroAt = now;
+                }
+            } else if (haveSample) {
+                clock.displayTenths(now);
+            }
+
+            if (running) {
+                clockMs -= (int32_t)FRAME_MS;
+                if (clockMs - ppEndMs <= 0 && trueEndAt == 0) trueEndAt = now + FRAME_MS;
+            }
+        }
+        if (expired && trueEndAt) r.expiryErrorMs = (int32_t)(shownZeroAt - trueEndAt);
+        return r;
+    }
+
+    void report(const Sequence& seq, uint32_t pollMs, const ReplayResult& r) {
+        char msg[160];
+        snprintf(msg, sizeof(msg), "%s @%us: %u polls, settled %ld..%ld ms, worst %ld..%ld ms",
+            seq.name, (unsigned)(pollMs / 1000), (unsigned)r.polls,
+            (long)r.settledUnderMs, (long)r.settledOverMs, (long)r.worstUnderMs, (long)r.worstOverMs);
+        TEST_MESSAGE(msg);
+    }
+
+    // While the clock runs steadily the countdown is only off by the
+    // feed's whole seconds, the response delay and frame granularity,
+    // whatever the poll interval.
+    void checkSettled(uint32_t pollMs) {
+        for (const Sequence& seq : SEQUENCES) {
+            for (uint32_t seed = 1; seed <= 6; ++seed) {
+                const ReplayResult r = replay(seq, pollMs, seed);
+                if (seed == 1) report(seq, pollMs, r);
+                TEST_ASSERT_GREATER_THAN(100, r.settledFrames);
+                TEST_ASSERT_LESS_OR_EQUAL(RESPONSE_MAX_MS + 2 * FRAME_MS, r.settledOverMs);
+                TEST_ASSERT_GREATER_OR_EQUAL(-(1000 + 100 + 2 * (int32_t)FRAME_MS), r.settledUnderMs);
+                TEST_ASSERT_EQUAL_UINT32(0, r.countedUp);
+            }
+        }
+    }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+void test_countdown_follows_clock_stoppages() {
+    // 1:30 of PP when the clock read 12:00
+    TEST_ASSERT_EQUAL_UINT16(900, countdownTenths(900, 7200, 7200));
+    TEST_ASSERT_EQUAL_UINT16(650, countdownTenths(900, 7200, 6950));
+    TEST_ASSERT_EQUAL_UINT16(0, countdownTenths(900, 7200, 6300));
+    TEST_ASSERT_EQUAL_UINT16(0, countdownTenths(900, 7200, 100));
+    // A clock that reads more than the sample (new period, stale PP) does
+    // not add time
+    TEST_ASSERT_EQUAL_UINT16(900, countdownTenths(900, 7200, 7400));
+}
+
+void test_settled_error_at_current_poll_interval() {
+    checkSettled(10000);
+}
+
+void test_settled_error_at_twice_the_poll_interval() {
+    checkSettled(20000);
+}
+
+void test_whistles_cost_at_most_one_poll() {
+    // The device cannot see a whistle or faceoff before the next poll: the
+    // countdown is off by at most one poll interval plus the delays, and
+    // catches up after that.
+    const uint32_t intervals[2] = {10000, 20000};
+    for (uint32_t pollMs : intervals) {
+        const int32_t bound = (int32_t)(pollMs + REQUEST_MAX_MS + RESPONSE_MAX_MS + PARSE_MAX_MS + 2 * FRAME_MS);
+        for (const Sequence& seq : SEQUENCES) {
+            for (uint32_t seed = 1; seed <= 6; ++seed) {
+                const ReplayResult r = replay(seq, pollMs, seed);
+                TEST_ASSERT_LESS_OR_EQUAL(bound, r.worstOverMs);
+                TEST_ASSERT_GREATER_OR_EQUAL(-bound - 1000, r.worstUnderMs);
+            }
+        }
+    }
+}
+
+void test_killed_penalty_reaches_zero_on_time() {
+    // The kill ends while the clock runs, so 0:00 shows within the settled
+    // error of the real expiry
+    for (uint32_t seed = 1; seed <= 6; ++seed) {
+        const ReplayResult r = replay(SEQUENCES[0], 10000, seed);
+        TEST_ASSERT_INT_WITHIN(1000 + 100 + 2 * (int32_t)FRAME_MS, 0, r.expiryErrorMs);
+    }
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_countdown_follows_clock_stoppages);
+    RUN_TEST(test_settled_error_at_current_poll_interval);
+    RUN_TEST(test_settled_error_at_twice_the_poll_interval);
+    RUN_TEST(test_whistles_cost_at_most_one_poll);
+    RUN_TEST(test_killed_penalty_reaches_zero_on_time);
+    return UNITY_END();
+}
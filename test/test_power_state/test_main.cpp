@@ -0,0 +1,95 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "power_state.h"
+
+// The standby state machine: every state/event pair, and event sequences
+// driven the way power_manager applies them (enter/exit only run when the
+// state actually changes).
+
+namespace {
+    struct Applied {
+        PowerState state;
+        int enters;
+        int exits;
+    };
+
+    // Mirrors power_manager's apply()
+    void apply(Applied& a, PowerEvent event) {
+        const PowerState next = powerNextState(a.state, event);
+        if (next == a.state) return;
+        if (next == PowerState::Standby) {
+            a.enters++;
+        } else {
+            a.exits++;
+        }
+        a.state = next;
+    }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// ============================================================================
+// TRANSITIONS
+// ============================================================================
+
+void test_every_state_event_pair() {
+    TEST_ASSERT_TRUE(powerNextState(PowerState::Active, PowerEvent::StandbyRequested) == PowerState::Standby);
+    TEST_ASSERT_TRUE(powerNextState(PowerState::Active, PowerEvent::WakeRequested) == PowerState::Active);
+    TEST_ASSERT_TRUE(powerNextState(PowerState::Standby, PowerEvent::StandbyRequested) == PowerState::Standby);
+    TEST_ASSERT_TRUE(powerNextState(PowerState::Standby, PowerEvent::WakeRequested) == PowerState::Active);
+}
+
+void test_unknown_event_keeps_state() {
+    const PowerEvent bogus = (PowerEvent)42;
+    TEST_ASSERT_TRUE(powerNextState(PowerState::Active, bogus) == PowerState::Active);
+    TEST_ASSERT_TRUE(powerNextState(PowerState::Standby, bogus) == PowerState::Standby);
+}
+
+void test_repeated_requests_apply_once() {
+    // The web UI can send the same toggle twice; the panel and clock must
+    // only be switched once each way
+    Applied a = {PowerState::Active, 0, 0};
+    const PowerEvent events[] = {
+        PowerEvent::WakeRequested,
+        PowerEvent::StandbyRequested, PowerEvent::StandbyRequested, PowerEvent::StandbyRequested,
+        PowerEvent::WakeRequested, PowerEvent::WakeRequested,
+        PowerEvent::StandbyRequested, PowerEvent::WakeRequested,
+    };
+    for (PowerEvent e : events) apply(a, e);
+    TEST_ASSERT_TRUE(a.state == PowerState::Active);
+    TEST_ASSERT_EQUAL_INT(2, a.enters);
+    TEST_ASSERT_EQUAL_INT(2, a.exits);
+}
+
+void test_enters_and_exits_stay_paired() {
+    // Any sequence leaves at most one unmatched enter, and only in standby
+    Applied a = {PowerState::Active, 0, 0};
+    uint32_t rng = 7;
+    for (int i = 0; i < 1000; ++i) {
+        rng = rng * 1664525u + 1013904223u;
+        apply(a, (rng >> 16) & 1 ? PowerEvent::StandbyRequested : PowerEvent::WakeRequested);
+        const int open = a.enters - a.exits;
+        TEST_ASSERT_TRUE(open == 0 || open == 1);
+        TEST_ASSERT_EQUAL_INT(a.state == PowerState::Standby ? 1 : 0, open);
+    }
+}
+
+void test_state_names() {
+    TEST_ASSERT_EQUAL_STRING("active", powerStateName(PowerState::Active));
+    TEST_ASSERT_EQUAL_STRING("standby", powerStateName(PowerState::Standby));
+    TEST_ASSERT_EQUAL_STRING("?", powerStateName((PowerState)9));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_every_state_event_pair);
+    RUN_TEST(test_unknown_event_keeps_state);
+    RUN_TEST(test_repeated_requests_apply_once);
+    RUN_TEST(test_enters_and_exits_stay_paired);
+    RUN_TEST(test_state_names);
+    return UNITY_END();
+}
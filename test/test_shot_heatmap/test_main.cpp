@@ -0,0 +1,242 @@
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <ArduinoJson.h>
+
+#include "display/shot_grid.h"
+#include "pbp_reducer.h"
+
+// The shot grid behind HeatmapScene: binning, the version the scene
+// rebuilds its bitmap on, and what feeding it from the reducer costs per
+// poll as a game grows.
+
+namespace {
+    constexpr uint32_t GAME_ID = 2024020345;
+    constexpr uint32_t AWAY_ID = 10;
+    constexpr uint32_t HOME_ID = 8;
+
+    ShotGrid grid;
+    uint32_t adds = 0;
+    uint32_t resets = 0;
+
+    void sinkAdd(bool homeTeam, int x, int y, bool homeDefendsRight, bool goal) {
+        adds++;
+        grid.add(homeTeam, x, y, homeDefendsRight, goal);
+    }
+
+    void sinkReset() {
+        resets++;
+        grid.reset();
+    }
+
+    TeamContext context() {
+        return {GAME_ID, AWAY_ID, HOME_ID, "TOR", "MTL", nullptr, {sinkAdd, sinkReset}};
+    }
+
+    uint32_t rngState = 1;
+    uint32_t nextRand(uint32_t range) {
+        rngState = rngState * 1664525u + 1013904223u;
+        return (rngState >> 8) % range;
+    }
+
+    // Shots, goals and filler plays in roughly a real feed's mix
+    void buildGame(JsonDocument& doc, size_t playCount, uint32_t seed) {
+        rngState = seed;
+        JsonArray plays = doc["plays"].to<JsonArray>();
+        for (size_t i = 0; i < playCount; ++i) {
+            const int period = 1 + (int)(i * 3 / playCount);
+            JsonObject p = plays.add<JsonObject>();
+            p["eventId"] = 100 + (int)i;
+            p["sortOrder"] = 10 + (int)i * 2;
+            p["periodDescriptor"]["number"] = period;
+            p["timeRemaining"] = "10:00";
+            p["homeTeamDefendingSide"] = period == 2 ? "right" : "left";
+            JsonObject d = p["details"].to<JsonObject>();
+            d["eventOwnerTeamId"] = nextRand(2) ? HOME_ID : AWAY_ID;
+            const uint32_t kind = nextRand(100);
+            if (kind < 4 || kind >= 60) {
+                p["typeDescKey"] = kind < 4 ? "goal" : "shot-on-goal";
+                d["xCoord"] = (int)nextRand(180) - 90;
+                d["yCoord"] = (int)nextRand(80) - 40;
+            } else {
+                p["typeDescKey"] = kind < 30 ? "faceoff" : "hit";
+            }
+        }
+    }
+
+    void copyPrefix(JsonArray all, size_t n, JsonDocument& out) {
+        out.clear();
+        JsonArray plays = out["plays"].to<JsonArray>();
+        for (size_t i = 0; i < n && i < all.size(); ++i) plays.add(all[i]);
+    }
+
+    uint32_t shotsIn(JsonArray all, size_t from, size_t to) {
+        uint32_t n = 0;
+        for (size_t i = from; i < to; ++i) {
+            if (!all[i]["details"]["xCoord"].isNull()) n++;
+        }
+        return n;
+    }
+
+    GameReducer reducer;
+    GameReducer saved;
+}
+
+void setUp() {
+    grid.reset();
+    adds = 0;
+    resets = 0;
+}
+
+void tearDown() {}
+
+// ============================================================================
+// GRID
+// ============================================================================
+
+void test_memory_figures() {
+    // The grid, the scene's copy of it and the scene's 64x32 RGB565 bitmap
+    TEST_ASSERT_EQUAL_UINT32(1028, sizeof(ShotHeatmapGrid));
+    TEST_ASSERT_EQUAL_UINT32(1024, sizeof(ShotHeatmapGrid::away) + sizeof(ShotHeatmapGrid::home));
+    TEST_ASSERT_EQUAL_UINT32(4096, 64 * 32 * sizeof(uint16_t));
+}
+
+void test_binning_follows_attack_direction() {
+    // Center ice, both goal lines, out-of-rink coordinates clamp
+    TEST_ASSERT_EQUAL_INT(15, ShotGrid::column(0, false));
+    TEST_ASSERT_EQUAL_INT(1, ShotGrid::column(-89, false));
+    TEST_ASSERT_EQUAL_INT(30, ShotGrid::column(89, false));
+    TEST_ASSERT_EQUAL_INT(0, ShotGrid::column(-150, false));
+    TEST_ASSERT_EQUAL_INT(31, ShotGrid::column(150, false));
+    TEST_ASSERT_EQUAL_INT(0, ShotGrid::row(-43, false));
+    TEST_ASSERT_EQUAL_INT(15, ShotGrid::row(43, false));
+    // When home defends the right goal the rink is turned around
+    TEST_ASSERT_EQUAL_INT(ShotGrid::column(-89, false), ShotGrid::column(89, true));
+    TEST_ASSERT_EQUAL_INT(ShotGrid::row(-30, false), ShotGrid::row(30, true));
+}
+
+void test_version_moves_only_when_a_cell_changes() {
+    TEST_ASSERT_FALSE(grid.reset());
+    const uint32_t v0 = grid.version();
+    TEST_ASSERT_TRUE(grid.add(true, 80, 0, false, true));
+    TEST_ASSERT_EQUAL_UINT32(v0 + 1, grid.version());
+    TEST_ASSERT_EQUAL_UINT8(3, grid.grid().home[ShotGrid::row(0, false)][ShotGrid::column(80, false)]);
+
+    // Fill one cell to saturation: further shots there change nothing
+    for (int i = 0; i < 100; ++i) grid.add(false, -80, 10, false, true);
+    const uint32_t saturated = grid.version();
+    TEST_ASSERT_EQUAL_UINT8(255, grid.grid().peak);
+    TEST_ASSERT_FALSE(grid.add(false, -80, 10, false, true));
+    TEST_ASSERT_FALSE(grid.add(false, -80, 10, false, false));
+    TEST_ASSERT_EQUAL_UINT32(saturated, grid.version());
+
+    TEST_ASSERT_TRUE(grid.reset());
+    TEST_ASSERT_EQUAL_UINT32(saturated + 1, grid.version());
+    TEST_ASSERT_FALSE(grid.reset());
+    TEST_ASSERT_EQUAL_UINT32(saturated + 1, grid.version());
+}
+
+// ============================================================================
+// FED BY THE REDUCER
+// ============================================================================
+
+void test_poll_cost_is_linear_in_new_plays() {
+    JsonDocument game;
+    buildGame(game, 360, 21);
+    JsonArray all = game["plays"];
+    const TeamContext ctx = context();
+    reducerReset(reducer, GAME_ID);
+
+    JsonDocument poll;
+    size_t seen = 0;
+    rngState = 5;
+    while (seen < all.size()) {
+        const size_t before = seen;
+        seen += 1 + nextRand(10);
+        if (seen > all.size()) seen = all.size();
+        copyPrefix(all, seen, poll);
+        const uint32_t addsBefore = adds;
+        // Only the new plays are walked and only their shots reach the grid
+        TEST_ASSERT_EQUAL_UINT32(seen - before, reducerConsume(reducer, poll["plays"], ctx));
+        TEST_ASSERT_EQUAL_UINT32(shotsIn(all, before, seen), adds - addsBefore);
+    }
+    TEST_ASSERT_EQUAL_UINT32(shotsIn(all, 0, all.size()), adds);
+    TEST_ASSERT_EQUAL_UINT32(adds, grid.grid().shots);
+}
+
+void test_repeated_poll_is_a_no_op() {
+    JsonDocument game;
+    buildGame(game, 120, 8);
+    const TeamContext ctx = context();
+    reducerReset(reducer, GAME_ID);
+    reducerConsume(reducer, game["plays"], ctx);
+    const uint32_t version = grid.version();
+    const uint32_t addsBefore = adds;
+
+    for (int i = 0; i < 5; ++i) {
+        TEST_ASSERT_EQUAL_UINT32(0, reducerConsume(reducer, game["plays"], ctx));
+    }
+    TEST_ASSERT_EQUAL_UINT32(addsBefore, adds);
+    TEST_ASSERT_EQUAL_UINT32(version, grid.version());
+    TEST_ASSERT_EQUAL_UINT32(0, resets);
+}
+
+void test_late_game_update_cost() {
+    // The last poll of a long game brings one shot: the incremental path
+    // touches one cell, a rescan rebuilds the whole grid
+    JsonDocument game;
+    buildGame(game, 420, 99);
+    JsonArray all = game["plays"];
+    JsonObject last = all[all.size() - 1];
+    last["typeDescKey"] = "shot-on-goal";
+    last["details"]["xCoord"] = 70;
+    last["details"]["yCoord"] = 5;
+    const TeamContext ctx = context();
+
+    JsonDocument before;
+    copyPrefix(all, all.size() - 1, before);
+    reducerReset(saved, GAME_ID);
+    reducerConsume(saved, before["plays"], ctx);
+    const ShotGrid savedGrid = grid;
+
+    constexpr int ROUNDS = 200;
+    using Clock = std::chrono::steady_clock;
+    uint32_t changed = 0;
+    const auto incStart = Clock::now();
+    for (int i = 0; i < ROUNDS; ++i) {
+        reducer = saved;
+        grid = savedGrid;
+        const uint32_t v = grid.version();
+        reducerConsume(reducer, all, ctx);
+        changed += grid.version() - v;
+    }
+    const auto incEnd = Clock::now();
+    for (int i = 0; i < ROUNDS; ++i) {
+        grid.reset();
+        reducerReset(reducer, GAME_ID);
+        reducerConsume(reducer, all, ctx);
+    }
+    const auto scanEnd = Clock::now();
+
+    // One new shot, one cell, one bitmap rebuild per poll
+    TEST_ASSERT_EQUAL_UINT32(ROUNDS, changed);
+    const double incUs = std::chrono::duration<double, std::micro>(incEnd - incStart).count() / ROUNDS;
+    const double scanUs = std::chrono::duration<double, std::micro>(scanEnd - incEnd).count() / ROUNDS;
+    char msg[120];
+    snprintf(msg, sizeof(msg), "420 plays, 1 new shot: incremental %.1f us/poll, rescan %.1f us/poll", incUs, scanUs);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(incUs < scanUs);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_memory_figures);
+    RUN_TEST(test_binning_follows_attack_direction);
+    RUN_TEST(test_version_moves_only_when_a_cell_changes);
+    RUN_TEST(test_poll_cost_is_linear_in_new_plays);
+    RUN_TEST(test_repeated_poll_is_a_no_op);
+    RUN_TEST(test_late_game_update_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,197 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "snapshot_record.h"
+
+// The warm-start record as it sits on flash: layout, CRC, the checks that
+// make a damaged or foreign file fall back to a cold start, and the
+// content comparison the save task debounces on.
+
+namespace {
+    GameSnapshot sample() {
+        static GameSnapshot snap;
+        memset(&snap, 0, sizeof(snap));
+        snap.gameId = 2024020345;
+        strcpy(snap.gameState, "LIVE");
+        strcpy(snap.startTimeUtc, "2025-01-19T00:00:00Z");
+        strcpy(snap.utcOffset, "-05:00");
+        snap.away = {10, "TOR", "Maple Leafs", 2, 27};
+        snap.home = {8, "MTL", "Canadiens", 3, 31};
+        snap.period = 3;
+        snap.inIntermission = false;
+        strcpy(snap.timeRemaining, "04:12");
+        // Not persisted
+        snap.clockTenths = 2520;
+        snap.goalIsNew = true;
+        snap.penaltyCount = 1;
+        return snap;
+    }
+
+    void encodeSample(uint8_t* buf, int64_t savedAt = 1737250000) {
+        SnapshotRecord rec;
+        snapshotPack(rec, sample(), savedAt);
+        snapshotEncode(rec, buf);
+    }
+
+    // Rewrites the header CRC after the payload has been tampered with
+    void resealCrc(uint8_t* buf) {
+        SnapshotHeader header;
+        memcpy(&header, buf, sizeof(header));
+        header.crc = snapshotCrc32(buf + sizeof(header), sizeof(SnapshotRecord));
+        memcpy(buf, &header, sizeof(header));
+    }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// ============================================================================
+// FORMAT
+// ============================================================================
+
+void test_layout_is_pinned() {
+    // A change here means old records on flash no longer parse: bump
+    // kSnapshotVersion together with the sizes below.
+    TEST_ASSERT_EQUAL_UINT16(1, kSnapshotVersion);
+    TEST_ASSERT_EQUAL_UINT32(12, sizeof(SnapshotHeader));
+    TEST_ASSERT_EQUAL_UINT32(160, sizeof(SnapshotRecord));
+    TEST_ASSERT_EQUAL_UINT32(172, kSnapshotFileSize);
+
+    uint8_t buf[kSnapshotFileSize];
+    encodeSample(buf);
+    const uint8_t magic[4] = {'S', 'B', 'S', 'P'};
+    TEST_ASSERT_EQUAL_MEMORY(magic, buf, 4);
+    TEST_ASSERT_EQUAL_UINT8(1, buf[4]);
+    TEST_ASSERT_EQUAL_UINT8(0, buf[5]);
+    TEST_ASSERT_EQUAL_UINT8(160, buf[6]);
+    TEST_ASSERT_EQUAL_UINT8(0, buf[7]);
+}
+
+void test_crc32_reference_vector() {
+    const char* check = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, snapshotCrc32((const uint8_t*)check, 9));
+    TEST_ASSERT_EQUAL_HEX32(0x00000000, snapshotCrc32(nullptr, 0));
+}
+
+void test_round_trip_keeps_persisted_fields() {
+    uint8_t buf[kSnapshotFileSize];
+    encodeSample(buf);
+    SnapshotRecord rec;
+    TEST_ASSERT_TRUE(snapshotDecode(buf, sizeof(buf), rec));
+    TEST_ASSERT_EQUAL_INT64(1737250000, rec.savedAtEpoch);
+
+    GameSnapshot out;
+    snapshotUnpack(out, rec);
+    const GameSnapshot in = sample();
+    TEST_ASSERT_EQUAL_UINT32(in.gameId, out.gameId);
+    TEST_ASSERT_EQUAL_STRING(in.gameState, out.gameState);
+    TEST_ASSERT_EQUAL_STRING(in.startTimeUtc, out.startTimeUtc);
+    TEST_ASSERT_EQUAL_STRING(in.utcOffset, out.utcOffset);
+    TEST_ASSERT_EQUAL_STRING("TOR", out.away.abbrev);
+    TEST_ASSERT_EQUAL_STRING("Canadiens", out.home.name);
+    TEST_ASSERT_EQUAL_UINT16(2, out.away.score);
+    TEST_ASSERT_EQUAL_UINT16(31, out.home.sog);
+    TEST_ASSERT_EQUAL_UINT8(3, out.period);
+    TEST_ASSERT_EQUAL_STRING("04:12", out.timeRemaining);
+    // Live-only state is not carried over
+    TEST_ASSERT_EQUAL_UINT16(0, out.clockTenths);
+    TEST_ASSERT_FALSE(out.goalIsNew);
+    TEST_ASSERT_EQUAL_UINT8(0, out.penaltyCount);
+}
+
+// ============================================================================
+// REJECTION
+// ============================================================================
+
+void test_damaged_or_foreign_records_are_rejected() {
+    uint8_t buf[kSnapshotFileSize];
+    SnapshotRecord rec;
+
+    encodeSample(buf);
+    buf[sizeof(SnapshotHeader) + 20] ^= 0x01;
+    TEST_ASSERT_FALSE(snapshotDecode(buf, sizeof(buf), rec));
+
+    encodeSample(buf);
+    buf[0] = 'X';
+    TEST_ASSERT_FALSE(snapshotDecode(buf, sizeof(buf), rec));
+
+    encodeSample(buf);
+    buf[4] = 2;  // a future version
+    TEST_ASSERT_FALSE(snapshotDecode(buf, sizeof(buf), rec));
+
+    encodeSample(buf);
+    buf[6] = 150;  // a different payload size
+    TEST_ASSERT_FALSE(snapshotDecode(buf, sizeof(buf), rec));
+
+    encodeSample(buf);
+    TEST_ASSERT_FALSE(snapshotDecode(buf, sizeof(buf) - 1, rec));
+    TEST_ASSERT_FALSE(snapshotDecode(nullptr, sizeof(buf), rec));
+}
+
+void test_unterminated_strings_are_terminated() {
+    uint8_t buf[kSnapshotFileSize];
+    encodeSample(buf);
+    SnapshotRecord raw;
+    memcpy(&raw, buf + sizeof(SnapshotHeader), sizeof(raw));
+    memset(raw.gameState, 'A', sizeof(raw.gameState));
+    memset(raw.away.name, 'B', sizeof(raw.away.name));
+    memset(raw.timeRemaining, '9', sizeof(raw.timeRemaining));
+    memcpy(buf + sizeof(SnapshotHeader), &raw, sizeof(raw));
+    resealCrc(buf);
+
+    SnapshotRecord rec;
+    TEST_ASSERT_TRUE(snapshotDecode(buf, sizeof(buf), rec));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(rec.gameState) - 1, strlen(rec.gameState));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(rec.away.name) - 1, strlen(rec.away.name));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(rec.timeRemaining) - 1, strlen(rec.timeRemaining));
+}
+
+// ============================================================================
+// CONTENT & AGE
+// ============================================================================
+
+void test_same_content_ignores_save_time_only() {
+    SnapshotRecord a;
+    SnapshotRecord b;
+    snapshotPack(a, sample(), 1000);
+    snapshotPack(b, sample(), 0);
+    TEST_ASSERT_TRUE(snapshotSameContent(a, b));
+
+    GameSnapshot changed = sample();
+    changed.home.score = 4;
+    snapshotPack(b, changed, 1000);
+    TEST_ASSERT_FALSE(snapshotSameContent(a, b));
+
+    // Fields that are not persisted do not count as a change
+    changed = sample();
+    changed.clockTenths = 100;
+    changed.penaltyCount = 0;
+    snapshotPack(b, changed, 1000);
+    TEST_ASSERT_TRUE(snapshotSameContent(a, b));
+}
+
+void test_staleness_needs_both_times() {
+    SnapshotRecord rec;
+    snapshotPack(rec, sample(), 1737250000);
+    TEST_ASSERT_FALSE(snapshotIsStale(rec, 0));
+    TEST_ASSERT_FALSE(snapshotIsStale(rec, 1737250000 + 11 * 3600));
+    TEST_ASSERT_FALSE(snapshotIsStale(rec, 1737250000 + kSnapshotMaxAgeS));
+    TEST_ASSERT_TRUE(snapshotIsStale(rec, 1737250000 + kSnapshotMaxAgeS + 1));
+
+    snapshotPack(rec, sample(), 0);
+    TEST_ASSERT_FALSE(snapshotIsStale(rec, 1737250000 + 7 * 86400));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_layout_is_pinned);
+    RUN_TEST(test_crc32_reference_vector);
+    RUN_TEST(test_round_trip_keeps_persisted_fields);
+    RUN_TEST(test_damaged_or_foreign_records_are_rejected);
+    RUN_TEST(test_unterminated_strings_are_terminated);
+    RUN_TEST(test_same_content_ignores_save_time_only);
+    RUN_TEST(test_staleness_needs_both_times);
+    return UNITY_END();
+}
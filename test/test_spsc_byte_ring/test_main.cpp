@@ -0,0 +1,148 @@
+#include <unity.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+#include "spsc_byte_ring.h"
+
+// Byte n of the test stream; a period that is not a power of two keeps
+// the pattern out of phase with the ring size.
+static uint8_t patternByte(size_t n) {
+    return (uint8_t)((n * 31 + n / 251) & 0xFF);
+}
+
+// Cheap deterministic sizes so both sides see uneven chunks
+static size_t nextChunk(uint32_t& seed, size_t maxLen) {
+    seed = seed * 1664525u + 1013904223u;
+    return 1 + (seed >> 16) % maxLen;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_write_span_stops_at_wrap() {
+    uint8_t buf[16];
+    SpscByteRing ring(buf, sizeof(buf));
+    uint8_t* dst = nullptr;
+    TEST_ASSERT_EQUAL(16, ring.writeSpan(dst));
+    ring.commitWrite(12);
+    uint8_t out[16];
+    TEST_ASSERT_EQUAL(12, ring.read(out, sizeof(out)));
+
+    // Head at 12: the contiguous span ends at the buffer end
+    TEST_ASSERT_EQUAL(4, ring.writeSpan(dst));
+    TEST_ASSERT_TRUE(dst == buf + 12);
+}
+
+void test_read_across_wrap_is_ordered() {
+    uint8_t buf[8];
+    SpscByteRing ring(buf, sizeof(buf));
+    uint8_t* dst = nullptr;
+    size_t written = 0;
+    uint8_t out[8];
+
+    ring.writeSpan(dst);
+    for (size_t i = 0; i < 6; ++i) dst[i] = patternByte(written++);
+    ring.commitWrite(6);
+    TEST_ASSERT_EQUAL(6, ring.read(out, 6));
+
+    // Two spans: [6, 8) then [0, 4)
+    size_t n = ring.writeSpan(dst);
+    TEST_ASSERT_EQUAL(2, n);
+    for (size_t i = 0; i < n; ++i) dst[i] = patternByte(written++);
+    ring.commitWrite(n);
+    n = ring.writeSpan(dst);
+    TEST_ASSERT_EQUAL(6, n);
+    for (size_t i = 0; i < 4; ++i) dst[i] = patternByte(written++);
+    ring.commitWrite(4);
+
+    TEST_ASSERT_EQUAL(6, ring.available());
+    TEST_ASSERT_EQUAL(patternByte(6), ring.peek());
+    TEST_ASSERT_EQUAL(6, ring.read(out, sizeof(out)));
+    for (size_t i = 0; i < 6; ++i) TEST_ASSERT_EQUAL(patternByte(6 + i), out[i]);
+    TEST_ASSERT_EQUAL(-1, ring.peek());
+}
+
+void test_full_ring_has_no_write_space() {
+    uint8_t buf[8];
+    SpscByteRing ring(buf, sizeof(buf));
+    uint8_t* dst = nullptr;
+    ring.commitWrite(ring.writeSpan(dst));
+    TEST_ASSERT_EQUAL(8, ring.available());
+    TEST_ASSERT_EQUAL(0, ring.writeSpan(dst));
+}
+
+// Producer and consumer on separate threads, both using uneven chunk
+// sizes, through a ring far smaller than the stream so it wraps
+// thousands of times. Every byte must come out once, in order.
+void test_threaded_stream_is_byte_exact() {
+    static uint8_t buf[64];
+    SpscByteRing ring(buf, sizeof(buf));
+    const size_t total = 1u << 20;
+    std::atomic<bool> mismatch(false);
+
+    std::thread producer([&]() {
+        uint32_t seed = 1;
+        size_t sent = 0;
+        while (sent < total) {
+            uint8_t* dst = nullptr;
+            size_t span = ring.writeSpan(dst);
+            if (span == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            size_t n = nextChunk(seed, 23);
+            if (n > span) n = span;
+            if (n > total - sent) n = total - sent;
+            for (size_t i = 0; i < n; ++i) dst[i] = patternByte(sent + i);
+            ring.commitWrite(n);
+            sent += n;
+        }
+        ring.closeWrite();
+    });
+
+    size_t received = 0;
+    uint32_t seed = 7;
+    uint8_t out[32];
+    for (;;) {
+        const size_t got = ring.read(out, nextChunk(seed, sizeof(out)));
+        if (got == 0) {
+            // Closed is only final once the last bytes are drained
+            if (ring.isWriteClosed() && ring.available() == 0) break;
+            std::this_thread::yield();
+            continue;
+        }
+        for (size_t i = 0; i < got; ++i) {
+            if (out[i] != patternByte(received + i)) mismatch.store(true);
+        }
+        received += got;
+    }
+    producer.join();
+
+    TEST_ASSERT_FALSE_MESSAGE(mismatch.load(), "byte out of order");
+    TEST_ASSERT_EQUAL(total, received);
+}
+
+void test_abort_read_is_seen_by_producer() {
+    uint8_t buf[8];
+    SpscByteRing ring(buf, sizeof(buf));
+    TEST_ASSERT_FALSE(ring.isReadAborted());
+    std::thread consumer([&]() { ring.abortRead(); });
+    consumer.join();
+    TEST_ASSERT_TRUE(ring.isReadAborted());
+    ring.reset();
+    TEST_ASSERT_FALSE(ring.isReadAborted());
+    TEST_ASSERT_EQUAL(0, ring.available());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_write_span_stops_at_wrap);
+    RUN_TEST(test_read_across_wrap_is_ordered);
+    RUN_TEST(test_full_ring_has_no_write_space);
+    RUN_TEST(test_threaded_stream_is_byte_exact);
+    RUN_TEST(test_abort_read_is_seen_by_producer);
+    return UNITY_END();
+}
@@ -0,0 +1,144 @@
+#include <unity.h>
+
+#include <string.h>
+#include <time.h>
+
+#include "time_utils.h"
+
+// Calendar math against the host's gmtime_r, plus the start-time labels
+// shown for games across UTC offsets and local-day boundaries.
+
+void setUp() {}
+
+void tearDown() {}
+
+// ============================================================================
+// CALENDAR
+// ============================================================================
+
+void test_days_from_civil_known_dates() {
+    TEST_ASSERT_EQUAL_INT64(0, daysFromCivil(1970, 1, 1));
+    TEST_ASSERT_EQUAL_INT64(-1, daysFromCivil(1969, 12, 31));
+    TEST_ASSERT_EQUAL_INT64(11017, daysFromCivil(2000, 3, 1));
+    TEST_ASSERT_EQUAL_INT64(19782, daysFromCivil(2024, 2, 29));
+    TEST_ASSERT_EQUAL_INT64(20107, daysFromCivil(2025, 1, 19));
+}
+
+void test_civil_round_trip_matches_gmtime() {
+    // 1901..2099 covers every leap-year rule the API can produce
+    for (int64_t days = -25000; days <= 47000; days += 7) {
+        int year = 0;
+        unsigned month = 0;
+        unsigned day = 0;
+        civilFromDays(days, year, month, day);
+        TEST_ASSERT_EQUAL_INT64(days, daysFromCivil(year, month, day));
+
+        const time_t t = (time_t)(days * kSecondsPerDay);
+        struct tm tm;
+        gmtime_r(&t, &tm);
+        TEST_ASSERT_EQUAL_INT(tm.tm_year + 1900, year);
+        TEST_ASSERT_EQUAL_UINT(tm.tm_mon + 1, month);
+        TEST_ASSERT_EQUAL_UINT(tm.tm_mday, day);
+    }
+}
+
+// ============================================================================
+// PARSING
+// ============================================================================
+
+void test_parse_iso_utc() {
+    int64_t epoch = 0;
+    TEST_ASSERT_TRUE(parseIsoUtc("2025-01-19T00:00:00Z", epoch));
+    TEST_ASSERT_EQUAL_INT64(1737244800, epoch);
+    TEST_ASSERT_TRUE(parseIsoUtc("2025-01-19T00:30Z", epoch));
+    TEST_ASSERT_EQUAL_INT64(1737244800 + 1800, epoch);
+
+    TEST_ASSERT_FALSE(parseIsoUtc("", epoch));
+    TEST_ASSERT_FALSE(parseIsoUtc(nullptr, epoch));
+    TEST_ASSERT_FALSE(parseIsoUtc("2025-01-19 00:00:00Z", epoch));
+    TEST_ASSERT_FALSE(parseIsoUtc("2025-13-19T00:00:00Z", epoch));
+    TEST_ASSERT_FALSE(parseIsoUtc("2025-01-19T24:00:00Z", epoch));
+    TEST_ASSERT_FALSE(parseIsoUtc("2025-01-1xT00:00:00Z", epoch));
+}
+
+void test_parse_utc_offset() {
+    TEST_ASSERT_EQUAL_INT(-300, parseUtcOffsetMinutes("-05:00"));
+    TEST_ASSERT_EQUAL_INT(-240, parseUtcOffsetMinutes("-04:00"));
+    TEST_ASSERT_EQUAL_INT(-210, parseUtcOffsetMinutes("-03:30"));
+    TEST_ASSERT_EQUAL_INT(330, parseUtcOffsetMinutes("+05:30"));
+    TEST_ASSERT_EQUAL_INT(0, parseUtcOffsetMinutes("+00:00"));
+    TEST_ASSERT_EQUAL_INT(0, parseUtcOffsetMinutes(""));
+    TEST_ASSERT_EQUAL_INT(0, parseUtcOffsetMinutes(nullptr));
+    TEST_ASSERT_EQUAL_INT(0, parseUtcOffsetMinutes("05:00"));
+    TEST_ASSERT_EQUAL_INT(0, parseUtcOffsetMinutes("-5:00"));
+}
+
+// ============================================================================
+// LOCAL START LABELS
+// ============================================================================
+
+namespace {
+    void checkStart(const char* iso, const char* offset, const char* label, const char* date,
+        const char* dayEndIso) {
+        int64_t start = 0;
+        int64_t dayEnd = 0;
+        TEST_ASSERT_TRUE(parseIsoUtc(iso, start));
+        TEST_ASSERT_TRUE(parseIsoUtc(dayEndIso, dayEnd));
+        LocalStartTime local;
+        localStartTime(start, parseUtcOffsetMinutes(offset), local);
+        TEST_ASSERT_EQUAL_STRING(label, local.label);
+        TEST_ASSERT_EQUAL_STRING(date, local.dateLabel);
+        TEST_ASSERT_EQUAL_INT64(dayEnd, local.dayEndEpoch);
+    }
+}
+
+void test_evening_game_lands_on_previous_local_day() {
+    // 7 PM Eastern is already tomorrow in UTC
+    checkStart("2025-01-19T00:00:00Z", "-05:00", "19H", "18-01", "2025-01-19T05:00:00Z");
+    checkStart("2025-01-19T00:30:00Z", "-05:00", "19H30", "18-01", "2025-01-19T05:00:00Z");
+    // Same instant during DST
+    checkStart("2025-03-20T23:00:00Z", "-04:00", "19H", "20-03", "2025-03-21T04:00:00Z");
+}
+
+void test_half_hour_and_positive_offsets() {
+    checkStart("2025-01-19T00:00:00Z", "-03:30", "20H30", "18-01", "2025-01-19T03:30:00Z");
+    // East of UTC the local day runs ahead
+    checkStart("2025-01-18T16:00:00Z", "+09:00", "01H", "19-01", "2025-01-19T15:00:00Z");
+    checkStart("2025-01-18T12:00:00Z", "+00:00", "12H", "18-01", "2025-01-19T00:00:00Z");
+}
+
+void test_month_year_and_leap_rollover() {
+    checkStart("2025-01-01T03:00:00Z", "-05:00", "22H", "31-12", "2025-01-01T05:00:00Z");
+    checkStart("2024-03-01T02:00:00Z", "-06:00", "20H", "29-02", "2024-03-01T06:00:00Z");
+    checkStart("2023-03-01T02:00:00Z", "-06:00", "20H", "28-02", "2023-03-01T06:00:00Z");
+    // Local midnight exactly: the label belongs to the new day
+    checkStart("2025-01-19T05:00:00Z", "-05:00", "00H", "19-01", "2025-01-20T05:00:00Z");
+}
+
+void test_day_end_is_next_local_midnight() {
+    // Every start of a local day ends exactly 24 h after that day began
+    for (int minutes = -12 * 60; minutes <= 14 * 60; minutes += 30) {
+        for (int64_t start = 1735689600; start < 1735689600 + 2 * kSecondsPerDay; start += 1800) {
+            LocalStartTime local;
+            localStartTime(start, minutes, local);
+            const int64_t localSec = start + (int64_t)minutes * 60;
+            const int64_t untilEnd = local.dayEndEpoch - start;
+            TEST_ASSERT_TRUE(untilEnd > 0 && untilEnd <= kSecondsPerDay);
+            TEST_ASSERT_EQUAL_INT64(0, (local.dayEndEpoch + (int64_t)minutes * 60) % kSecondsPerDay);
+            TEST_ASSERT_EQUAL_INT64(kSecondsPerDay - localSec % kSecondsPerDay, untilEnd);
+        }
+    }
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_days_from_civil_known_dates);
+    RUN_TEST(test_civil_round_trip_matches_gmtime);
+    RUN_TEST(test_parse_iso_utc);
+    RUN_TEST(test_parse_utc_offset);
+    RUN_TEST(test_evening_game_lands_on_previous_local_day);
+    RUN_TEST(test_half_hour_and_positive_offsets);
+    RUN_TEST(test_month_year_and_leap_rollover);
+    RUN_TEST(test_day_end_is_next_local_midnight);
+    return UNITY_END();
+}
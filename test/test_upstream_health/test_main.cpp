@@ -0,0 +1,379 @@
+#include <unity.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "upstream_policy.h"
+
+// The upstream policy on its own, then driven by a stand-in upstream that
+// injects latency: TTFB drawn from a normal/slow/stalled mix, plus outage
+// windows that fail every request. The fetch loop below runs the pollers'
+// UpstreamRetryLoop and recordAttemptFailure(): at most 3 attempts with
+// jittered backoff, and one re-issue (no attempt slot) when an attempt
+// misses the deadline.
+
+namespace {
+    uint32_t rngState = 1;
+    uint32_t nextRand() {
+        rngState = rngState * 1664525u + 1013904223u;
+        return rngState >> 8;
+    }
+
+    // ========================================================================
+    // STAND-IN UPSTREAM
+    // ========================================================================
+
+    struct Outage {
+        uint32_t fromMs;
+        uint32_t untilMs;
+    };
+
+    struct Upstream {
+        uint32_t stallPermille;     // requests that stall for seconds
+        const Outage* outages;
+        size_t outageCount;
+        uint32_t requests = 0;
+
+        bool down(uint32_t nowMs) const {
+            for (size_t i = 0; i < outageCount; ++i) {
+                if (nowMs >= outages[i].fromMs && nowMs < outages[i].untilMs) return true;
+            }
+            return false;
+        }
+
+        // TTFB of one request; 0 means the connection failed
+        uint32_t ttfb(uint32_t nowMs) {
+            requests++;
+            if (down(nowMs)) return 0;
+            const uint32_t roll = nextRand() % 1000;
+            if (roll < stallPermille) return 8000 + nextRand() % 12000;
+            if (roll < stallPermille + 90) return 350 + nextRand() % 550;
+            return 150 + nextRand() % 200;
+        }
+    };
+
+    constexpr int MAX_RETRIES = 3;
+    constexpr uint32_t RETRY_BASE_MS = 1000;
+    constexpr uint32_t CONNECT_FAIL_MS = 300;
+
+    struct FetchResult {
+        bool ok;
+        bool skipped;   // circuit open, nothing sent
+        uint32_t tookMs;
+    };
+
+    // One poll, the way fetchAndParseJson() runs it. withPolicy=false is
+    // the old behaviour: a fixed 30 s timeout, plain retries, no breaker.
+    FetchResult fetch(UpstreamPolicy& policy, Upstream& upstream, uint32_t& nowMs, bool withPolicy) {
+        const uint32_t start = nowMs;
+        UpstreamRetryLoop loop(MAX_RETRIES);
+        while (loop.next()) {
+            if (withPolicy && !loop.reissuing() && !policy.allowRequest(nowMs)) {
+                return {false, loop.attempt() == 0, nowMs - start};
+            }
+            const uint32_t deadline = withPolicy ? policy.requestTimeoutMs() : UpstreamPolicy::kDefaultTimeoutMs;
+            const uint32_t ttfb = upstream.ttfb(nowMs);
+            bool deadlineMissed = false;
+            if (ttfb == 0) {
+                nowMs += CONNECT_FAIL_MS;
+            } else if (ttfb > deadline) {
+                nowMs += deadline;
+                deadlineMissed = withPolicy;
+            } else {
+                nowMs += ttfb;
+                policy.recordSuccess(ttfb, nowMs);
+                return {true, false, nowMs - start};
+            }
+            const RetryStep step = policy.recordAttemptFailure(loop, deadlineMissed, nowMs, nextRand());
+            if (step == RetryStep::Backoff) nowMs += backoffDelayMs(RETRY_BASE_MS, loop.attempt(), nextRand());
+        }
+        return {false, false, nowMs - start};
+    }
+
+    struct RunResult {
+        uint32_t polls;
+        uint32_t failed;
+        uint32_t skipped;
+        uint32_t p50Ms;
+        uint32_t p99Ms;
+        uint32_t maxMs;
+        uint32_t requests;
+        uint32_t requestsInOutage;
+    };
+
+    int compareU32(const void* a, const void* b) {
+        const uint32_t x = *(const uint32_t*)a;
+        const uint32_t y = *(const uint32_t*)b;
+        return x < y ? -1 : x > y ? 1 : 0;
+    }
+
+    // Polls every pollMs for durationMs (a poll that overruns delays the
+    // next one, like the poller task)
+    RunResult run(Upstream upstream, uint32_t pollMs, uint32_t durationMs, bool withPolicy, uint32_t seed) {
+        static uint32_t took[20000];
+        rngState = seed;
+        UpstreamPolicy policy;
+        RunResult r = {};
+        uint32_t now = 1000;
+        uint32_t nextPoll = now;
+        while (now < durationMs && r.polls < 20000) {
+            if (now < nextPoll) now = nextPoll;
+            nextPoll = now + pollMs;
+            const uint32_t before = upstream.requests;
+            const bool inOutage = upstream.down(now);
+            const FetchResult f = fetch(policy, upstream, now, withPolicy);
+            if (inOutage) r.requestsInOutage += upstream.requests - before;
+            if (f.skipped) {
+                r.skipped++;
+                continue;
+            }
+            if (!f.ok) {
+                r.failed++;
+                continue;
+            }
+            took[r.polls++] = f.tookMs;
+        }
+        r.requests = upstream.requests;
+        if (r.polls > 0) {
+            qsort(took, r.polls, sizeof(took[0]), compareU32);
+            r.p50Ms = took[r.polls / 2];
+            r.p99Ms = took[(r.polls * 99) / 100];
+            r.maxMs = took[r.polls - 1];
+        }
+        return r;
+    }
+
+    void report(const char* name, const RunResult& r) {
+        char msg[200];
+        snprintf(msg, sizeof(msg), "%s: %u ok, %u failed, %u skipped, p50 %u ms, p99 %u ms, max %u ms, %u requests",
+            name, (unsigned)r.polls, (unsigned)r.failed, (unsigned)r.skipped, (unsigned)r.p50Ms,
+            (unsigned)r.p99Ms, (unsigned)r.maxMs, (unsigned)r.requests);
+        TEST_MESSAGE(msg);
+    }
+
+    void warmUp(UpstreamPolicy& policy, uint32_t ttfbMs, size_t count, uint32_t& now) {
+        for (size_t i = 0; i < count; ++i) {
+            now += 10000;
+            policy.recordSuccess(ttfbMs, now);
+        }
+    }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// ============================================================================
+// POLICY
+// ============================================================================
+
+void test_deadline_follows_p95_after_warm_up() {
+    UpstreamPolicy policy;
+    uint32_t now = 0;
+    TEST_ASSERT_EQUAL_UINT32(30000, policy.requestTimeoutMs());
+    warmUp(policy, 300, UpstreamPolicy::kTtfbMinSamples - 1, now);
+    TEST_ASSERT_EQUAL_UINT32(30000, policy.requestTimeoutMs());
+    warmUp(policy, 300, 1, now);
+    // 2 x 300 ms is under the floor
+    TEST_ASSERT_EQUAL_UINT32(2500, policy.requestTimeoutMs());
+
+    warmUp(policy, 1800, UpstreamPolicy::kTtfbSamples, now);
+    TEST_ASSERT_EQUAL_UINT32(3600, policy.requestTimeoutMs());
+    warmUp(policy, 40000, UpstreamPolicy::kTtfbSamples, now);
+    TEST_ASSERT_EQUAL_UINT32(30000, policy.requestTimeoutMs());
+}
+
+void test_one_stall_in_the_window_does_not_move_p95() {
+    UpstreamPolicy policy;
+    uint32_t now = 0;
+    for (int i = 0; i < 32; ++i) {
+        now += 10000;
+        policy.recordSuccess(i == 7 ? 9000 : 400 + i, now);
+    }
+    UpstreamHealthStats stats;
+    policy.getStats(stats, now);
+    TEST_ASSERT_TRUE(stats.p95TtfbMs < 1000);
+}
+
+void test_circuit_opens_after_five_failures_and_probes_once() {
+    UpstreamPolicy policy;
+    uint32_t now = 1000;
+    for (int i = 0; i < 4; ++i) {
+        TEST_ASSERT_TRUE(policy.allowRequest(now));
+        TEST_ASSERT_FALSE(policy.recordFailure(false, now, 0));
+    }
+    TEST_ASSERT_TRUE(policy.recordFailure(false, now, 0));
+    TEST_ASSERT_TRUE(policy.circuit() == CircuitState::Open);
+    // Equal jitter with random 0: half the 10 s base window
+    TEST_ASSERT_EQUAL_UINT32(5000, policy.openForMs());
+    TEST_ASSERT_FALSE(policy.allowRequest(now + 4999));
+
+    // Half-open: one probe only
+    TEST_ASSERT_TRUE(policy.allowRequest(now + 5000));
+    TEST_ASSERT_TRUE(policy.circuit() == CircuitState::HalfOpen);
+    TEST_ASSERT_FALSE(policy.allowRequest(now + 5001));
+
+    // A failed probe reopens with a longer window
+    TEST_ASSERT_TRUE(policy.recordFailure(false, now + 6000, 0));
+    TEST_ASSERT_EQUAL_UINT32(10000, policy.openForMs());
+
+    // A good probe closes it and resets the streak
+    TEST_ASSERT_TRUE(policy.allowRequest(now + 16000));
+    policy.recordSuccess(300, now + 16300);
+    TEST_ASSERT_TRUE(policy.circuit() == CircuitState::Closed);
+    TEST_ASSERT_TRUE(policy.allowRequest(now + 16400));
+    TEST_ASSERT_TRUE(policy.allowRequest(now + 16500));
+}
+
+void test_open_window_grows_and_caps() {
+    UpstreamPolicy policy;
+    uint32_t now = 0;
+    for (int i = 0; i < 5; ++i) policy.recordFailure(false, now, 0);
+    uint32_t last = policy.openForMs();
+    for (int round = 0; round < 8; ++round) {
+        now += policy.openForMs();
+        TEST_ASSERT_TRUE(policy.allowRequest(now));
+        // Full jitter range: random just under the top of the window
+        policy.recordFailure(false, now, 0xFFFFFFFFu);
+        const uint32_t window = policy.openForMs();
+        TEST_ASSERT_TRUE(window >= last);
+        TEST_ASSERT_TRUE(window <= UpstreamPolicy::kOpenMaxMs);
+        last = window;
+    }
+    TEST_ASSERT_TRUE(last >= UpstreamPolicy::kOpenMaxMs / 2);
+}
+
+void test_reissued_failure_counts_twice_reissue_alone_does_not() {
+    UpstreamPolicy policy;
+    policy.recordReissue();
+    policy.recordReissue();
+    UpstreamHealthStats stats;
+    policy.getStats(stats, 0);
+    TEST_ASSERT_EQUAL_UINT16(0, stats.consecutiveFailures);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.reissues);
+
+    policy.recordFailure(true, 0, 0);
+    policy.recordFailure(true, 0, 0);
+    TEST_ASSERT_TRUE(policy.circuit() == CircuitState::Closed);
+    TEST_ASSERT_TRUE(policy.recordFailure(true, 0, 0));
+    policy.getStats(stats, 0);
+    TEST_ASSERT_EQUAL_UINT32(6, stats.totalFailures);
+}
+
+void test_retry_loop_reissues_once_then_charges_the_breaker() {
+    UpstreamPolicy policy;
+    UpstreamHealthStats stats;
+    UpstreamRetryLoop loop(3);
+
+    // Deadline miss: re-issued at once on the same attempt, nothing charged
+    TEST_ASSERT_TRUE(loop.next());
+    TEST_ASSERT_EQUAL_INT(0, loop.attempt());
+    TEST_ASSERT_FALSE(loop.reissuing());
+    TEST_ASSERT_TRUE(policy.recordAttemptFailure(loop, true, 0, 0) == RetryStep::Reissue);
+    policy.getStats(stats, 0);
+    TEST_ASSERT_EQUAL_UINT16(0, stats.consecutiveFailures);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.reissues);
+
+    // The re-issue misses too: both misses are charged, then back off
+    TEST_ASSERT_TRUE(loop.next());
+    TEST_ASSERT_EQUAL_INT(0, loop.attempt());
+    TEST_ASSERT_TRUE(loop.reissuing());
+    TEST_ASSERT_TRUE(policy.recordAttemptFailure(loop, true, 0, 0) == RetryStep::Backoff);
+    policy.getStats(stats, 0);
+    TEST_ASSERT_EQUAL_UINT16(2, stats.consecutiveFailures);
+
+    // Only one re-issue per fetch; the last attempt gives up
+    TEST_ASSERT_TRUE(loop.next());
+    TEST_ASSERT_EQUAL_INT(1, loop.attempt());
+    TEST_ASSERT_FALSE(loop.reissuing());
+    TEST_ASSERT_TRUE(policy.recordAttemptFailure(loop, true, 0, 0) == RetryStep::Backoff);
+    TEST_ASSERT_TRUE(loop.next());
+    TEST_ASSERT_TRUE(policy.recordAttemptFailure(loop, false, 0, 0) == RetryStep::GiveUp);
+    TEST_ASSERT_FALSE(loop.next());
+    policy.getStats(stats, 0);
+    TEST_ASSERT_EQUAL_UINT16(4, stats.consecutiveFailures);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.totalRequests);
+    TEST_ASSERT_TRUE(policy.circuit() == CircuitState::Closed);
+
+    // Next fetch: a failed re-issue takes the streak past five and opens
+    // the circuit, so the fetch after that is not let through
+    UpstreamRetryLoop next(3);
+    TEST_ASSERT_TRUE(next.next());
+    TEST_ASSERT_TRUE(policy.allowRequest(0));
+    TEST_ASSERT_TRUE(policy.recordAttemptFailure(next, true, 0, 0) == RetryStep::Reissue);
+    TEST_ASSERT_TRUE(policy.circuit() == CircuitState::Closed);
+    TEST_ASSERT_TRUE(next.next());
+    TEST_ASSERT_TRUE(policy.recordAttemptFailure(next, false, 0, 0) == RetryStep::Backoff);
+    TEST_ASSERT_TRUE(policy.circuit() == CircuitState::Open);
+    TEST_ASSERT_FALSE(policy.allowRequest(1));
+}
+
+void test_backoff_jitter_range() {
+    for (int attempt = 0; attempt < 9; ++attempt) {
+        const uint32_t window = 1000u << (attempt > 6 ? 6 : attempt);
+        TEST_ASSERT_EQUAL_UINT32(window / 2, backoffDelayMs(1000, attempt, 0));
+        TEST_ASSERT_EQUAL_UINT32(window, backoffDelayMs(1000, attempt, window / 2));
+        for (int i = 0; i < 200; ++i) {
+            const uint32_t d = backoffDelayMs(1000, attempt, nextRand());
+            TEST_ASSERT_TRUE(d >= window / 2 && d <= window);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(500, backoffDelayMs(1000, -3, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, backoffJitterMs(1, 12345));
+}
+
+// ============================================================================
+// STAND-IN UPSTREAM
+// ============================================================================
+
+void test_reissue_cuts_stall_tail() {
+    // 2% of requests stall 8-20 s, 10 s polls for six hours
+    const Upstream stalls = {20, nullptr, 0};
+    for (uint32_t seed = 1; seed <= 3; ++seed) {
+        const RunResult base = run(stalls, 10000, 6 * 3600 * 1000, false, seed);
+        const RunResult reissued = run(stalls, 10000, 6 * 3600 * 1000, true, seed);
+        if (seed == 1) {
+            report("fixed 30 s timeout", base);
+            report("re-issued at 2 x p95", reissued);
+        }
+        // Without re-issues the p99 poll waits out a stall
+        TEST_ASSERT_TRUE(base.p99Ms >= 8000);
+        // With it, a stall costs at most the 2.5 s floor plus a normal reply
+        TEST_ASSERT_TRUE(reissued.p99Ms <= 2500 + 1000);
+        TEST_ASSERT_TRUE(reissued.maxMs < base.maxMs);
+        TEST_ASSERT_EQUAL_UINT32(0, reissued.failed);
+        // Re-issues add only a few percent of requests
+        TEST_ASSERT_TRUE(reissued.requests * 100 <= base.requests * 105);
+    }
+}
+
+void test_breaker_stops_hammering_an_outage() {
+    // Ten minutes down in the middle of an hour
+    const Outage outage[] = {{20 * 60 * 1000, 30 * 60 * 1000}};
+    const Upstream down = {0, outage, 1};
+    const RunResult noBreaker = run(down, 10000, 3600 * 1000, false, 5);
+    const RunResult breaker = run(down, 10000, 3600 * 1000, true, 5);
+    report("outage, no breaker", noBreaker);
+    report("outage, breaker", breaker);
+    // 60 polls x 3 attempts without it
+    TEST_ASSERT_TRUE(noBreaker.requestsInOutage >= 150);
+    TEST_ASSERT_TRUE(breaker.requestsInOutage * 4 <= noBreaker.requestsInOutage);
+    TEST_ASSERT_TRUE(breaker.skipped > 0);
+    // Recovery: polls succeed again once the upstream is back, after at
+    // most one capped open window
+    TEST_ASSERT_TRUE(breaker.polls >= noBreaker.polls - 20);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_deadline_follows_p95_after_warm_up);
+    RUN_TEST(test_one_stall_in_the_window_does_not_move_p95);
+    RUN_TEST(test_circuit_opens_after_five_failures_and_probes_once);
+    RUN_TEST(test_open_window_grows_and_caps);
+    RUN_TEST(test_reissued_failure_counts_twice_reissue_alone_does_not);
+    RUN_TEST(test_retry_loop_reissues_once_then_charges_the_breaker);
+    RUN_TEST(test_backoff_jitter_range);
+    RUN_TEST(test_reissue_cuts_stall_tail);
+    RUN_TEST(test_breaker_stops_hammering_an_outage);
+    return UNITY_END();
+}
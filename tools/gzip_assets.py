@@ -0,0 +1,48 @@
+"""PlatformIO pre-script: build the LittleFS image from a gzipped copy of data/.
+
+Text assets (html, js, css, json, svg) are stored as <name>.gz only; the
+firmware serves them with Content-Encoding: gzip. Everything else (logos)
+is copied unchanged. data/ itself is left untouched so it stays editable.
+"""
+
+import gzip
+import os
+import shutil
+
+Import("env")  # noqa: F821  (provided by PlatformIO)
+
+GZIP_EXTENSIONS = {".html", ".js", ".css", ".json", ".svg"}
+FS_TARGETS = {"buildfs", "uploadfs", "uploadfsota"}
+
+
+def stage(src_dir, out_dir):
+    if os.path.isdir(out_dir):
+        shutil.rmtree(out_dir)
+    raw_total = 0
+    stored_total = 0
+    for root, _, names in os.walk(src_dir):
+        rel = os.path.relpath(root, src_dir)
+        dest_root = os.path.normpath(os.path.join(out_dir, rel))
+        os.makedirs(dest_root, exist_ok=True)
+        for name in sorted(names):
+            src = os.path.join(root, name)
+            if os.path.splitext(name)[1].lower() not in GZIP_EXTENSIONS:
+                shutil.copy2(src, os.path.join(dest_root, name))
+                continue
+            with open(src, "rb") as f:
+                raw = f.read()
+            # mtime=0 keeps the bytes, and so the ETag, stable across builds
+            packed = gzip.compress(raw, compresslevel=9, mtime=0)
+            with open(os.path.join(dest_root, name + ".gz"), "wb") as f:
+                f.write(packed)
+            raw_total += len(raw)
+            stored_total += len(packed)
+            print("gzip_assets: %s %d -> %d bytes" % (os.path.normpath(os.path.join(rel, name)), len(raw), len(packed)))
+    print("gzip_assets: text assets %d -> %d bytes" % (raw_total, stored_total))
+
+
+if FS_TARGETS & set(COMMAND_LINE_TARGETS):  # noqa: F821
+    src_dir = env.subst("$PROJECT_DATA_DIR")
+    out_dir = os.path.join(env.subst("$BUILD_DIR"), "littlefs_data")
+    stage(src_dir, out_dir)
+    env.Replace(PROJECT_DATA_DIR=out_dir)